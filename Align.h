@@ -8,6 +8,36 @@
 
 #pragma once
 
+// stars kept for the :GX0n# readback and the final fit with the full model, any more only go into the normal equations
+#ifdef HAL_FAST_PROCESSOR
+  #define ALIGN_MAX_STORED 64
+#else
+  #define ALIGN_MAX_STORED 9
+#endif
+
+// most stars for an align, :Ann# for more than 9 (on HAL_FAST_PROCESSOR platforms)
+#if defined(HAL_FAST_PROCESSOR) && !defined(ALIGN_GRID_SEARCH_ON)
+  #define ALIGN_MAX_STARS 99
+#else
+  #define ALIGN_MAX_STARS ALIGN_MAX_STORED
+#endif
+
+// the normal equations are only kept when an align can have more stars than are stored, otherwise the full model is fit
+#if ALIGN_MAX_STARS > ALIGN_MAX_STORED
+  #define ALIGN_NORMAL_EQUATIONS
+#endif
+
+// the pointing model's correction from tables of sin(HA) and tan, sec and cos(Dec) (ALIGN_CORRECTION_GRID_ON, equatorial mounts only)
+// the model is a sum of its terms times those, so the tables don't change with the model and the linear interpolation error has a
+// bound.  Closer to the poles than where the bound for the current model passes ALIGN_GRID_MAX_ERROR it's evaluated in full.  About 10KB of RAM
+#ifdef ALIGN_CORRECTION_GRID_ON
+  #define ALIGN_GRID_STEP      0.25  // in degrees, of HA and Dec between table entries
+  #define ALIGN_GRID_DEC_LIMIT 85.0  // in degrees, the tables go no closer to the poles than this
+  #define ALIGN_GRID_MAX_ERROR 0.2   // in arc-seconds
+  #define ALIGN_GRID_HA_STEPS  ((int)(360.0/ALIGN_GRID_STEP))
+  #define ALIGN_GRID_DEC_STEPS ((int)(ALIGN_GRID_DEC_LIMIT/ALIGN_GRID_STEP))
+#endif
+
 // -----------------------------------------------------------------------------------
 // ADVANCED GEOMETRIC ALIGN FOR ALT/AZM MOUNTS (GOTO ASSIST)
 
@@ -32,9 +62,9 @@ class TGeoAlignH
     double pdCor;
     double dfCor;
     double tfCor;
-    align_coord2_t mount[9];
-    align_coord2_t actual[9];
-    align_coord2_t delta[9];
+    align_coord2_t mount[ALIGN_MAX_STORED];
+    align_coord2_t actual[ALIGN_MAX_STORED];
+    align_coord2_t delta[ALIGN_MAX_STORED];
 
     void init();
     void readCoe();
@@ -45,6 +75,13 @@ class TGeoAlignH
     void instrToHor(double Alt, double Azm, double *Alt1, double *Azm1, int PierSide);
     void autoModel(int n);
     void model(int n);
+#ifdef ALIGN_NORMAL_EQUATIONS
+    void clearNormal();
+    void addNormal(align_coord2_t *m, align_coord2_t *a);
+#else
+    void clearNormal() { }
+    void addNormal(align_coord2_t *m, align_coord2_t *a) { }
+#endif
 
   private:
     boolean geo_ready;
@@ -64,8 +101,24 @@ class TGeoAlignH
     double sa,sz,sum1;
     double max_dist;
 
+#ifdef ALIGN_NORMAL_EQUATIONS
+    // normal equations J'J (9x9,) J'b and b'b for the terms linearized about the fit so far (nX)
+    double nAtA[81];
+    double nAtr[9];
+    double nRtr;
+    double nX[9];
+    long nNum;
+#endif
+
     void correct(double azm, double alt, double pierSide, double sf, double _deo, double _pd, double _pz, double _pe, double _da, double _ff, double _tf, double *z1, double *a1);
     void do_search(double sf, int p1, int p2, int p3, int p4, int p5, int p6, int p7, int p8, int p9);
+    void do_solve(int p1, int p2, int p3, int p4, int p5, int p6, int p7, int p8, int p9);
+    void solve_residual(align_coord2_t *m, align_coord2_t *a, double *x, double *r1, double *r2, double *j);
+#ifdef ALIGN_NORMAL_EQUATIONS
+    bool solve_normal(int *p, double *x, double *e);
+    void do_solve_normal(int p1, int p2, int p3, int p4, int p5, int p6, int p7, int p8, int p9);
+#endif
+    double solve_sum(double *x);
 };
 
 TGeoAlignH Align;
@@ -93,9 +146,9 @@ class TGeoAlign
     double pdCor;
     double dfCor;
     double tfCor;
-    align_coord2_t mount[9];
-    align_coord2_t actual[9];
-    align_coord2_t delta[9];
+    align_coord2_t mount[ALIGN_MAX_STORED];
+    align_coord2_t actual[ALIGN_MAX_STORED];
+    align_coord2_t delta[ALIGN_MAX_STORED];
 
     void init();
     void readCoe();
@@ -106,6 +159,13 @@ class TGeoAlign
     void instrToEqu(double HA, double Dec, double *HA1, double *Dec1, int PierSide);
     void autoModel(int n);
     void model(int n);
+#ifdef ALIGN_NORMAL_EQUATIONS
+    void clearNormal();
+    void addNormal(align_coord2_t *m, align_coord2_t *a);
+#else
+    void clearNormal() { }
+    void addNormal(align_coord2_t *m, align_coord2_t *a) { }
+#endif
 
   private:
     boolean geo_ready;
@@ -125,8 +185,43 @@ class TGeoAlign
     double sd,sh,sum1;
     double max_dist;
 
+#ifdef ALIGN_NORMAL_EQUATIONS
+    // normal equations J'J (9x9,) J'b and b'b for the terms linearized about the fit so far (nX)
+    double nAtA[81];
+    double nAtr[9];
+    double nRtr;
+    double nX[9];
+    long nNum;
+#endif
+
     void correct(double ha, double dec, double pierSide, double sf, double _deo, double _pd, double _pz, double _pe, double _da, double _ff, double _tf, double *h1, double *d1);
     void do_search(double sf, int p1, int p2, int p3, int p4, int p5, int p6, int p7, int p8, int p9);
+    void do_solve(int p1, int p2, int p3, int p4, int p5, int p6, int p7, int p8, int p9);
+    void solve_residual(align_coord2_t *m, align_coord2_t *a, double *x, double *r1, double *r2, double *j);
+#ifdef ALIGN_NORMAL_EQUATIONS
+    bool solve_normal(int *p, double *x, double *e);
+    void do_solve_normal(int p1, int p2, int p3, int p4, int p5, int p6, int p7, int p8, int p9);
+#endif
+    double solve_sum(double *x);
+    void correction(double HA, double Dec, double p, double *dHA, double *dDec);
+    void model_correction(double HA, double Dec, double *dHA, double *dDec, double *dHAp);
+    void model_terms(double sinHA, double cosHA, double tanDec, double secDec, double cosDec, double *dHA, double *dDec, double *dHAp);
+
+#ifdef ALIGN_CORRECTION_GRID_ON
+    // sin(HA) from -180 to +180 degrees, cos(HA) is 90 degrees on, and tan, sec and cos(Dec) from 0 to ALIGN_GRID_DEC_LIMIT
+    float grid_sin[ALIGN_GRID_HA_STEPS+1];
+    float grid_tan[ALIGN_GRID_DEC_STEPS+1];
+    float grid_sec[ALIGN_GRID_DEC_STEPS+1];
+    float grid_cos[ALIGN_GRID_DEC_STEPS+1];
+    bool grid_tables;
+    double grid_coe[8];
+    double grid_dec_limit;     // in degrees, for the model in grid_coe
+    bool grid_ready;
+
+    bool grid_current();
+    void grid_update();
+    bool grid_correction(double HA, double Dec, double p, double *dHA, double *dDec);
+#endif
 };
 
 TGeoAlign Align;
@@ -26,6 +26,9 @@ void TGeoAlign::init() {
   tfCor =0;  // tube flex
 
   geo_ready=false;
+#ifdef ALIGN_CORRECTION_GRID_ON
+  grid_ready=false;
+#endif
 }
 
 // remember the alignment between sessions
@@ -57,19 +60,25 @@ bool TGeoAlign::isReady() {
 }
 
 // I=1 for 1st star, I=2 for 2nd star, I=3 for 3rd star
-// N=total number of stars for this align (1 to 9)
+// N=total number of stars for this align (1 to ALIGN_MAX_STARS)
 // RA, Dec (all in degrees)
 bool TGeoAlign::addStar(int I, int N, double RA, double Dec) {
+  align_coord2_t mnt, act;
 
   // First star, just sync
   if (I == 1) { if (syncEqu(RA,Dec) != GOTO_ERR_NONE) return false; }
 
-  mount[I-1].ha=getInstrAxis1()/Rad;
-  mount[I-1].dec=getInstrAxis2()/Rad;
-  actual[I-1].ha=haRange(LST()*15.0-RA)/Rad;
-  actual[I-1].dec=Dec/Rad;
-  if (getInstrPierSide() == PierSideWest) { actual[I-1].side=-1; mount[I-1].side=-1; } else
-  if (getInstrPierSide() == PierSideEast) { actual[I-1].side=1; mount[I-1].side=1; } else { actual[I-1].side=0; mount[I-1].side=0; }
+  mnt.ha=getInstrAxis1()/Rad;
+  mnt.dec=getInstrAxis2()/Rad;
+  act.ha=haRange(LST()*15.0-RA)/Rad;
+  act.dec=Dec/Rad;
+  if (getInstrPierSide() == PierSideWest) { act.side=-1; mnt.side=-1; } else
+  if (getInstrPierSide() == PierSideEast) { act.side=1; mnt.side=1; } else { act.side=0; mnt.side=0; }
+
+  // add it to the normal equations, and keep it if there's room
+  if (I == 1) clearNormal();
+  addNormal(&mnt,&act);
+  if (I <= ALIGN_MAX_STORED) { mount[I-1]=mnt; actual[I-1]=act; }
 
   // two or more stars and finished
   if ((I >= 2) && (I == N)) model(N);
@@ -84,6 +93,9 @@ void TGeoAlign::model(int n) {
   if (busy) return;                                                             // busy
   if (n > 0) { numStars=n; return; }                                            // command
   if (numStars > 0) { busy=true; autoModel(numStars); busy=false; numStars=0; } // waiting to solve
+#ifdef ALIGN_CORRECTION_GRID_ON
+  else grid_update();                                                           // keep the correction tables' limit up to date
+#endif
 }
 
 // returns the correction to be added to the requested RA,Dec to yield the actual RA,Dec that we will arrive at
@@ -246,6 +258,182 @@ void TGeoAlign::do_search(double sf, int p1, int p2, int p3, int p4, int p5, int
   }
 }
 
+// residuals for a sample (m mount, a actual) with the terms x[] (Do,Pd,Pz,Pe,Tf,Ff,Df,Od,Oh in radians) as in do_search, and if j isn't NULL
+// their partial derivatives from correct() differentiated by hand, j[0..8] for the HA residual and j[9..17] for Dec
+void TGeoAlign::solve_residual(align_coord2_t *m, align_coord2_t *a, double *x, double *rh, double *rd, double *j) {
+  double s=m->side;
+  double H=m->ha+(s != 0 ? x[8] : 0.0);  // ohw=ohe
+  double D=m->dec+x[7]*s;                  // odw=-ode
+  double sinH=sin(H), cosH=cos(H), sinD=sin(D), cosD=cos(D);
+  double tanD=sinD/cosD, secD=1.0/cosD;
+  double deo=x[0], pd=x[1], pz=x[2], pe=x[3], tf=x[4], ff=x[5], df=x[6];
+
+  double h1=-pz*cosH*tanD + pe*sinH*tanD + deo*secD*s - pd*tanD*s + tf*cosLat*sinH*secD;
+  double d1=+pz*sinH      + pe*cosH      - df*(cosLat*cosH+sinLat*tanD) + ff*cosH + tf*(cosLat*cosH-sinLat*cosD);
+
+  double c=cos(a->dec);
+  double e=a->ha-(H-h1);
+  if (e > PI) e=e-PI*2.0; else if (e < -PI) e=e+PI*2.0;
+  *rh=e*c;
+  *rd=a->dec-(D-d1);
+  if (j == NULL) return;
+
+  // partials of the corrections with respect to the mount position
+  double hH=pz*sinH*tanD + pe*cosH*tanD + tf*cosLat*cosH*secD;
+  double hD=(-pz*cosH + pe*sinH - pd*s)*secD*secD + deo*s*secD*tanD + tf*cosLat*sinH*secD*tanD;
+  double dH=pz*cosH - pe*sinH + df*cosLat*sinH - ff*sinH - tf*cosLat*sinH;
+  double dD=-df*sinLat*secD*secD + tf*sinLat*sinD;
+
+  j[0]=c*secD*s;  j[1]=-c*tanD*s;  j[2]=-c*cosH*tanD;  j[3]=c*sinH*tanD;
+  j[4]=c*cosLat*sinH*secD;  j[5]=0.0;  j[6]=0.0;
+  j[7]=c*hD*s;  j[8]=(s != 0 ? c*(hH-1.0) : 0.0);
+
+  j[9]=0.0;  j[10]=0.0;  j[11]=sinH;  j[12]=cosH;
+  j[13]=cosLat*cosH-sinLat*cosD;  j[14]=cosH;  j[15]=-(cosLat*cosH+sinLat*tanD);
+  j[16]=(dD-1.0)*s;  j[17]=(s != 0 ? dH : 0.0);
+}
+
+// sum of the squared residuals for all samples
+double TGeoAlign::solve_sum(double *x) {
+  double e=0.0, rh, rd;
+  for (int l=0; l < num; l++) { solve_residual(&mount[l],&actual[l],x,&rh,&rd,NULL); e+=sq(rh)+sq(rd); }
+  return e;
+}
+
+// Levenberg-Marquardt least squares fit of the terms flagged in p1..p9 (the same as do_search) starting from the best_ values
+// usually this converges in well under ten iterations, each just a pass over the samples and a small linear solve
+void TGeoAlign::do_solve(int p1, int p2, int p3, int p4, int p5, int p6, int p7, int p8, int p9) {
+  int p[9]={p1,p2,p3,p4,p5,p6,p7,p8,p9};
+  int k[9], n=0; for (int i=0; i < 9; i++) if (p[i] != 0) k[n++]=i;
+  if (n == 0) return;
+
+  double sf1=1.0/(3600.0*Rad);
+  double x[9]={best_deo*sf1,best_pd*sf1,best_pz*sf1,best_pe*sf1,best_tf*sf1,best_ff*sf1,best_df*sf1,best_ode*sf1,best_ohe*sf1};
+  double e=solve_sum(x);
+  double lambda=0.001;
+
+  for (int iter=0; iter < 50; iter++) {
+    // normal equations J'J.dx=-J'r for the free terms
+    double a[81], g[9], j[18], rh, rd;
+    for (int r=0; r < n; r++) { g[r]=0.0; for (int c=0; c < n; c++) a[r*n+c]=0.0; }
+    for (int l=0; l < num; l++) {
+      solve_residual(&mount[l],&actual[l],x,&rh,&rd,j);
+      for (int r=0; r < n; r++) {
+        g[r]+=j[k[r]]*rh+j[9+k[r]]*rd;
+        for (int c=0; c <= r; c++) a[r*n+c]+=j[k[r]]*j[k[c]]+j[9+k[r]]*j[9+k[c]];
+      }
+    }
+    for (int r=0; r < n; r++) for (int c=r+1; c < n; c++) a[r*n+c]=a[c*n+r];
+
+    // raise the damping until a step improves the fit
+    bool better=false; double step=0.0;
+    while (lambda < 1.0E10) {
+      double a1[81], dx[9], x1[9];
+      for (int i=0; i < n*n; i++) a1[i]=a[i];
+      for (int r=0; r < n; r++) { a1[r*n+r]+=lambda*fmax(a[r*n+r],1.0E-12); dx[r]=-g[r]; }
+      if (choleskySolve(a1,dx,n)) {
+        for (int i=0; i < 9; i++) x1[i]=x[i];
+        step=0.0; for (int r=0; r < n; r++) { x1[k[r]]+=dx[r]; step=fmax(step,fabs(dx[r])); }
+        double e1=solve_sum(x1);
+        if (e1 < e) { for (int i=0; i < 9; i++) x[i]=x1[i]; e=e1; lambda*=0.1; better=true; break; }
+      }
+      lambda*=10.0;
+    }
+
+    // done when nothing improves or the step is below 0.001 arc-seconds
+    if (!better || (step < 0.001*sf1)) break;
+  }
+
+  best_deo=x[0]/sf1;
+  best_pd =x[1]/sf1;
+  best_pz =x[2]/sf1;
+  best_pe =x[3]/sf1;
+  best_tf =x[4]/sf1;
+  best_ff =x[5]/sf1;
+  best_df =x[6]/sf1;
+  best_ode=x[7]/sf1; best_odw=-best_ode;
+  best_ohe=x[8]/sf1; best_ohw=best_ohe;
+  best_dist=sqrt(e/(num-1));
+}
+
+#ifdef ALIGN_NORMAL_EQUATIONS
+// starts a new set of normal equations
+void TGeoAlign::clearNormal() {
+  for (int i=0; i < 81; i++) nAtA[i]=0.0;
+  for (int i=0; i < 9; i++) { nAtr[i]=0.0; nX[i]=0.0; }
+  nRtr=0.0; nNum=0;
+}
+
+// adds a sample to the normal equations, any number of samples can be added and the model is then solved from just these sums.
+// each sample is linearized about the fit so far (all terms zero to start) which is good to second order in how far off that is
+void TGeoAlign::addNormal(align_coord2_t *m, align_coord2_t *a) {
+  lat=latitude/Rad;
+  cosLat=cos(lat);
+  sinLat=sin(lat);
+
+  // r(x)=r(x0)+J.(x-x0), so the normal equations are in J and b=r(x0)-J.x0
+  double j[18], rh, rd;
+  solve_residual(m,a,nX,&rh,&rd,j);
+  for (int i=0; i < 9; i++) { rh-=j[i]*nX[i]; rd-=j[9+i]*nX[i]; }
+  for (int r=0; r < 9; r++) {
+    nAtr[r]+=j[r]*rh+j[9+r]*rd;
+    for (int c=0; c < 9; c++) nAtA[r*9+c]+=j[r]*j[c]+j[9+r]*j[9+c];
+  }
+  nRtr+=sq(rh)+sq(rd);
+  nNum++;
+
+  // update the point to linearize about once there are enough samples to pin down the large terms (polar axis, cone and index)
+  if (nNum > 5) {
+    //          DoPdPzPeTfFfDfOdOh
+    int p[9]={1,0,1,1,0,0,0,1,1};
+    double e; solve_normal(p,nX,&e);
+  }
+}
+
+// least squares fit of the terms flagged in p[] from the normal equations, the others are zero.  x[] gets the terms (in radians)
+// and e the sum of the squared residuals, returns false if there aren't enough samples
+bool TGeoAlign::solve_normal(int *p, double *x, double *e) {
+  int k[9], n=0; for (int i=0; i < 9; i++) if (p[i] != 0) k[n++]=i;
+  if ((n == 0) || (nNum < 2)) return false;
+
+  // a little damping keeps terms the samples can't tell apart from running away
+  double a[81], t[9], g[9];
+  for (int r=0; r < n; r++) {
+    for (int c=0; c < n; c++) a[r*n+c]=nAtA[k[r]*9+k[c]];
+    a[r*n+r]+=1.0E-9*fmax(nAtA[k[r]*9+k[r]],1.0E-12);
+    g[r]=-nAtr[k[r]]; t[r]=g[r];
+  }
+  if (!choleskySolve(a,t,n)) return false;
+
+  // r'r after the fit is b'b + t'J'b, as J'J.t=-J'b
+  *e=nRtr; for (int r=0; r < n; r++) *e-=t[r]*g[r];
+  if (*e < 0.0) *e=0.0;
+
+  for (int i=0; i < 9; i++) x[i]=0.0;
+  for (int r=0; r < n; r++) x[k[r]]=t[r];
+  return true;
+}
+
+// least squares fit of the terms flagged in p1..p9 (the same as do_search) from the normal equations
+void TGeoAlign::do_solve_normal(int p1, int p2, int p3, int p4, int p5, int p6, int p7, int p8, int p9) {
+  int p[9]={p1,p2,p3,p4,p5,p6,p7,p8,p9};
+  double x[9], e;
+  if (!solve_normal(p,x,&e)) return;
+
+  double sf1=1.0/(3600.0*Rad);
+  best_deo=x[0]/sf1;
+  best_pd =x[1]/sf1;
+  best_pz =x[2]/sf1;
+  best_pe =x[3]/sf1;
+  best_tf =x[4]/sf1;
+  best_ff =x[5]/sf1;
+  best_df =x[6]/sf1;
+  best_ode=x[7]/sf1; best_odw=-best_ode;
+  best_ohe=x[8]/sf1; best_ohw=best_ohe;
+  best_dist=sqrt(e/(nNum-1));
+}
+#endif
+
 void TGeoAlign::autoModel(int n) {
 
   num=n; // how many stars?
@@ -265,6 +453,16 @@ void TGeoAlign::autoModel(int n) {
   best_ode    =0.0;
   best_ohe    =0.0;
 
+#if MOUNT_TYPE == FORK
+  Ff=1; Df=0;
+#else
+  Ff=0; Df=1;
+#endif
+
+  // only search for cone error if > 2 stars
+  int Do=0; if (num > 2) Do=1;
+
+#ifndef ALIGN_NORMAL_EQUATIONS
   // figure out the average HA offset as a starting point
   ohe=0;
   for (l=0; l < num; l++) {
@@ -274,16 +472,9 @@ void TGeoAlign::autoModel(int n) {
     ohe=ohe+h1;
   }
   ohe=ohe/num; best_ohe=round(ohe*Rad*3600.0); best_ohw=best_ohe;
-
-#if MOUNT_TYPE == FORK
-  Ff=1; Df=0;
-#else
-  Ff=0; Df=1;
 #endif
 
-  // only search for cone error if > 2 stars
-  int Do=0; if (num > 2) Do=1;
-
+#ifdef ALIGN_GRID_SEARCH_ON
   // search, this can handle about 9 degrees of polar misalignment, and 4 degrees of cone error
   //              DoPdPzPeTfFf Df OdOh
   do_search(16384,0 ,0,1,1,0, 0, 0,1,1);
@@ -315,6 +506,19 @@ void TGeoAlign::autoModel(int n) {
     do_search(   16,Do,0,1,1,0, 0, 0,1,1);
 #endif
   }
+#endif
+#else
+  // least squares fit, the polar axis and flexure terms too if > 4 stars
+  int Pd=0, Tf=0; if (num > 4) { Pd=1; Tf=1; } else { Ff=0; Df=0; }
+#ifdef ALIGN_NORMAL_EQUATIONS
+  // first from the normal equations accumulated as the stars were added, then with the full model if all the stars are on hand
+  //              DoPdPzPeTfFf Df OdOh
+  do_solve_normal(Do,Pd,1,1,Tf,Ff,Df,1,1);
+  if (num <= ALIGN_MAX_STORED) do_solve(Do,Pd,1,1,Tf,Ff,Df,1,1);
+#else
+  //       DoPdPzPeTfFf Df OdOh
+  do_solve(Do,Pd,1,1,Tf,Ff,Df,1,1);
+#endif
 #endif
 
   // geometric corrections
@@ -347,48 +551,18 @@ void TGeoAlign::equToInstr(double HA, double Dec, double *HA1, double *Dec1, int
   if (abs(Dec) < 89.9833) {
 
     // initial rough guess at instrument HA,Dec
-    double h=HA/Rad;
-    double d=Dec/Rad;
+    double h=HA;
+    double d=Dec;
     
     for (int pass=0; pass < 3; pass++) {
-      double sinDec=sin(d);
-      double cosDec=cos(d);
-      double sinHA =sin(h);
-      double cosHA =cos(h);
-  
-      // ------------------------------------------------------------
-      // misalignment due to tube/optics not being perp. to Dec axis
-      // negative numbers are further (S) from the NCP, swing to the
-      // equator and the effect on declination is 0. At the SCP it
-      // becomes a (N) offset.  Unchanged with meridian flips.
-      // expressed as a correction to the Polar axis misalignment
-      double DOh=doCor*(1.0/cosDec)*p;
-  
-      // ------------------------------------------------------------
-      // misalignment due to Dec axis being perp. to RA axis
-      double PDh=-pdCor*(sinDec/cosDec)*p;
-  
-  #if MOUNT_TYPE == FORK
-      // Fork flex
-      double DFd=dfCor*cosHA;
-  #else
-      // Axis flex
-      double DFd=-dfCor*(cosLat*cosHA+sinLat*(sinDec/cosDec));
-  #endif
-  
-      // Tube flex
-      double TFh=tfCor*(cosLat*sinHA*(1.0/cosDec));
-      double TFd=tfCor*(cosLat*cosHA-sinLat*cosDec);
-  
-      // polar misalignment
-      double h1=-azmCor*cosHA*(sinDec/cosDec) + altCor*sinHA*(sinDec/cosDec);
-      double d1=+azmCor*sinHA                 + altCor*cosHA;
-      *HA1 =HA +(h1+PDh+DOh+TFh);
-      *Dec1=Dec+(d1+DFd+TFd);
+      double dh, dd;
+      correction(h,d,p,&dh,&dd);
+      *HA1 =HA +dh;
+      *Dec1=Dec+dd;
 
       // improved guess at instrument HA,Dec
-      h=*HA1/Rad;
-      d=*Dec1/Rad;
+      h=*HA1;
+      d=*Dec1;
     }
   } else {
     // just ignore the the correction if right on the pole
@@ -412,44 +586,10 @@ void TGeoAlign::instrToEqu(double HA, double Dec, double *HA1, double *Dec1, int
 
   // breaks-down near the pole (limited to > 1' from pole)
   if (abs(Dec) < 89.98333333) {
-    double h=HA/Rad;
-    double d=Dec/Rad;
-    double sinDec=sin(d);
-    double cosDec=cos(d);
-    double sinHA =sin(h);
-    double cosHA =cos(h);
-
-    // ------------------------------------------------------------
-    // misalignment due to tube/optics not being perp. to Dec axis
-    // negative numbers are further (S) from the NCP, swing to the
-    // equator and the effect on declination is 0. At the SCP it
-    // becomes a (N) offset.  Unchanged with meridian flips.
-    // expressed as a correction to the Polar axis misalignment
-    double DOh=doCor*(1.0/cosDec)*p;
-
-    // as the above offset becomes zero near the equator, the affect
-    // works on HA instead.  meridian flips affect this in HA
-    double PDh=-pdCor*(sinDec/cosDec)*p;
-
-#if MOUNT_TYPE == FORK
-    // Fork flex
-    double DFd=dfCor*cosHA;
-#else
-    // Axis flex
-    double DFd=-dfCor*(cosLat*cosHA+sinLat*(sinDec/cosDec));
-#endif
-
-    // Tube flex
-    double TFh=tfCor*(cosLat*sinHA*(1.0/cosDec));
-    double TFd=tfCor*(cosLat*cosHA-sinLat*cosDec);
-   
-    // ------------------------------------------------------------
-    // polar misalignment
-    double h1=-azmCor*cosHA*(sinDec/cosDec) + altCor*sinHA*(sinDec/cosDec);
-    double d1=+azmCor*sinHA                 + altCor*cosHA;
-
-    *HA1 =HA -(h1+PDh+DOh+TFh);
-    *Dec1=Dec-(d1+DFd+TFd);
+    double dh, dd;
+    correction(HA,Dec,p,&dh,&dd);
+    *HA1 =HA -dh;
+    *Dec1=Dec-dd;
   } else {
     // just ignore the the correction if right on the pole
     *HA1=HA;
@@ -462,4 +602,134 @@ void TGeoAlign::instrToEqu(double HA, double Dec, double *HA1, double *Dec1, int
   if (*Dec1 < -90.0) *Dec1=-90.0;
 }
 
+// the correction (in degrees) at instrument coordinates HA,Dec (in degrees) for pier side p (1 East, -1 West)
+void TGeoAlign::correction(double HA, double Dec, double p, double *dHA, double *dDec) {
+#ifdef ALIGN_CORRECTION_GRID_ON
+  if (grid_correction(HA,Dec,p,dHA,dDec)) return;
+#endif
+  double dHAp;
+  model_correction(HA,Dec,dHA,dDec,&dHAp);
+  *dHA+=dHAp*p;
+}
+
+// the correction (in degrees) at instrument coordinates HA,Dec (in degrees) from the model, dHA and dDec are for the East side
+// of the pier and dHAp is the part of the HA correction that changes sign on the West side
+void TGeoAlign::model_correction(double HA, double Dec, double *dHA, double *dDec, double *dHAp) {
+  double h=HA/Rad;
+  double d=Dec/Rad;
+  double cosDec=cos(d);
+  model_terms(sin(h),cos(h),sin(d)/cosDec,1.0/cosDec,cosDec,dHA,dDec,dHAp);
+}
+
+// the model_correction() given the sin and cos of HA, and tan, sec and cos of Dec
+void TGeoAlign::model_terms(double sinHA, double cosHA, double tanDec, double secDec, double cosDec, double *dHA, double *dDec, double *dHAp) {
+  // ------------------------------------------------------------
+  // misalignment due to tube/optics not being perp. to Dec axis
+  // negative numbers are further (S) from the NCP, swing to the
+  // equator and the effect on declination is 0. At the SCP it
+  // becomes a (N) offset.  Unchanged with meridian flips.
+  // expressed as a correction to the Polar axis misalignment
+  double DOh=doCor*secDec;
+
+  // ------------------------------------------------------------
+  // misalignment due to Dec axis being perp. to RA axis
+  // as the above offset becomes zero near the equator, the affect
+  // works on HA instead.  meridian flips affect this in HA
+  double PDh=-pdCor*tanDec;
+
+#if MOUNT_TYPE == FORK
+  // Fork flex
+  double DFd=dfCor*cosHA;
+#else
+  // Axis flex
+  double DFd=-dfCor*(cosLat*cosHA+sinLat*tanDec);
+#endif
+
+  // Tube flex
+  double TFh=tfCor*(cosLat*sinHA*secDec);
+  double TFd=tfCor*(cosLat*cosHA-sinLat*cosDec);
+
+  // ------------------------------------------------------------
+  // polar misalignment
+  double h1=-azmCor*cosHA*tanDec + altCor*sinHA*tanDec;
+  double d1=+azmCor*sinHA        + altCor*cosHA;
+
+  *dHA =h1+TFh;
+  *dDec=d1+DFd+TFd;
+  *dHAp=PDh+DOh;
+}
+
+#ifdef ALIGN_CORRECTION_GRID_ON
+// true if the Dec limit was worked out for the current model
+bool TGeoAlign::grid_current() {
+  return grid_ready && grid_coe[0] == doCor && grid_coe[1] == pdCor && grid_coe[2] == dfCor && grid_coe[3] == tfCor &&
+         grid_coe[4] == azmCor && grid_coe[5] == altCor && grid_coe[6] == cosLat && grid_coe[7] == sinLat;
+}
+
+// fills the tables once, then whenever the model changes (by align, :SXn# commands, or from NV) finds how close to the poles
+// they can be used.  Linear interpolation between entries h radians apart is within h^2/8 times the largest second derivative
+// in between, for sin and cos that's 1, for tan 2.tan.sec^2 and for sec sec.(sec^2+tan^2) which are largest at the end further
+// from the equator.  Those, and the float rounding, are carried through model_terms() for an upper bound on the error each step
+// of Dec and the tables are used up to the first step where that passes ALIGN_GRID_MAX_ERROR
+void TGeoAlign::grid_update() {
+  if (!grid_tables) {
+    for (int i=0; i <= ALIGN_GRID_HA_STEPS; i++) grid_sin[i]=sin((-180.0+i*ALIGN_GRID_STEP)/Rad);
+    for (int j=0; j <= ALIGN_GRID_DEC_STEPS; j++) {
+      double d=(j*ALIGN_GRID_STEP)/Rad;
+      grid_tan[j]=tan(d); grid_sec[j]=1.0/cos(d); grid_cos[j]=cos(d);
+    }
+    grid_tables=true;
+  }
+  if (grid_current()) return;
+
+  grid_coe[0]=doCor; grid_coe[1]=pdCor; grid_coe[2]=dfCor; grid_coe[3]=tfCor;
+  grid_coe[4]=azmCor; grid_coe[5]=altCor; grid_coe[6]=cosLat; grid_coe[7]=sinLat;
+
+  const double f=1.2E-7;                            // float rounding, relative
+  double h2=sq(ALIGN_GRID_STEP/Rad)/8.0;
+  double es=h2+f, ec=h2+f;
+  double polar=fabs(azmCor)+fabs(altCor);
+  grid_dec_limit=ALIGN_GRID_DEC_LIMIT;
+  for (int j=0; j < ALIGN_GRID_DEC_STEPS; j++) {
+    double t=grid_tan[j+1], s=grid_sec[j+1];
+    double et=h2*2.0*t*s*s+f*t, esec=h2*s*(s*s+t*t)+f*s;
+    double eh=polar*(t*es+et) + fabs(tfCor*cosLat)*(s*es+esec) + fabs(doCor)*esec + fabs(pdCor)*et;
+#if MOUNT_TYPE == FORK
+    double ed=polar*es + fabs(dfCor)*es + fabs(tfCor)*(fabs(cosLat)*es+fabs(sinLat)*ec);
+#else
+    double ed=polar*es + fabs(dfCor)*(fabs(cosLat)*es+fabs(sinLat)*et) + fabs(tfCor)*(fabs(cosLat)*es+fabs(sinLat)*ec);
+#endif
+    if ((eh*grid_cos[j]+ed)*3600.0 > ALIGN_GRID_MAX_ERROR) { grid_dec_limit=j*ALIGN_GRID_STEP; break; }
+  }
+  grid_ready=true;
+}
+
+// the correction from the tables, returns false if they aren't ready or don't cover this position
+bool TGeoAlign::grid_correction(double HA, double Dec, double p, double *dHA, double *dDec) {
+  if (!grid_current()) return false;
+  if (fabs(Dec) >= grid_dec_limit) return false;
+  while (HA >= 180.0) HA-=360.0;
+  while (HA < -180.0) HA+=360.0;
+
+  double x=(HA+180.0)/ALIGN_GRID_STEP;
+  int i=(int)x; if (i > ALIGN_GRID_HA_STEPS-1) i=ALIGN_GRID_HA_STEPS-1;
+  x-=i;
+  double sinHA=grid_sin[i]+(grid_sin[i+1]-grid_sin[i])*x;
+  i+=ALIGN_GRID_HA_STEPS/4; if (i >= ALIGN_GRID_HA_STEPS) i-=ALIGN_GRID_HA_STEPS;
+  double cosHA=grid_sin[i]+(grid_sin[i+1]-grid_sin[i])*x;
+
+  double y=fabs(Dec)/ALIGN_GRID_STEP;
+  int j=(int)y;
+  y-=j;
+  double tanDec=grid_tan[j]+(grid_tan[j+1]-grid_tan[j])*y; if (Dec < 0) tanDec=-tanDec;
+  double secDec=grid_sec[j]+(grid_sec[j+1]-grid_sec[j])*y;
+  double cosDec=grid_cos[j]+(grid_cos[j+1]-grid_cos[j])*y;
+
+  double dHAp;
+  model_terms(sinHA,cosHA,tanDec,secDec,cosDec,dHA,dDec,&dHAp);
+  *dHA+=dHAp*p;
+  return true;
+}
+#endif
+
 #endif
@@ -57,33 +57,40 @@ bool TGeoAlignH::isReady() {
 }
 
 // I=1 for 1st star, I=2 for 2nd star, I=3 for 3rd star
-// N=total number of stars for this align (1 to 9)
+// N=total number of stars for this align (1 to ALIGN_MAX_STARS)
 // RA, Dec (all in degrees)
 bool TGeoAlignH::addStar(int I, int N, double RA, double Dec) {
   double a,z;
   equToHor(haRange(LST()*15.0-RA),Dec,&a,&z);
 
+  align_coord2_t mnt, act;
+
   // First star, just sync
   if (I == 1) { if (syncEqu(RA,Dec) != GOTO_ERR_NONE) return false; }
 
-  mount[I-1].azm=getInstrAxis1();
-  mount[I-1].alt=getInstrAxis2();
-  horToEqu(mount[I-1].alt,mount[I-1].azm,&mount[I-1].ha,&mount[I-1].dec);
-  mount[I-1].azm=mount[I-1].azm/Rad;
-  mount[I-1].alt=mount[I-1].alt/Rad;
-  mount[I-1].ha=degRange(mount[I-1].ha)/Rad;
-  mount[I-1].dec=mount[I-1].dec/Rad;
-
-  actual[I-1].ha =haRange(LST()*15.0-RA);
-  actual[I-1].dec=Dec;
-  equToHor(actual[I-1].ha,actual[I-1].dec,&actual[I-1].alt,&actual[I-1].azm);
-  actual[I-1].alt=actual[I-1].alt/Rad;
-  actual[I-1].azm=actual[I-1].azm/Rad;
-  actual[I-1].ha =degRange(actual[I-1].ha)/Rad;
-  actual[I-1].dec=actual[I-1].dec/Rad;
-
-  if (getInstrPierSide() == PierSideWest) { actual[I-1].side=-1; mount[I-1].side=-1; } else
-  if (getInstrPierSide() == PierSideEast) { actual[I-1].side=1; mount[I-1].side=1; } else { actual[I-1].side=0; mount[I-1].side=0; }
+  mnt.azm=getInstrAxis1();
+  mnt.alt=getInstrAxis2();
+  horToEqu(mnt.alt,mnt.azm,&mnt.ha,&mnt.dec);
+  mnt.azm=mnt.azm/Rad;
+  mnt.alt=mnt.alt/Rad;
+  mnt.ha=degRange(mnt.ha)/Rad;
+  mnt.dec=mnt.dec/Rad;
+
+  act.ha =haRange(LST()*15.0-RA);
+  act.dec=Dec;
+  equToHor(act.ha,act.dec,&act.alt,&act.azm);
+  act.alt=act.alt/Rad;
+  act.azm=act.azm/Rad;
+  act.ha =degRange(act.ha)/Rad;
+  act.dec=act.dec/Rad;
+
+  if (getInstrPierSide() == PierSideWest) { act.side=-1; mnt.side=-1; } else
+  if (getInstrPierSide() == PierSideEast) { act.side=1; mnt.side=1; } else { act.side=0; mnt.side=0; }
+
+  // add it to the normal equations, and keep it if there's room
+  if (I == 1) clearNormal();
+  addNormal(&mnt,&act);
+  if (I <= ALIGN_MAX_STORED) { mount[I-1]=mnt; actual[I-1]=act; }
 
   // two or more stars and finished
   if ((I >= 2) && (I == N)) model(N);
@@ -259,6 +266,182 @@ void TGeoAlignH::do_search(double sf, int p1, int p2, int p3, int p4, int p5, in
   }
 }
 
+// residuals for a sample (m mount, a actual) with the terms x[] (Do,Pd,Pz,Pe,Tf,Ff,Df,Od,Oh in radians) as in do_search, and if j isn't NULL
+// their partial derivatives from correct() differentiated by hand, j[0..8] for the Azm residual and j[9..17] for Alt
+void TGeoAlignH::solve_residual(align_coord2_t *m, align_coord2_t *a, double *x, double *rz, double *ra, double *j) {
+  double s=m->side;
+  double Z=m->azm+(s != 0 ? x[8] : 0.0);  // ohw=ohe
+  double A=m->alt+x[7]*s;                  // odw=-ode
+  double sinZ=sin(Z), cosZ=cos(Z), sinA=sin(A), cosA=cos(A);
+  double tanA=sinA/cosA, secA=1.0/cosA;
+  double deo=x[0], pd=x[1], pz=x[2], pe=x[3], tf=x[4], ff=x[5], df=x[6];
+
+  double z1=-pz*cosZ*tanA + pe*sinZ*tanA + deo*secA*s - pd*tanA*s + tf*cosLat*sinZ*secA;
+  double a1=+pz*sinZ      + pe*cosZ      - df*(cosLat*cosZ+sinLat*tanA) + ff*cosZ + tf*(cosLat*cosZ-sinLat*cosA);
+
+  double c=cos(a->alt);
+  double e=a->azm-(Z-z1);
+  if (e > PI) e=e-PI*2.0; else if (e < -PI) e=e+PI*2.0;
+  *rz=e*c;
+  *ra=a->alt-(A-a1);
+  if (j == NULL) return;
+
+  // partials of the corrections with respect to the mount position
+  double zZ=pz*sinZ*tanA + pe*cosZ*tanA + tf*cosLat*cosZ*secA;
+  double zA=(-pz*cosZ + pe*sinZ - pd*s)*secA*secA + deo*s*secA*tanA + tf*cosLat*sinZ*secA*tanA;
+  double aZ=pz*cosZ - pe*sinZ + df*cosLat*sinZ - ff*sinZ - tf*cosLat*sinZ;
+  double aA=-df*sinLat*secA*secA + tf*sinLat*sinA;
+
+  j[0]=c*secA*s;  j[1]=-c*tanA*s;  j[2]=-c*cosZ*tanA;  j[3]=c*sinZ*tanA;
+  j[4]=c*cosLat*sinZ*secA;  j[5]=0.0;  j[6]=0.0;
+  j[7]=c*zA*s;  j[8]=(s != 0 ? c*(zZ-1.0) : 0.0);
+
+  j[9]=0.0;  j[10]=0.0;  j[11]=sinZ;  j[12]=cosZ;
+  j[13]=cosLat*cosZ-sinLat*cosA;  j[14]=cosZ;  j[15]=-(cosLat*cosZ+sinLat*tanA);
+  j[16]=(aA-1.0)*s;  j[17]=(s != 0 ? aZ : 0.0);
+}
+
+// sum of the squared residuals for all samples
+double TGeoAlignH::solve_sum(double *x) {
+  double e=0.0, rz, ra;
+  for (int l=0; l < num; l++) { solve_residual(&mount[l],&actual[l],x,&rz,&ra,NULL); e+=sq(rz)+sq(ra); }
+  return e;
+}
+
+// Levenberg-Marquardt least squares fit of the terms flagged in p1..p9 (the same as do_search) starting from the best_ values
+// usually this converges in well under ten iterations, each just a pass over the samples and a small linear solve
+void TGeoAlignH::do_solve(int p1, int p2, int p3, int p4, int p5, int p6, int p7, int p8, int p9) {
+  int p[9]={p1,p2,p3,p4,p5,p6,p7,p8,p9};
+  int k[9], n=0; for (int i=0; i < 9; i++) if (p[i] != 0) k[n++]=i;
+  if (n == 0) return;
+
+  double sf1=1.0/(3600.0*Rad);
+  double x[9]={best_deo*sf1,best_pd*sf1,best_pz*sf1,best_pe*sf1,best_tf*sf1,best_ff*sf1,best_df*sf1,best_ode*sf1,best_ohe*sf1};
+  double e=solve_sum(x);
+  double lambda=0.001;
+
+  for (int iter=0; iter < 50; iter++) {
+    // normal equations J'J.dx=-J'r for the free terms
+    double a[81], g[9], j[18], rz, ra;
+    for (int r=0; r < n; r++) { g[r]=0.0; for (int c=0; c < n; c++) a[r*n+c]=0.0; }
+    for (int l=0; l < num; l++) {
+      solve_residual(&mount[l],&actual[l],x,&rz,&ra,j);
+      for (int r=0; r < n; r++) {
+        g[r]+=j[k[r]]*rz+j[9+k[r]]*ra;
+        for (int c=0; c <= r; c++) a[r*n+c]+=j[k[r]]*j[k[c]]+j[9+k[r]]*j[9+k[c]];
+      }
+    }
+    for (int r=0; r < n; r++) for (int c=r+1; c < n; c++) a[r*n+c]=a[c*n+r];
+
+    // raise the damping until a step improves the fit
+    bool better=false; double step=0.0;
+    while (lambda < 1.0E10) {
+      double a1[81], dx[9], x1[9];
+      for (int i=0; i < n*n; i++) a1[i]=a[i];
+      for (int r=0; r < n; r++) { a1[r*n+r]+=lambda*fmax(a[r*n+r],1.0E-12); dx[r]=-g[r]; }
+      if (choleskySolve(a1,dx,n)) {
+        for (int i=0; i < 9; i++) x1[i]=x[i];
+        step=0.0; for (int r=0; r < n; r++) { x1[k[r]]+=dx[r]; step=fmax(step,fabs(dx[r])); }
+        double e1=solve_sum(x1);
+        if (e1 < e) { for (int i=0; i < 9; i++) x[i]=x1[i]; e=e1; lambda*=0.1; better=true; break; }
+      }
+      lambda*=10.0;
+    }
+
+    // done when nothing improves or the step is below 0.001 arc-seconds
+    if (!better || (step < 0.001*sf1)) break;
+  }
+
+  best_deo=x[0]/sf1;
+  best_pd =x[1]/sf1;
+  best_pz =x[2]/sf1;
+  best_pe =x[3]/sf1;
+  best_tf =x[4]/sf1;
+  best_ff =x[5]/sf1;
+  best_df =x[6]/sf1;
+  best_ode=x[7]/sf1; best_odw=-best_ode;
+  best_ohe=x[8]/sf1; best_ohw=best_ohe;
+  best_dist=sqrt(e/(num-1));
+}
+
+#ifdef ALIGN_NORMAL_EQUATIONS
+// starts a new set of normal equations
+void TGeoAlignH::clearNormal() {
+  for (int i=0; i < 81; i++) nAtA[i]=0.0;
+  for (int i=0; i < 9; i++) { nAtr[i]=0.0; nX[i]=0.0; }
+  nRtr=0.0; nNum=0;
+}
+
+// adds a sample to the normal equations, any number of samples can be added and the model is then solved from just these sums.
+// each sample is linearized about the fit so far (all terms zero to start) which is good to second order in how far off that is
+void TGeoAlignH::addNormal(align_coord2_t *m, align_coord2_t *a) {
+  lat=90.0/Rad;
+  cosLat=cos(lat);
+  sinLat=sin(lat);
+
+  // r(x)=r(x0)+J.(x-x0), so the normal equations are in J and b=r(x0)-J.x0
+  double j[18], rz, ra;
+  solve_residual(m,a,nX,&rz,&ra,j);
+  for (int i=0; i < 9; i++) { rz-=j[i]*nX[i]; ra-=j[9+i]*nX[i]; }
+  for (int r=0; r < 9; r++) {
+    nAtr[r]+=j[r]*rz+j[9+r]*ra;
+    for (int c=0; c < 9; c++) nAtA[r*9+c]+=j[r]*j[c]+j[9+r]*j[9+c];
+  }
+  nRtr+=sq(rz)+sq(ra);
+  nNum++;
+
+  // update the point to linearize about once there are enough samples to pin down the large terms (polar axis, cone and index)
+  if (nNum > 5) {
+    //          DoPdPzPeTfFfDfOdOh
+    int p[9]={1,0,1,1,0,0,0,1,1};
+    double e; solve_normal(p,nX,&e);
+  }
+}
+
+// least squares fit of the terms flagged in p[] from the normal equations, the others are zero.  x[] gets the terms (in radians)
+// and e the sum of the squared residuals, returns false if there aren't enough samples
+bool TGeoAlignH::solve_normal(int *p, double *x, double *e) {
+  int k[9], n=0; for (int i=0; i < 9; i++) if (p[i] != 0) k[n++]=i;
+  if ((n == 0) || (nNum < 2)) return false;
+
+  // a little damping keeps terms the samples can't tell apart from running away
+  double a[81], t[9], g[9];
+  for (int r=0; r < n; r++) {
+    for (int c=0; c < n; c++) a[r*n+c]=nAtA[k[r]*9+k[c]];
+    a[r*n+r]+=1.0E-9*fmax(nAtA[k[r]*9+k[r]],1.0E-12);
+    g[r]=-nAtr[k[r]]; t[r]=g[r];
+  }
+  if (!choleskySolve(a,t,n)) return false;
+
+  // r'r after the fit is b'b + t'J'b, as J'J.t=-J'b
+  *e=nRtr; for (int r=0; r < n; r++) *e-=t[r]*g[r];
+  if (*e < 0.0) *e=0.0;
+
+  for (int i=0; i < 9; i++) x[i]=0.0;
+  for (int r=0; r < n; r++) x[k[r]]=t[r];
+  return true;
+}
+
+// least squares fit of the terms flagged in p1..p9 (the same as do_search) from the normal equations
+void TGeoAlignH::do_solve_normal(int p1, int p2, int p3, int p4, int p5, int p6, int p7, int p8, int p9) {
+  int p[9]={p1,p2,p3,p4,p5,p6,p7,p8,p9};
+  double x[9], e;
+  if (!solve_normal(p,x,&e)) return;
+
+  double sf1=1.0/(3600.0*Rad);
+  best_deo=x[0]/sf1;
+  best_pd =x[1]/sf1;
+  best_pz =x[2]/sf1;
+  best_pe =x[3]/sf1;
+  best_tf =x[4]/sf1;
+  best_ff =x[5]/sf1;
+  best_df =x[6]/sf1;
+  best_ode=x[7]/sf1; best_odw=-best_ode;
+  best_ohe=x[8]/sf1; best_ohw=best_ohe;
+  best_dist=sqrt(e/(nNum-1));
+}
+#endif
+
 void TGeoAlignH::autoModel(int n) {
 
   num=n; // how many stars?
@@ -278,6 +461,13 @@ void TGeoAlignH::autoModel(int n) {
   best_ode    =0.0;
   best_ohe    =0.0;
 
+  // these don't apply for Alt/Az
+  Ff=0; Df=0;
+
+  // only search for cone error if > 2 stars
+  int Do=0; if (num > 2) Do=1;
+  
+#ifndef ALIGN_NORMAL_EQUATIONS
   // figure out the average Az offset as a starting point
   ohe=0;
   for (l=0; l < num; l++) {
@@ -287,13 +477,9 @@ void TGeoAlignH::autoModel(int n) {
     ohe=ohe+z1;
   }
   ohe=ohe/num; best_ohe=round(ohe*Rad*3600.0); best_ohw=best_ohe;
+#endif
 
-  // these don't apply for Alt/Az
-  Ff=0; Df=0;
-
-  // only search for cone error if > 2 stars
-  int Do=0; if (num > 2) Do=1;
-  
+#ifdef ALIGN_GRID_SEARCH_ON
   // search, this can handle about 9 degrees of polar misalignment, and 4 degrees of cone error
   //              DoPdPzPeTfFf Df OdOh
   do_search(16384,0 ,0,1,1,0, 0, 0,1,1);
@@ -325,6 +511,19 @@ void TGeoAlignH::autoModel(int n) {
     do_search(   16,Do,0,1,1,0, 0, 0,1,1);
 #endif
   }
+#endif
+#else
+  // least squares fit, the polar axis and flexure terms too if > 4 stars
+  int Pd=0, Tf=0; if (num > 4) { Pd=1; Tf=1; } else { Ff=0; Df=0; }
+#ifdef ALIGN_NORMAL_EQUATIONS
+  // first from the normal equations accumulated as the stars were added, then with the full model if all the stars are on hand
+  //              DoPdPzPeTfFf Df OdOh
+  do_solve_normal(Do,Pd,1,1,Tf,Ff,Df,1,1);
+  if (num <= ALIGN_MAX_STORED) do_solve(Do,Pd,1,1,Tf,Ff,Df,1,1);
+#else
+  //       DoPdPzPeTfFf Df OdOh
+  do_solve(Do,Pd,1,1,Tf,Ff,Df,1,1);
+#endif
 #endif
 
   // geometric corrections
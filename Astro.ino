@@ -448,6 +448,7 @@ void setDeltaTrackingRate() {
   // trackingTimerRateAxis1/2 are x the sidereal rate
   if (trackingState == TrackingSidereal) trackingTimerRateAxis1=(_deltaAxis1/15.0)+f1; else trackingTimerRateAxis1=0.0;
   if (trackingState == TrackingSidereal) trackingTimerRateAxis2=(_deltaAxis2/15.0)+f2; else trackingTimerRateAxis2=0.0;
+  TIMER_RATE_Q(trackingTimerRateAxis1Q=toQ24(trackingTimerRateAxis1); trackingTimerRateAxis2Q=toQ24(trackingTimerRateAxis2));
   sei();
   fstepAxis1.fixed=doubleToFixed( (((double)AXIS1_STEPS_PER_DEGREE/240.0)*(_deltaAxis1/15.0))/100.0 );
   fstepAxis2.fixed=doubleToFixed( (((double)AXIS2_STEPS_PER_DEGREE/240.0)*(_deltaAxis2/15.0))/100.0 );
@@ -758,6 +759,12 @@ void setAccelerationRates(double maxRate) {
   slewRateX  = (RateToXPerSec/(maxRate/16.0))*5.0;         // 5x for exponential factor average rate
   slewRateX = slewRateX*((MaxRateDef/2.0)/(maxRate/16.0)); // scale with maxRate so SLEW_ACCELERATION_DIST and SLEW_RAPID_STOP_DIST are approximately correct
   accXPerSec = slewRateX/SLEW_ACCELERATION_DIST;
+#if TIMER_FIXED_POINT == ON
+  cli();
+  accXPerCsQ16=(long)((accXPerSec/100.0)*65536.0);
+  slewRateXInvSqrtQ16=(unsigned long)(65536.0/sqrt(slewRateX));
+  sei();
+#endif
   guideRates[9]=RateToASPerSec/(maxRate/16.0); guideRates[8]=guideRates[9]/2.0;
   activeGuideRate=GuideRateNone;
   
@@ -4,6 +4,7 @@
 // last RA/Dec time
 unsigned long _coord_t=0;
 
+
 // help with commands
 enum Command {COMMAND_NONE, COMMAND_SERIAL_A, COMMAND_SERIAL_B, COMMAND_SERIAL_C, COMMAND_SERIAL_ST4, COMMAND_SERIAL_X};
 cb cmdA;  // the first Serial is always enabled
@@ -16,7 +17,16 @@ cb cmdC;
 #if ST4_HAND_CONTROL == ON
 cb cmdST4;
 #endif
-char _replyX[50]=""; cb cmdX;  // virtual command channel for internal use
+char _replyX[80]=""; cb cmdX;  // virtual command channel for internal use
+
+// channels (bit n for Command n) that have negotiated binary telemetry with :GXB0#, and when each last sent a command
+// a channel that goes quiet for BINARY_TIMEOUT_MS drops binary telemetry and any pushed frames (the client has gone away)
+#define BINARY_TIMEOUT_MS 60000UL
+byte binaryChannels=0;
+unsigned long binaryLastCommand[COMMAND_SERIAL_C+1];
+// channel and period (in 1/100 second) of pushed telemetry frames set with :SXB2,n#
+Command telemetryChannel=COMMAND_NONE;
+int telemetryPeriod=0;
 
 // process commands
 void processCommands() {
@@ -29,56 +39,47 @@ void processCommands() {
     static double _dec,_ra;
 
     // command processing
-    static char reply[50];
-    static char command[3];
-    static char parameter[25];
+    static char reply[80];
+    char *command;
+    char *parameter;
     static boolean commandError = false;
     static boolean quietReply   = false;
 
     boolean supress_frame = false;
+    int binaryLength = 0;
     char *conv_end;
 #if FOCUSER1 == ON
     static char primaryFocuser = 'F';
     static char secondaryFocuser = 'f';
 #endif
 
-    // accumulate the command
-    if ((SerialA.available() > 0) && (!cmdA.ready())) cmdA.add(SerialA.read());
+    // accumulate the commands, taking everything that has arrived on each channel
+    while ((SerialA.available() > 0) && (!cmdA.ready())) cmdA.add(SerialA.read());
 #ifdef HAL_SERIAL_B_ENABLED
-    if ((SerialB.available() > 0) && (!cmdB.ready())) cmdB.add(SerialB.read());
+    while ((SerialB.available() > 0) && (!cmdB.ready())) cmdB.add(SerialB.read());
 #endif
 #ifdef HAL_SERIAL_C_ENABLED
-    if ((SerialC.available() > 0) && (!cmdC.ready())) cmdC.add(SerialC.read());
+    while ((SerialC.available() > 0) && (!cmdC.ready())) cmdC.add(SerialC.read());
 #endif
 #if ST4_HAND_CONTROL == ON
-    if ((SerialST4.available() > 0) && (!cmdST4.ready())) cmdST4.add(SerialST4.read());
-#endif
-
-    // send any reply
-#ifdef HAL_SERIAL_TRANSMIT
-    if (SerialA.transmit()) return;
-  #ifdef HAL_SERIAL_B_ENABLED
-    if (SerialB.transmit()) return;
-  #endif
-  #ifdef HAL_SERIAL_C_ENABLED
-    if (SerialC.transmit()) return;
-  #endif
+    while ((SerialST4.available() > 0) && (!cmdST4.ready())) cmdST4.add(SerialST4.read());
 #endif
 
-    // if a command is ready, process it
+    // if a command is ready, process it; the channels take turns so a busy one can't hold up the others
+    static Command lastChannel = COMMAND_NONE;
     Command process_command = COMMAND_NONE;
-    if (cmdA.ready()) { strcpy(command,cmdA.getCmd()); strcpy(parameter,cmdA.getParameter()); cmdA.flush(); process_command=COMMAND_SERIAL_A; }
-#ifdef HAL_SERIAL_B_ENABLED
-    else if (cmdB.ready()) { strcpy(command,cmdB.getCmd()); strcpy(parameter,cmdB.getParameter()); cmdB.flush(); process_command=COMMAND_SERIAL_B; }
-#endif
-#ifdef HAL_SERIAL_C_ENABLED
-    else if (cmdC.ready()) { strcpy(command,cmdC.getCmd()); strcpy(parameter,cmdC.getParameter()); cmdC.flush(); process_command=COMMAND_SERIAL_C; }
-#endif
-#if ST4_HAND_CONTROL == ON
-    else if (cmdST4.ready()) { strcpy(command,cmdST4.getCmd()); strcpy(parameter,cmdST4.getParameter()); cmdST4.flush(); process_command=COMMAND_SERIAL_ST4; }
-#endif
-    else if (cmdX.ready()) { strcpy(command,cmdX.getCmd()); strcpy(parameter,cmdX.getParameter()); cmdX.flush(); process_command=COMMAND_SERIAL_X; }
-    else return;
+    for (int j=1; j <= COMMAND_SERIAL_X; j++) {
+      Command c=(Command)((lastChannel+j-1)%COMMAND_SERIAL_X+1);
+      cb *buf=commandBuffer(c);
+      if ((buf != NULL) && buf->ready()) {
+        command=buf->getCmd(); parameter=buf->getParameter(); buf->flush();
+        process_command=c;
+        break;
+      }
+    }
+    if (process_command == COMMAND_NONE) return;
+    lastChannel=process_command;
+    if (process_command <= COMMAND_SERIAL_C) binaryLastCommand[process_command]=millis();
 
     if (process_command) {
 // Command is two chars followed by an optional parameter...
@@ -86,7 +87,9 @@ void processCommands() {
 // Handles empty and one char replies
       reply[0]=0; reply[1]=0;
 
+      switch (command[0]) {
 //   (char)6 - Special
+    case (char)6:
       if (command[0] == (char)6) {
         if (command[1] == '0') {
           reply[0]=command[1]; strcpy(reply,"CK_FAIL");  // last cmd checksum failed
@@ -95,9 +98,11 @@ void processCommands() {
           supress_frame=true;
         }
         quietReply=true;
-      } else
+      } else commandError=true;
+      break;
 
 //   A - Alignment Commands
+    case 'A':
       if (command[0] == 'A') {
 //  :AW#  Align Write to EEPROM
 //         Returns: 1 on success
@@ -109,11 +114,14 @@ void processCommands() {
 //         where m is the maximum number of alignment stars
 //               n is the current alignment star (0 otherwise)
 //               o is the last required alignment star when an alignment is in progress (0 otherwise)
+//         or for an alignment of more than 9 stars: m,n,o# all in decimal, with m the most stars for an align (ALIGN_MAX_STARS)
         if (command[1] == '?') {
-          reply[0]=MAX_NUM_ALIGN_STARS;
-          reply[1]='0'+alignThisStar;
-          reply[2]='0'+alignNumStars;
-          reply[3]=0;
+          if (alignNumStars > 9) sprintf(reply,"%d,%d,%d",(int)ALIGN_MAX_STARS,(int)alignThisStar,(int)alignNumStars); else {
+            reply[0]=MAX_NUM_ALIGN_STARS;
+            reply[1]='0'+alignThisStar;
+            reply[2]='0'+alignNumStars;
+            reply[3]=0;
+          }
           quietReply=true;
         } else
 //  :An#  Start Telescope Manual Alignment Sequence
@@ -129,9 +137,11 @@ void processCommands() {
 //         8) Issue a goto command
 //         9) Center the star/object using the guide commands (as needed)
 //         10) Call :A+# command to accept the correction
+//         :Ann# (10 to ALIGN_MAX_STARS) starts an alignment with more stars, for mapping the sky with a plate solver for example
 //          Return: 0 on failure
 //                  1 on success
-        if ((command[1] >= '1') && (command[1] <= MAX_NUM_ALIGN_STARS) && (parameter[0] == 0)) {
+        if (((command[1] >= '1') && (command[1] <= MAX_NUM_ALIGN_STARS) && (parameter[0] == 0)) ||
+            ((command[1] >= '1') && (command[1] <= '9') && (parameter[0] >= '0') && (parameter[0] <= '9') && (parameter[1] == 0) && ((command[1]-'0')*10+(parameter[0]-'0') <= ALIGN_MAX_STARS))) {
           // set current time and date before calling this routine
 
           // telescope should be set in the polar home (CWD) for a starting point
@@ -143,7 +153,7 @@ void processCommands() {
           enableStepperDrivers();
         
           // start align...
-          alignNumStars=command[1]-'0';
+          alignNumStars=command[1]-'0'; if (parameter[0] != 0) alignNumStars=alignNumStars*10+(parameter[0]-'0');
           alignThisStar=1;
        
           if (commandError) { alignNumStars=0; alignThisStar=1; }
@@ -161,7 +171,8 @@ void processCommands() {
         else
           commandError=true;
       }
-      else
+      else commandError=true;
+      break;
 
 //   $ - Set parameter
 //  :$BDddd# Set Dec/Alt Antibacklash
@@ -171,6 +182,7 @@ void processCommands() {
 //          Return: 0 on failure
 //                  1 on success
 //         Set the Backlash values.  Units are arc-seconds
+    case '$':
       if ((command[0] == '$') && (command[1] == 'B')) {
         if ((strlen(parameter) > 1) && (strlen(parameter) < 5)) {
           if ( (atoi2((char*)&parameter[1],&i)) && ((i >= 0) && (i <= 999))) { 
@@ -188,12 +200,56 @@ void processCommands() {
         } else commandError=true;
       } else
       
+//   $Q - PEC Control
+//  :$QZ+  Enable RA PEC compensation 
+//         Returns: nothing
+//  :$QZ-  Disable RA PEC Compensation
+//         Returns: nothing
+//  :$QZZ  Clear the PEC data buffer
+//         Return: Nothing
+//  :$QZ/  Ready Record PEC
+//         Returns: nothing
+//  :$QZ!  Write PEC data to EEPROM
+//         Returns: nothing
+//  :$QZ?  Get PEC status
+//         Returns: S# or S.# or S!# or S.!# (. the index was detected, ! the last save had to alter the table to fit in NV)
+      if ((command[0] == '$') && (command[1] == 'Q')) {
+        if ((parameter[2] == 0) && (parameter[0] == 'Z')) {
+          quietReply=true; 
+#if MOUNT_TYPE != ALTAZM
+          if (parameter[1] == '+') { if (pecRecorded) pecStatus=ReadyPlayPEC; nvj.write(EE_pecStatus,pecStatus); } else
+          if (parameter[1] == '-') { pecStatus=IgnorePEC; nvj.write(EE_pecStatus,pecStatus); } else
+          if ((parameter[1] == '/') && (trackingState == TrackingSidereal)) { pecStatus=ReadyRecordPEC; nvj.write(EE_pecStatus,IgnorePEC); } else
+          if (parameter[1] == 'Z') { 
+            for (i=0; i<pecBufferSize; i++) pecSet(i,0);
+            pecFirstRecord = true;
+            pecStatus      = IgnorePEC;
+            pecRecorded    = false;
+            pecSaveSlewed  = false;
+            nvj.write(EE_pecStatus,pecStatus);
+            nvj.write(EE_pecRecorded,pecRecorded);
+          } else
+          if (parameter[1] == '!') {
+            pecRecorded=true;
+            nvj.write(EE_pecRecorded,pecRecorded);
+            nv.writeLong(EE_wormSensePos,wormSensePos);
+            // trigger recording of PEC buffer
+            if (!pecSave()) commandError=true;
+          } else
+#endif
+          // Status is one of "IpPrR" (I)gnore, get ready to (p)lay, (P)laying, get ready to (r)ecord, (R)ecording.  Or an optional (.) to indicate an index detect.
+          if (parameter[1] == '?') { const char *pecStatusCh = PECStatusString; reply[0]=pecStatusCh[pecStatus]; reply[1]=0; reply[2]=0; reply[3]=0; i=1; if (wormSensedAgain) { reply[i++]='.'; wormSensedAgain=false; } if (pecSaveSlewed) reply[i++]='!'; } else { quietReply=false; commandError=true; }
+        } else commandError=true;
+      } else commandError=true;
+      break;
+
 //   % - Return parameter
 //  :%BD# Get Dec Antibacklash
 //          Return: d#
 //  :%BR# Get RA Antibacklash
 //          Return: d#
 //          Get the Backlash values.  Units are arc-seconds
+    case '%':
       if ((command[0] == '%') && (command[1] == 'B')) {
         if (parameter[0] == 'D') {
             reactivateBacklashComp();
@@ -209,13 +265,15 @@ void processCommands() {
             sprintf(reply,"%d",i);
             quietReply=true;
         } else commandError=true;
-      } else
+      } else commandError=true;
+      break;
       
 //   B - Reticule/Accessory Control
 //  :B+#   Increase reticule Brightness
 //         Returns: Nothing
 //  :B-#   Decrease Reticule Brightness
 //         Returns: Nothing
+    case 'B':
       if ((command[0] == 'B') && ((command[1] == '+') || (command[1] == '-')))  {
 #if LED_RETICLE >= 0
         int scale;
@@ -228,13 +286,15 @@ void processCommands() {
         analogWrite(ReticlePin,reticuleBrightness);
 #endif
         quietReply=true;
-      } else 
+      } else commandError=true;
+      break;
 
 //   C - Sync Control
 //  :CS#   Synchonize the telescope with the current right ascension and declination coordinates
 //         Returns: Nothing (Sync's fail silently)
 //  :CM#   Synchonize the telescope with the current database object (as above)
 //         Returns: "N/A#" on success, "En#" on failure where n is the error code per the :MS# command
+    case 'C':
       if ((command[0] == 'C') && ((command[1] == 'S') || command[1] == 'M'))  {
         if ((parkStatus == NotParked) && (trackingState != TrackingMoveTo)) {
 
@@ -256,17 +316,21 @@ void processCommands() {
 
           quietReply=true;
         }
-      } else 
+      } else commandError=true;
+      break;
 
 //   D - Distance Bars
 //  :D#    returns an "\0x7f#" if the mount is moving, otherwise returns "#".
-      if ((command[0] == 'D') && (command[1] == 0))  { if (trackingState == TrackingMoveTo) { reply[0]=(char)127; reply[1]=0; } else { reply[0]='#'; reply[1]=0; supress_frame=true; } quietReply=true; } else 
+    case 'D':
+      if ((command[0] == 'D') && (command[1] == 0))  { if (trackingState == TrackingMoveTo) { reply[0]=(char)127; reply[1]=0; } else { reply[0]='#'; reply[1]=0; supress_frame=true; } quietReply=true; } else commandError=true;
+      break;
 
 #if SERIAL_B_ESP_FLASHING == ON
 //   E - Enter special mode
 //  :ESPFLASH# ESP8266 device flash mode
 //         Returns: Never (infinite loop)
 //       OnStep must be at home and tracking turned off for this command to work.  A power cycle is required to resume normal operation.
+    case 'E':
       if (command[0] == 'E') {
         if ((command[1] == 'S') && (parameter[0] == 'P') && (parameter[1] == 'F') && (parameter[2] == 'L') && (parameter[3] == 'A') && (parameter[4] == 'S') && (parameter[5] == 'H')) {
           if ((atHome) && (trackingState == TrackingNone)) {
@@ -317,11 +381,13 @@ void processCommands() {
 
           } else commandError=true;
         } else commandError=true;
-      } else
+      } else commandError=true;
+      break;
 #endif
 
 #if FOCUSER1 == ON
 //   F,f - Focuser1 and Focuser2 Commands
+    case 'F': case 'f':
       if (command[0] == 'F' || command[0]=='f') {
 
         focuser *foc = NULL;
@@ -446,10 +512,12 @@ void processCommands() {
         if (command[1] == 'h') { foc->setTarget((foc->getMax()+foc->getMin())/2.0); quietReply=true; } else commandError=true;
         
         } else commandError=true;
-      } else
+      } else commandError=true;
+      break;
 #endif
 
 //   G - Get Telescope Information
+    case 'G':
       if (command[0] == 'G') {
 
 //  :GA#   Get Telescope Altitude
@@ -672,55 +740,7 @@ void processCommands() {
 //  :Gu#   Get bit packed telescope status
 //         Returns: SS#
       if (command[1] == 'u')  {
-        memset(reply,(char)0b10000000,9);
-        if ((trackingState != TrackingSidereal) || trackingSyncInProgress()) reply[0]|=0b10000001; // Not tracking
-        if ((trackingState != TrackingMoveTo) && !trackingSyncInProgress())  reply[0]|=0b10000010; // No goto
-        if (PPSsynced)                               reply[0]|=0b10000100;                       // PPS sync
-        if ((guideDirAxis1) || (guideDirAxis2))      reply[0]|=0b10001000;                       // Guide active
-#if MOUNT_TYPE != ALTAZM
-        if (rateCompensation == RC_REFR_RA)            reply[0]|=0b11010000;                       // Refr enabled Single axis
-        if (rateCompensation == RC_REFR_BOTH)          reply[0]|=0b10010000;                       // Refr enabled
-        if (rateCompensation == RC_FULL_RA)            reply[0]|=0b11100000;                       // OnTrack enabled Single axis
-        if (rateCompensation == RC_FULL_BOTH)          reply[0]|=0b10100000;                       // OnTrack enabled
-#endif
-        if (rateCompensation == RC_NONE) {
-          double tr=getTrackingRate60Hz();
-          if (abs(tr-57.900)<0.001)                  reply[1]|=0b10000001; else                  // Lunar rate selected
-          if (abs(tr-60.000)<0.001)                  reply[1]|=0b10000010; else                  // Solar rate selected
-          if (abs(tr-60.136)<0.001)                  reply[1]|=0b10000011;                       // King rate selected
-        }
-        
-        if (atHome)                                  reply[2]|=0b10000001;                       // At home
-        if (waitingHome)                             reply[2]|=0b10000010;                       // Waiting at home
-        if (pauseHome)                               reply[2]|=0b10000100;                       // Pause at home enabled?
-        if (soundEnabled)                            reply[2]|=0b10001000;                       // Buzzer enabled?
-#if MOUNT_TYPE == GEM
-        if (autoMeridianFlip)                        reply[2]|=0b10010000;                       // Auto meridian flip
-#endif
-        if (pecRecorded)                             reply[2]|=0b10100000;                       // PEC data has been recorded
-
-        // provide mount type
-#if MOUNT_TYPE == GEM
-                                                     reply[3]|=0b10000001;                       // GEM
-#elif MOUNT_TYPE == FORK
-                                                     reply[3]|=0b10000010;                       // FORK
-#elif MOUNT_TYPE == ALTAZM
-                                                     reply[3]|=0b10001000;                       // ALTAZM
-#endif
-
-        // provide pier side info.
-        if (getInstrPierSide() == PierSideNone)        reply[3]|=0b10010000; else                  // Pier side none
-        if (getInstrPierSide() == PierSideEast)        reply[3]|=0b10100000; else                  // Pier side east
-        if (getInstrPierSide() == PierSideWest)        reply[3]|=0b11000000;                       // Pier side west
-
-#if MOUNT_TYPE != ALTAZM
-        reply[4]=pecStatus|0b10000000;                                                           // PEC status: 0 ignore, 1 get ready to play, 2 playing, 3 get ready to record, 4 recording
-#endif
-        reply[5]=parkStatus|0b10000000;                                                          // Park status: 0 not parked, 1 parking in-progress, 2 parked, 3 park failed
-        reply[6]=getPulseGuideRate()|0b10000000;                                                 // Pulse-guide rate
-        reply[7]=getGuideRate()|0b10000000;                                                      // Guide rate
-        reply[8]=lastError|0b10000000;                                                           // Last error
-        reply[9]=0;
+        statusBits(reply);
         quietReply=true;
       } else
 //  :GVD# Get Telescope Firmware Date
@@ -767,10 +787,17 @@ void processCommands() {
        } else
 //  :GXnn#   Get OnStep value
 //         Returns: value
+//  :GXS0#   Get mount state snapshot
+//         Returns: RA,Dec,Alt,Azm,LST,UTC,pierSide,status# (status as :Gu#, all taken at the same instant)
+//  :GXB0#   Enable binary telemetry on this channel (SerialA/B/C only), it's dropped after a minute without any commands
+//         Returns: 1,s.sss,s.sss# (protocol version, Axis1 and Axis2 steps per degree)
+//  :GXB1#   Get binary telemetry frame (once enabled)
+//         Returns: STX,len,type,payload,CRC16 (binary, no '#')
       if (command[1] == 'X')  {
         if (parameter[2] == (char)0) {
           if (parameter[0] == '0') { // 0n: Align Model
             static int star=0;
+            if ((parameter[1] >= 'A') && (parameter[1] <= 'E') && (star >= ALIGN_MAX_STORED)) commandError=true; else
             switch (parameter[1]) {
               case '0': sprintf(reply,"%ld",(long)(Align.ax1Cor*3600.0)); quietReply=true; break; // ax1Cor
               case '1': sprintf(reply,"%ld",(long)(Align.ax2Cor*3600.0)); quietReply=true; break; // ax2Cor
@@ -787,7 +814,7 @@ void processCommands() {
 #endif
               case '8': sprintf(reply,"%ld",(long)(Align.tfCor*3600.0)); quietReply=true; break;  // tfCor
 
-              case '9': { int n=0; if (alignThisStar > alignNumStars) n=alignNumStars; sprintf(reply,"%ld",(long)(n)); star=0; quietReply=true; } break; // Number of stars, reset to first star
+              case '9': { int n=0; if (alignThisStar > alignNumStars) n=alignNumStars; if (n > ALIGN_MAX_STORED) n=ALIGN_MAX_STORED; sprintf(reply,"%ld",(long)(n)); star=0; quietReply=true; } break; // Number of stars (that are stored,) reset to first star
               case 'A': { double f=(Align.actual[star].ha*Rad)/15.0; doubleToHms(reply,&f,true);       quietReply=true; } break; // Star  #n HA
               case 'B': { double f=(Align.actual[star].dec*Rad);     doubleToDms(reply,&f,false,true); quietReply=true; } break; // Star  #n Dec
               case 'C': { double f=(Align.mount[star].ha*Rad)/15.0;  doubleToHms(reply,&f,true);       quietReply=true; } break; // Mount #n HA
@@ -926,6 +953,22 @@ void processCommands() {
               default:  commandError=true;
             }
           } else
+          if ((parameter[0] == 'S') && (parameter[1] == '0')) { mountSnapshot(reply); quietReply=true; } else                // S0: Mount state snapshot
+          if ((parameter[0] == 'B') && ((process_command == COMMAND_SERIAL_A) || (process_command == COMMAND_SERIAL_B) || (process_command == COMMAND_SERIAL_C))) { // Bn: Binary telemetry
+            switch (parameter[1]) {
+              case '0':                                                                                      // handshake, enables binary frames on this channel
+                bitSet(binaryChannels,process_command);
+                strcpy(reply,"1,"); dtostrf((double)AXIS1_STEPS_PER_DEGREE,1,3,&reply[2]);              // protocol version, steps per degree
+                strcat(reply,","); dtostrf((double)AXIS2_STEPS_PER_DEGREE,1,3,&reply[strlen(reply)]);
+                quietReply=true; break;
+              case '1': if (bitRead(binaryChannels,process_command)) { binaryLength=telemetryFrame(reply); quietReply=true; } else commandError=true; break; // telemetry frame
+              default:  commandError=true;
+            }
+          } else
+#ifdef PROFILE_ON
+          if ((parameter[0] == 'Y') && (parameter[1] >= '0') && (parameter[1] < '0'+PROFILE_PROBES)) { profile.summary(parameter[1]-'0',reply); quietReply=true; } else   // Yn: Profile summary count,avg,worst (us)
+          if ((parameter[0] == 'Z') && (parameter[1] >= '0') && (parameter[1] < '0'+PROFILE_PROBES)) { profile.histogram(parameter[1]-'0',reply); quietReply=true; } else // Zn: Profile histogram (and clear)
+#endif
 #ifdef Aux0
           if ((parameter[0] == 'G') && (parameter[1] == '0')) { sprintf(reply,"%d",(int)round((float)valueAux0/2.55)); quietReply=true; } else
 #endif
@@ -959,9 +1002,11 @@ void processCommands() {
 //  :GZ#   Get telescope azimuth
 //         Returns: DDD*MM# or DDD*MM'SS# (based on precision setting)
       if (command[1] == 'Z')  { getHor(&f,&f1); f1=degRange(f1); if (!doubleToDms(reply,&f1,true,false)) commandError=true; else quietReply=true; } else commandError=true;
-      } else
+      } else commandError=true;
+      break;
 
 //  h - Home Position Commands
+    case 'h':
       if (command[0] == 'h') {
 //  :hF#   Reset telescope at the home position.  This position is required for a Cold Start.
 //         Point to the celestial pole with the counterweight pointing downwards (CWD position).
@@ -1008,9 +1053,11 @@ void processCommands() {
       if (command[1] == 'R')  { if (!unPark(true)) commandError=true; }
       else commandError=true;
 
-      } else
+      } else commandError=true;
+      break;
 
 //   L - Object Library Commands
+    case 'L':
       if (command[0] == 'L') {
 
 // :LB#    Find previous object and set it as the current target object.
@@ -1164,9 +1211,11 @@ void processCommands() {
         } else commandError=true;
       } else commandError=true;
         
-      } else
+      } else commandError=true;
+      break;
 
 //   M - Telescope Movement Commands
+    case 'M':
       if (command[0] == 'M') {
 //  :MA#   Goto the target Alt and Az
 //         Returns: 0..9, see :MS#
@@ -1261,51 +1310,12 @@ void processCommands() {
         supress_frame=true; 
       } else commandError=true;
       
-      } else
-//   $Q - PEC Control
-//  :$QZ+  Enable RA PEC compensation 
-//         Returns: nothing
-//  :$QZ-  Disable RA PEC Compensation
-//         Returns: nothing
-//  :$QZZ  Clear the PEC data buffer
-//         Return: Nothing
-//  :$QZ/  Ready Record PEC
-//         Returns: nothing
-//  :$QZ!  Write PEC data to EEPROM
-//         Returns: nothing
-//  :$QZ?  Get PEC status
-//         Returns: S#
-      if ((command[0] == '$') && (command[1] == 'Q')) {
-        if ((parameter[2] == 0) && (parameter[0] == 'Z')) {
-          quietReply=true; 
-#if MOUNT_TYPE != ALTAZM
-          if (parameter[1] == '+') { if (pecRecorded) pecStatus=ReadyPlayPEC; nv.update(EE_pecStatus,pecStatus); } else
-          if (parameter[1] == '-') { pecStatus=IgnorePEC; nv.update(EE_pecStatus,pecStatus); } else
-          if ((parameter[1] == '/') && (trackingState == TrackingSidereal)) { pecStatus=ReadyRecordPEC; nv.update(EE_pecStatus,IgnorePEC); } else
-          if (parameter[1] == 'Z') { 
-            for (i=0; i<pecBufferSize; i++) pecBuffer[i]=128;
-            pecFirstRecord = true;
-            pecStatus      = IgnorePEC;
-            pecRecorded    = false;
-            nv.update(EE_pecStatus,pecStatus);
-            nv.update(EE_pecRecorded,pecRecorded);
-          } else
-          if (parameter[1] == '!') {
-            pecRecorded=true;
-            nv.update(EE_pecRecorded,pecRecorded);
-            nv.writeLong(EE_wormSensePos,wormSensePos);
-            // trigger recording of PEC buffer
-            pecAutoRecord=pecBufferSize;
-          } else
-#endif
-          // Status is one of "IpPrR" (I)gnore, get ready to (p)lay, (P)laying, get ready to (r)ecord, (R)ecording.  Or an optional (.) to indicate an index detect.
-          if (parameter[1] == '?') { const char *pecStatusCh = PECStatusString; reply[0]=pecStatusCh[pecStatus]; reply[1]=0; reply[2]=0; if (wormSensedAgain) { reply[1]='.'; wormSensedAgain=false; } } else { quietReply=false; commandError=true; }
-        } else commandError=true;
-      } else
-
+      } else commandError=true;
+      break;
 //   Q - Movement Commands
 //  :Q#    Halt all slews, stops goto
 //         Returns: Nothing
+    case 'Q':
       if (command[0] == 'Q') {
         if (command[1] == 0) {
           stopMount();
@@ -1323,9 +1333,11 @@ void processCommands() {
           stopGuideAxis2();
           quietReply=true;
         } else commandError=true;
-      } else
+      } else commandError=true;
+      break;
 
 //   R - Slew Rate Commands
+    case 'R':
       if (command[0] == 'R') {
 
 //   :RAdd.d#   Set Axis1 Guide rate to dd.d degrees per second
@@ -1369,10 +1381,12 @@ void processCommands() {
         setGuideRate(i);
         quietReply=true; 
       } else commandError=true;
-     } else
+     } else commandError=true;
+      break;
 
 #if ROTATOR == ON
 //   r - Rotator/De-rotator Commands
+    case 'r':
       if (command[0] == 'r') {
 #if MOUNT_TYPE == ALTAZM
 //  :r+#   Enable derotator
@@ -1428,10 +1442,12 @@ void processCommands() {
         if (!dmsToDouble(&f1,&parameter[i1],true)) commandError=true; else rot.setTarget(f*f1);
         highPrecision=i;
       } else commandError=true;
-     } else
+     } else commandError=true;
+      break;
 #endif
 
 //   S - Telescope Set Commands
+    case 'S':
       if (command[0] == 'S') {
 //  :SasDD*MM#
 //         Set target object altitude to sDD*MM# or sDD*MM'SS# (based on precision setting)
@@ -1445,29 +1461,20 @@ void processCommands() {
         i=(int)(parameter[0]-'0');
         if ((i >= 0) && (i < 10)) {
           if (process_command == COMMAND_SERIAL_A) {
-            SerialA.print("1"); 
-            #ifdef HAL_SERIAL_TRANSMIT
-            while (SerialA.transmit()); 
-            #endif
+            SerialA.print("1"); SerialA.flush();
             delay(50); SerialA.begin(baudRate[i]);
             quietReply=true; 
 #ifdef HAL_SERIAL_B_ENABLED
           } else
           if (process_command == COMMAND_SERIAL_B) {
-            SerialB.print("1"); 
-            #ifdef HAL_SERIAL_TRANSMIT
-            while (SerialB.transmit()); 
-            #endif
+            SerialB.print("1"); SerialB.flush();
             delay(50); SerialB.begin(baudRate[i]); 
             quietReply=true;
 #endif
 #if defined(HAL_SERIAL_C_ENABLED) && !defined(HAL_SERIAL_C_BLUETOOTH)
           } else
           if (process_command == COMMAND_SERIAL_C) {
-            SerialC.print("1"); 
-            #ifdef HAL_SERIAL_TRANSMIT
-            while (SerialC.transmit()); 
-            #endif
+            SerialC.print("1"); SerialC.flush();
             delay(50); SerialC.begin(baudRate[i]);
             quietReply=true; 
 #endif
@@ -1636,10 +1643,13 @@ void processCommands() {
 //  :SXnn,VVVVVV...#   Set OnStep value
 //          Return: 0 on failure
 //                  1 on success
+//  :SXB2,n#   Push a binary telemetry frame (as :GXB1#) every n/100 seconds (10 to 6000) on this channel, 0 to stop
+//          Only one channel streams at a time and it must be enabled with :GXB0# first, it stops when binary telemetry is dropped
       if (command[1] == 'X')  {
         if (parameter[2] != ',') { parameter[0]=0; commandError=true; }                      // make sure command format is correct
         if (parameter[0] == '0') { // 0n: Align Model
           static int star;
+          if ((parameter[1] >= 'A') && (parameter[1] <= 'E') && (star >= ALIGN_MAX_STORED)) commandError=true; else
           switch (parameter[1]) {
             case '0': Align.ax1Cor=(double)strtol(&parameter[3],NULL,10)/3600.0; break;    // ax1Cor
             case '1': Align.ax2Cor=(double)strtol(&parameter[3],NULL,10)/3600.0; break;    // ax2Cor 
@@ -1655,12 +1665,12 @@ void processCommands() {
             case '7': Align.dfCor=(double)strtol(&parameter[3],NULL,10)/3600.0; break;     // dfCor
 #endif
             case '8': Align.tfCor=(double)strtol(&parameter[3],NULL,10)/3600.0; break;     // tfCor
-            case '9': { i=strtol(&parameter[3],NULL,10); if (i == 1) { alignNumStars=star; alignThisStar=star+1; Align.model(star); } else star=0; } break; // use 0 to start upload of stars for align, use 1 to trigger align
+            case '9': { i=strtol(&parameter[3],NULL,10); if (i == 1) { alignNumStars=star; alignThisStar=star+1; Align.model(star); } else { star=0; Align.clearNormal(); } } break; // use 0 to start upload of stars for align, use 1 to trigger align
             case 'A': { i=highPrecision; highPrecision=true; if (!hmsToDouble(&Align.actual[star].ha,&parameter[3])) commandError=true; else Align.actual[star].ha=(Align.actual[star].ha*15.0)/Rad; highPrecision=i; } break; // Star  #n HA
             case 'B': { i=highPrecision; highPrecision=true; if (!dmsToDouble(&Align.actual[star].dec,&parameter[3],true)) commandError=true; else Align.actual[star].dec=Align.actual[star].dec/Rad; highPrecision=i; } break; // Star  #n Dec
             case 'C': { i=highPrecision; highPrecision=true; if (!hmsToDouble(&Align.mount[star].ha,&parameter[3])) commandError=true; else Align.mount[star].ha=(Align.mount[star].ha*15.0)/Rad; highPrecision=i; } break; // Mount  #n HA
             case 'D': { i=highPrecision; highPrecision=true; if (!dmsToDouble(&Align.mount[star].dec,&parameter[3],true)) commandError=true; else Align.mount[star].dec=Align.mount[star].dec/Rad; highPrecision=i; } break; // Star  #n Dec
-            case 'E': Align.actual[star].side=Align.mount[star].side=strtol(&parameter[3],NULL,10); star++; break; // Mount PierSide (and increment n)
+            case 'E': Align.actual[star].side=Align.mount[star].side=strtol(&parameter[3],NULL,10); Align.addNormal(&Align.mount[star],&Align.actual[star]); star++; break; // Mount PierSide (and increment n)
             default:  commandError=true;
           }
         } else
@@ -1758,6 +1768,13 @@ void processCommands() {
             default: commandError=true;
           }
         } else
+        if (parameter[0] == 'B') { // Bn: Binary telemetry
+          if ((parameter[1] == '2') && bitRead(binaryChannels,process_command)) {
+            long v=strtol(&parameter[3],NULL,10);
+            if (v == 0) { if (telemetryChannel == process_command) telemetryChannel=COMMAND_NONE; } else
+            if ((v >= 10) && (v <= 6000)) { telemetryChannel=process_command; telemetryPeriod=v; } else commandError=true;
+          } else commandError=true;
+        } else
 #if MOUNT_TYPE == GEM
         if (parameter[0] == 'E') { // En: Simple value
           switch (parameter[1]) {
@@ -1846,7 +1863,8 @@ void processCommands() {
 //          Return: 0 on failure
 //                  1 on success
       if (command[1] == 'z')  { if (!dmsToDouble(&newTargetAzm,parameter,false)) commandError=true; } else commandError=true;
-      } else 
+      } else commandError=true;
+      break;
 //   T - Tracking Commands
 //
 //  :T+#   Master sidereal clock faster by 0.02 Hertz (stored in EEPROM)
@@ -1868,6 +1886,7 @@ void processCommands() {
 //         Return: 0 on failure
 //                 1 on success
 
+    case 'T':
       if ((command[0] == 'T') && (parameter[0] == 0)) {
 #if MOUNT_TYPE != ALTAZM
         static bool dualAxis=false;
@@ -1906,14 +1925,17 @@ void processCommands() {
 
       } else
       if (command[0] == 'T') {
-      } else
+      } else commandError=true;
+      break;
      
 //   U - Precision Toggle
 //  :U#    Toggle between low/hi precision positions
 //         Low -  RA/Dec/etc. displays and accepts HH:MM.M sDD*MM
 //         High - RA/Dec/etc. displays and accepts HH:MM:SS sDD*MM:SS
 //         Returns Nothing
-      if ((command[0] == 'U') && (command[1] == 0)) { highPrecision=!highPrecision; quietReply=true; } else
+    case 'U':
+      if ((command[0] == 'U') && (command[1] == 0)) { highPrecision=!highPrecision; quietReply=true; } else commandError=true;
+      break;
 
 #if MOUNT_TYPE != ALTAZM
 //   V - PEC Readout
@@ -1921,16 +1943,18 @@ void processCommands() {
 //         Read out RA PEC Table Entry
 //         Returns: sDDD#
 //         Rate Adjustment factor for worm segment NNNN. PecRate = Steps +/- for this 1 second segment
+//         (with PEC_HIRES_ON a segment is one bin, PecRate = Steps +/- for the bin)
 //         If NNNN is omitted, returns the currently playing segment
+    case 'V':
       if ((command[0] == 'V') && (command[1] == 'R')) {
         boolean conv_result=true;
         if (parameter[0] == 0) { i=pecIndex1; } else conv_result=atoi2(parameter,&i);
         if ((conv_result) && ((i >= 0) && (i < pecBufferSize))) {
           if (parameter[0] == 0) {
-            i-=1; if (i < 0) i+=SecondsPerWormRotationAxis1; if (i >= SecondsPerWormRotationAxis1) i-=SecondsPerWormRotationAxis1;
-            i1=pecBuffer[i]-128; sprintf(reply,"%+04i,%03i",i1,i);
+            i-=PEC_BINS; if (i < 0) i+=PecBinsPerWormRotationAxis1; if (i >= PecBinsPerWormRotationAxis1) i-=PecBinsPerWormRotationAxis1;
+            i1=pecGet(i); sprintf(reply,"%+04i,%03i",i1,i);
           } else {
-            i1=pecBuffer[i]-128; sprintf(reply,"%+04i",i1);
+            i1=pecGet(i); sprintf(reply,"%+04i",i1);
           }
         } else commandError=true;
         quietReply=true;
@@ -1939,16 +1963,20 @@ void processCommands() {
 //         Read out RA PEC ten byte frame in hex format starting at worm segment NNNN
 //         Returns: x0x1x2x3x4x5x6x7x8x9#
 //         Rate Adjustment factor for worm segments. PecRate = Steps +/- for each 1 second segment, hex one byte integer (PecRate=b-128)
+//         (with PEC_HIRES_ON each bin is a hex two byte integer, PecRate=(int16_t)w)
 //         leave a delay of about 10ms between calls
       if ((command[0] == 'V') && (command[1] == 'r')) {
         if ( (atoi2(parameter,&i)) && ((i >= 0) && (i < pecBufferSize))) {
           int j=0;
-          byte b;
-          char x[3]="  ";
+          int v;
+          char x[5]="    ";
           for (j=0; j < 10; j++) {
-            if (i+j < pecBufferSize) b=pecBuffer[i+j]; else b=128;
-           
-            sprintf(x,"%02X",b);
+            if (i+j < pecBufferSize) v=pecGet(i+j); else v=0;
+#ifdef PEC_HIRES_ON
+            sprintf(x,"%04X",(uint16_t)v);
+#else
+            sprintf(x,"%02X",(byte)(v+128));
+#endif
             strcat(reply,x);
           }
         } else commandError=true;
@@ -1992,8 +2020,13 @@ void processCommands() {
       if ((command[0] == 'V') && (command[1] == 'I')) {
         sprintf(reply,"%06ld",0L);  // indexWorm_record
         quietReply=true;
-      } else
+      } else commandError=true;
+      break;
+
+#endif
 
+    case 'W':
+#if MOUNT_TYPE != ALTAZM
 //  :WIDDDDDD#
 //         Write RA PEC index start (steps)
       if ((command[0] == 'W') && (command[1] == 'I')) {
@@ -2013,31 +2046,38 @@ void processCommands() {
 //         Write RA PEC Table Entry
 //         Returns: Nothing
 //         Rate Adjustment factor for worm segment NNNN. PecRate = Steps +/- for this 1 second segment
+//         (with PEC_HIRES_ON a segment is one bin and sDDD can be up to +/-32767)
       if ((command[0] == 'W') && (command[1] == 'R')) { 
         commandError=true;
         if (parameter[1] == 0) {
+          long n=PecBinsPerWormRotationAxis1-1;
           if (parameter[0] == '+') {
-            i=pecBuffer[SecondsPerWormRotationAxis1-1];
-            memmove((byte *)&pecBuffer[1],(byte *)&pecBuffer[0],SecondsPerWormRotationAxis1-1);
-            pecBuffer[0]=i;
+            for (int k=0; k < PEC_BINS; k++) {
+              i=pecGet(n);
+              memmove((byte *)&pecBuffer[1],(byte *)&pecBuffer[0],n*sizeof(*pecBuffer));
+              pecSet(0,i);
+            }
             commandError=false;
           } else
           if (parameter[0] == '-') {
-            i=pecBuffer[0];
-            memmove((byte *)&pecBuffer[0],(byte *)&pecBuffer[1],SecondsPerWormRotationAxis1-1);
-            pecBuffer[SecondsPerWormRotationAxis1-1]=i;
+            for (int k=0; k < PEC_BINS; k++) {
+              i=pecGet(0);
+              memmove((byte *)&pecBuffer[0],(byte *)&pecBuffer[1],n*sizeof(*pecBuffer));
+              pecSet(n,i);
+            }
             commandError=false;
           }
         } else {
           // it should be an int
           // see if it converted and is in range
           i=atoi(parameter);
-          if ((i >= 0) && (i < pecBufferSize)) {
+          char *conv_comma=strchr(parameter,',');
+          if ((i >= 0) && (i < pecBufferSize) && (conv_comma != NULL)) {
             // should be another int here
             // see if it converted and is in range
-            i2=atoi((char*)&parameter[5]);
-            if ((i2 >= -128) && (i2 <= 127)) {
-              pecBuffer[i]=i2+128;
+            i2=atoi(&conv_comma[1]);
+            if ((i2 >= -PEC_MAX-1) && (i2 <= PEC_MAX)) {
+              pecSet(i,i2);
               pecRecorded =true;
               commandError=false;
             }
@@ -2072,9 +2112,16 @@ void processCommands() {
           sprintf(reply,"%i",currentSite);
         } else
           commandError=true;
-      } else 
-        commandError=true;
-      
+      } else commandError=true;
+      break;
+
+    default:
+      commandError=true;
+      }
+
+      // binary frames carry their own length and CRC so go out as-is, without checksum or '#'
+      if (binaryLength > 0) { binaryWrite(process_command,reply,binaryLength); quietReply=false; return; }
+
       if (!quietReply) {
         if (commandError) reply[0]='0'; else reply[0]='1';
         reply[1]=0;
@@ -2138,6 +2185,177 @@ void processCommands() {
    }
 }
 
+// bit packed telescope status for :Gu# and the binary telemetry frame, s must hold 10 chars
+void statusBits(char *s) {
+  memset(s,(char)0b10000000,9);
+  if ((trackingState != TrackingSidereal) || trackingSyncInProgress()) s[0]|=0b10000001; // Not tracking
+  if ((trackingState != TrackingMoveTo) && !trackingSyncInProgress())  s[0]|=0b10000010; // No goto
+  if (PPSsynced)                               s[0]|=0b10000100;                       // PPS sync
+  if ((guideDirAxis1) || (guideDirAxis2))      s[0]|=0b10001000;                       // Guide active
+#if MOUNT_TYPE != ALTAZM
+  if (rateCompensation == RC_REFR_RA)            s[0]|=0b11010000;                       // Refr enabled Single axis
+  if (rateCompensation == RC_REFR_BOTH)          s[0]|=0b10010000;                       // Refr enabled
+  if (rateCompensation == RC_FULL_RA)            s[0]|=0b11100000;                       // OnTrack enabled Single axis
+  if (rateCompensation == RC_FULL_BOTH)          s[0]|=0b10100000;                       // OnTrack enabled
+#endif
+  if (rateCompensation == RC_NONE) {
+    double tr=getTrackingRate60Hz();
+    if (abs(tr-57.900)<0.001)                  s[1]|=0b10000001; else                  // Lunar rate selected
+    if (abs(tr-60.000)<0.001)                  s[1]|=0b10000010; else                  // Solar rate selected
+    if (abs(tr-60.136)<0.001)                  s[1]|=0b10000011;                       // King rate selected
+  }
+
+  if (atHome)                                  s[2]|=0b10000001;                       // At home
+  if (waitingHome)                             s[2]|=0b10000010;                       // Waiting at home
+  if (pauseHome)                               s[2]|=0b10000100;                       // Pause at home enabled?
+  if (soundEnabled)                            s[2]|=0b10001000;                       // Buzzer enabled?
+#if MOUNT_TYPE == GEM
+  if (autoMeridianFlip)                        s[2]|=0b10010000;                       // Auto meridian flip
+#endif
+  if (pecRecorded)                             s[2]|=0b10100000;                       // PEC data has been recorded
+
+  // provide mount type
+#if MOUNT_TYPE == GEM
+                                               s[3]|=0b10000001;                       // GEM
+#elif MOUNT_TYPE == FORK
+                                               s[3]|=0b10000010;                       // FORK
+#elif MOUNT_TYPE == ALTAZM
+                                               s[3]|=0b10001000;                       // ALTAZM
+#endif
+
+  // provide pier side info.
+  if (getInstrPierSide() == PierSideNone)        s[3]|=0b10010000; else                  // Pier side none
+  if (getInstrPierSide() == PierSideEast)        s[3]|=0b10100000; else                  // Pier side east
+  if (getInstrPierSide() == PierSideWest)        s[3]|=0b11000000;                       // Pier side west
+
+#if MOUNT_TYPE != ALTAZM
+  s[4]=pecStatus|0b10000000;                                                           // PEC status: 0 ignore, 1 get ready to play, 2 playing, 3 get ready to record, 4 recording
+#endif
+  s[5]=parkStatus|0b10000000;                                                          // Park status: 0 not parked, 1 parking in-progress, 2 parked, 3 park failed
+  s[6]=getPulseGuideRate()|0b10000000;                                                 // Pulse-guide rate
+  s[7]=getGuideRate()|0b10000000;                                                      // Guide rate
+  s[8]=lastError|0b10000000;                                                           // Last error
+  s[9]=0;
+}
+
+// mount state for :GXS0#, the step positions and sidereal clock are sampled together and everything else is worked out from them
+//   RA,Dec,Alt,Azm,LST,UTC time,pier side,:Gu# status (9 bytes) for example 12:34:56,+45*12:34,+60*00:00,123*45:00,01:23:45,05:06:07,1,<status>
+void mountSnapshot(char *s) {
+  long a1,a2,t;
+  cli(); a1=posAxis1; a2=posAxis2; t=lst; sei();
+  a1+=indexAxis1Steps; a2+=indexAxis2Steps;
+
+  coordCacheCheck(a1,a2);
+  coordCacheEqu(a1,a2);
+  coordCacheHor();
+
+  double st=((t % 8640000L)/8640000.0)*24.0;
+  double r=degRange(st*15.0-coordCache.ha), d=coordCache.dec;
+#if TELESCOPE_COORDINATES == TOPOCENTRIC
+  observedPlaceToTopocentric(&r,&d);
+#endif
+  double ut=timeRange(UT1_start+(((t-lst_start)/100.0)/1.00273790935)/3600.0);
+
+  // the fixed width fields are always high precision
+  boolean hp=highPrecision; highPrecision=true;
+  r/=15.0; doubleToHms(s,&r,true); strcat(s,",");
+  doubleToDms(&s[strlen(s)],&d,false,true); strcat(s,",");
+  doubleToDms(&s[strlen(s)],&coordCache.alt,false,true); strcat(s,",");
+  doubleToDms(&s[strlen(s)],&coordCache.azm,true,false); strcat(s,",");
+  doubleToHms(&s[strlen(s)],&st,true); strcat(s,",");
+  doubleToHms(&s[strlen(s)],&ut,true); strcat(s,",");
+  highPrecision=hp;
+  int i=strlen(s); s[i++]='0'+stepsToInstrPierSide(a2); s[i++]=',';
+  statusBits(&s[i]);
+}
+
+// the command buffer for a channel, or NULL if it isn't enabled
+cb *commandBuffer(byte channel) {
+  switch (channel) {
+    case COMMAND_SERIAL_A: return &cmdA;
+#ifdef HAL_SERIAL_B_ENABLED
+    case COMMAND_SERIAL_B: return &cmdB;
+#endif
+#ifdef HAL_SERIAL_C_ENABLED
+    case COMMAND_SERIAL_C: return &cmdC;
+#endif
+#if ST4_HAND_CONTROL == ON
+    case COMMAND_SERIAL_ST4: return &cmdST4;
+#endif
+    case COMMAND_SERIAL_X: return &cmdX;
+    default: return NULL;
+  }
+}
+
+// sends a binary frame on SerialA, B, or C
+void binaryWrite(byte channel, const char *s, int n) {
+  if (channel == COMMAND_SERIAL_A) SerialA.write((uint8_t*)s,n);
+#ifdef HAL_SERIAL_B_ENABLED
+  if (channel == COMMAND_SERIAL_B) SerialB.write((uint8_t*)s,n);
+#endif
+#ifdef HAL_SERIAL_C_ENABLED
+  if (channel == COMMAND_SERIAL_C) SerialC.write((uint8_t*)s,n);
+#endif
+}
+
+// called every 1/100 second from loop2(), drops binary telemetry on quiet channels and pushes a telemetry frame when one is due
+void telemetryPoll() {
+  for (int c=COMMAND_SERIAL_A; c <= COMMAND_SERIAL_C; c++) {
+    if (bitRead(binaryChannels,c) && (millis()-binaryLastCommand[c] > BINARY_TIMEOUT_MS)) {
+      bitClear(binaryChannels,c);
+      if (telemetryChannel == c) telemetryChannel=COMMAND_NONE;
+    }
+  }
+
+  static int count=0;
+  if (telemetryChannel == COMMAND_NONE) { count=0; return; }
+  if (++count < telemetryPeriod) return;
+
+  count=0;
+  char frame[50];
+  int n=telemetryFrame(frame);
+  binaryWrite(telemetryChannel,frame,n);
+}
+
+// little-endian long into s[0..3]
+void putLong(char *s, long v) {
+  unsigned long u=(unsigned long)v;
+  for (int i=0; i < 4; i++) { s[i]=(char)(u & 0xFF); u>>=8; }
+}
+
+// binary telemetry frame for :GXB1#, returns its length (42 bytes)
+//   STX (0x02), payload length (37), type (1), payload, CRC-16/CCITT of length..payload (little-endian)
+//   payload (little-endian): axis1 steps, axis2 steps, lst (0.01s), RA (0.01"), Dec (0.01"), axis1 rate (mHz), axis2 rate (mHz), :Gu# status (9 bytes)
+int telemetryFrame(char *s) {
+  long a1,a2,t;
+  cli(); a1=posAxis1; a2=posAxis2; t=lst; sei();
+  a1+=indexAxis1Steps; a2+=indexAxis2Steps;
+
+  // RA/Dec for the same steps and lst as the rest of the frame
+  coordCacheCheck(a1,a2);
+  coordCacheEqu(a1,a2);
+  double st=((t % 8640000L)/8640000.0)*24.0;
+  double r=degRange(st*15.0-coordCache.ha), d=coordCache.dec;
+#if TELESCOPE_COORDINATES == TOPOCENTRIC
+  observedPlaceToTopocentric(&r,&d);
+#endif
+
+  int n=3;
+  putLong(&s[n],a1); n+=4;
+  putLong(&s[n],a2); n+=4;
+  putLong(&s[n],t); n+=4;
+  putLong(&s[n],(long)round(r*360000.0)); n+=4;
+  putLong(&s[n],(long)round(d*360000.0)); n+=4;
+  putLong(&s[n],(long)round(getFrequencyHzAxis1()*1000.0)); n+=4;
+  putLong(&s[n],(long)round(getFrequencyHzAxis2()*1000.0)); n+=4;
+  statusBits(&s[n]); n+=9;
+
+  s[0]=(char)0x02; s[1]=(char)(n-3); s[2]=(char)1;
+  uint16_t crc=crc16((byte*)&s[1],n-1);
+  s[n++]=(char)(crc & 0xFF); s[n++]=(char)(crc>>8);
+  return n;
+}
+
 void stopMount() {
   if ((parkStatus == NotParked) || (parkStatus == Parking)) {
     stopGuideAxis1();
@@ -158,13 +158,23 @@
 
 #define EE_sites                   100
 
-// PEC table: 200...pecBufferSize+199
+// PEC table: 200...pecTableBytes+199
 // pecBufferSize table of byte sized integers -128..+127, units are steps
+// with PEC_HIRES_ON a delta encoded table of 16 bit integers, the space for it is the most it can encode to (PEC_HIRES_NV_BYTES)
 
 #define EE_pecTable                200
 
 // Library
-// Catalog storage starts at 200+pecBufferSize and ends at E2END-100
+// Catalog storage starts at 200+pecTableBytes and ends just before the journal
+// NOTE: the start moves with the PEC table size, turning PEC_HIRES_ON on or off or changing PEC_HIRES_BINS or the worm period
+// invalidates the PEC table and moves the library.  The range is saved at EE_libLayout and at startup records saved in
+// another range (or by firmware from before the journal, which ran from 200+pecBufferSize to E2END-100) are moved into
+// the current one, those that don't fit are lost.  There must be room for at least one record (checked when compiling.)
+
+// Journal for frequently written values (NV_JOURNAL_SIZE bytes), just before general purpose storage B
+// it took this space from the end of the catalog, it's erased when catalog records are moved out of it
+#define NV_JOURNAL_SIZE            384
+#define EE_journal                 (GSB-NV_JOURNAL_SIZE)
 
 // General purpose storage B (100 bytes), E2END-99..E2END
 #define GSB                       (E2END-100)
@@ -175,6 +185,7 @@
 #define EE_tcfCoefAxis5            GSB+10  // 4
 #define EE_tcfEnAxis4              GSB+14  // 1
 #define EE_tcfEnAxis5              GSB+15  // 1
+#define EE_libLayout               GSB+16  // 2 + 2 + 2
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 // Unique identifier for the current initialization format for NV, do not change
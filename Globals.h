@@ -72,9 +72,22 @@ volatile long timerRateBacklashAxis2    = 0;
 volatile boolean inbacklashAxis2        = false;
 boolean faultAxis2                      = false;
 
+#if TIMER_FIXED_POINT == ON
+  // timerSupervisor() works from fixed point copies of the tracking, PEC (Q8.24) and guide (Q16.16) rates, set along with them
+  #define toQ16(x) ((long)((x)*65536.0))
+  #define toQ24(x) ((long)((x)*16777216.0))
+  #define TIMER_RATE_Q(x) x
+#else
+  #define TIMER_RATE_Q(x)
+#endif
+
 #define default_tracking_rate 1
 volatile double trackingTimerRateAxis1  = default_tracking_rate;
 volatile double trackingTimerRateAxis2  = default_tracking_rate;
+#if TIMER_FIXED_POINT == ON
+volatile long trackingTimerRateAxis1Q   = toQ24(default_tracking_rate);
+volatile long trackingTimerRateAxis2Q   = toQ24(default_tracking_rate);
+#endif
 volatile double timerRateRatio          = ((double)AXIS1_STEPS_PER_DEGREE/(double)AXIS2_STEPS_PER_DEGREE);
 volatile boolean useTimerRateRatio      = (AXIS1_STEPS_PER_DEGREE != AXIS2_STEPS_PER_DEGREE);
 #define StepsPerSecondAxis1               ((double)AXIS1_STEPS_PER_DEGREE/240.0)
@@ -84,8 +97,16 @@ volatile boolean useTimerRateRatio      = (AXIS1_STEPS_PER_DEGREE != AXIS2_STEPS
 #define BreakDistAxis1                    (2L)
 #define BreakDistAxis2                    (2L)
 long SecondsPerWormRotationAxis1        = ((double)AXIS1_STEPS_PER_WORMROT/StepsPerSecondAxis1);
+#define StepsPerPecBinAxis1               (StepsPerSecondAxis1/PEC_BINS)
+long PecBinsPerWormRotationAxis1        = ((double)AXIS1_STEPS_PER_WORMROT/StepsPerPecBinAxis1);
 volatile double StepsForRateChangeAxis1 = (sqrt((double)SLEW_ACCELERATION_DIST*(double)AXIS1_STEPS_PER_DEGREE))*(double)MaxRate*16.0;
 volatile double StepsForRateChangeAxis2 = (sqrt((double)SLEW_ACCELERATION_DIST*(double)AXIS2_STEPS_PER_DEGREE))*(double)MaxRate*16.0;
+#if TIMER_RATE_TABLE == ON
+  typedef struct {
+    long interval;                                           // < 0 when the direction is reversed, 0 when stopped (not in the table)
+    long preset;                                             // the interval adjusted by PPSrateRatio, as passed to PresetTimerInterval()
+  } rateTableEntry_t;                                        // Axis1 rate table entry, see Timer.ino
+#endif
 
 // Basic stepper driver mode setup -------------------------------------------------------------------------------------------------
 #if AXIS1_DRIVER_MODEL != OFF
@@ -164,6 +185,13 @@ long origTargetAxis2                    = 0;
   #define stepAxis2 1
 #endif
 
+#ifdef SLEW_PLANNER
+long   rampStepsAxis1                   = 1;                 // the current goto segment's ramp length in steps, see slewProfilePlan()
+long   rampStepsAxis2                   = 1;
+double peakAxis1                        = 1.0;               // and its peak velocity as a fraction of the slew rate
+double peakAxis2                        = 1.0;
+#endif
+
 double newTargetAlt=0.0, newTargetAzm   = 0.0;               // holds the altitude and azmiuth for slews
 long   degreesPastMeridianE             = 15;                // east of pier.  How far past the meridian before we do a flip.
 long   degreesPastMeridianW             = 15;                // west of pier.  Mount stops tracking when it hits the this limit.
@@ -174,6 +202,20 @@ bool   autoMeridianFlip                 = false;             // auto meridian fl
 double currentAlt                       = 45.0;              // the current altitude
 double currentDec                       = 0.0;               // the current declination
 
+typedef struct {                                             // the current position, see coordCacheCheck() in Goto.ino
+  long axis1;                                                // posAxis1+indexAxis1Steps
+  long axis2;                                                // posAxis2+indexAxis2Steps
+  boolean atHome;
+  double coe[9];                                             // the pointing model coefficients and latitude
+  boolean equValid;
+  boolean horValid;
+  boolean approxValid;
+  double ha, dec;                                            // getEqu()
+  double alt, azm;                                           // getHor()
+  double approxHa, approxDec;                                // getApproxEqu()
+} coordCache_t;
+coordCache_t coordCache = { 0, 0, false, { 0 }, false, false, false, 0, 0, 0, 0, 0, 0 };
+
 // Stepper driver enable/disable and direction -------------------------------------------------------------------------------------
 
 #define defaultDirAxis2EInit              1
@@ -253,6 +295,10 @@ unsigned long baudRate[10] = {115200,56700,38400,28800,19200,14400,9600,4800,240
 #define RateToXPerSec                     (RateToASPerSec/15.0)
 double  slewRateX                       = (RateToXPerSec/MaxRate)*2.5;
 double  accXPerSec                      = (slewRateX/SLEW_ACCELERATION_DIST);
+#if TIMER_FIXED_POINT == ON
+long    accXPerCsQ16                    = (long)((accXPerSec/100.0)*65536.0); // accXPerSec/100, Q16.16
+unsigned long slewRateXInvSqrtQ16       = (unsigned long)(65536.0/sqrt(slewRateX)); // 1/sqrt(slewRateX), Q16.16
+#endif
 double  guideRates[10]={3.75,7.5,15,30,60,120,300,720,(RateToASPerSec/MaxRate)/2.0,RateToASPerSec/MaxRate};
 //                      .25X .5x 1x 2x 4x  8x 20x 48x       half-MaxRate                   MaxRate
 //                         0   1  2  3  4   5   6   7                  8                         9
@@ -268,6 +314,10 @@ char          ST4DirAxis2               = 'b';
 
 volatile double guideTimerRateAxis1     = 0.0;
 volatile double guideTimerRateAxis2     = 0.0;
+#if TIMER_FIXED_POINT == ON
+volatile long guideTimerRateAxis1Q      = 0;
+volatile long guideTimerRateAxis2Q      = 0;
+#endif
 volatile double guideTimerBaseRateAxis1 = 0.0;
 volatile double guideTimerBaseRateAxis2 = 0.0;
 fixed_t amountGuideAxis1;
@@ -287,19 +337,43 @@ byte    pecStatus                       = IgnorePEC;
 boolean pecRecorded                     = false;
 boolean pecFirstRecord                  = false;
 long    lastPecIndex                    = -1;
-int     pecBufferSize                   = PEC_BUFFER_SIZE;
+int     pecBufferSize                   = PEC_BUFFER_SIZE*PEC_BINS;   // in bins
+#ifdef PEC_HIRES_ON
+#define PEC_MAX                           32767              // largest correction, in steps per bin
+#else
+#define PEC_MAX                           127
+#endif
+#ifdef PEC_HIRES_ON
+// the most the table encodes to (see pecEncode), 6 byte header, a nibble a bin, and 2 more bytes for a full value in one bin of eight
+#define PEC_HIRES_NV_BYTES(bins)          (6L+((long)(bins)*3L+3L)/4L)
+#define PEC_TABLE_BYTES                   PEC_HIRES_NV_BYTES((long)PEC_BUFFER_SIZE*PEC_BINS)
+#else
+#define PEC_TABLE_BYTES                   ((long)PEC_BUFFER_SIZE)
+#endif
+int     pecTableBytes                   = PEC_TABLE_BYTES;   // NV space for the table
 long    pecIndex                        = 0;
 long    pecIndex1                       = 0;
 int     pecAnalogValue                  = 0;
-int     pecAutoRecord                   = 0;                 // for writing to PEC table to EEPROM
+int     pecAutoRecord                   = 0;                 // bytes of the PEC table still to be written to EEPROM
+boolean pecSaveSlewed                   = false;             // the last save had to slew some bins (PEC_HIRES_ON,) NV differs from RAM
 long    wormSensePos                    = 0;                 // in steps
 boolean wormSensedAgain                 = false;             // indicates PEC index was found
 int     LastPecPinState                 = PEC_SENSE_STATE;                         
 boolean pecBufferStart                  = false;                                   
 fixed_t accPecGuideHA;                                       // for PEC, buffers steps to be recorded
 volatile double pecTimerRateAxis1 = 0.0;
+#if TIMER_FIXED_POINT == ON
+volatile long pecTimerRateAxis1Q = 0;
+#endif
+volatile int pecStepsAxis1 = 0;                             // the same PEC correction in steps per second, -127 to +127 (or more with PEC_HIRES_ON)
 #if MOUNT_TYPE != ALTAZM
-  static byte *pecBuffer;
+  #ifdef PEC_HIRES_ON
+  #define PEC_BUFFER_TYPE int16_t                            // steps per bin
+  #else
+  #define PEC_BUFFER_TYPE byte                               // steps per second+128
+  #endif
+  static PEC_BUFFER_TYPE *pecBuffer;
+  static byte *pecShadow;                                    // copy of pecBuffer being written to EEPROM, NULL if there's no RAM for it
 #endif
 
 // Misc ----------------------------------------------------------------------------------------------------------------------------
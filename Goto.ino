@@ -142,29 +142,64 @@ int getEnc(double *EncAxis1, double *EncAxis2) {
   return 0;
 }
 
-// gets the telescopes current RA and Dec, set returnHA to true for Horizon Angle instead of RA
-boolean getEqu(double *RA, double *Dec, boolean returnHA) {
-  double HA;
- 
+// the current position is kept with the pointing model applied until the mount moves a step or the index, pointing model or site
+// changes, so :GR#, :GD#, :GA# and :GZ# polled together (or from several channels) only work it out once.  RA is always from the
+// current LST (coordCache is in Globals.h)
+
+// clears the cached coordinates unless they are still current for step positions a1 and a2 (with index)
+void coordCacheCheck(long a1, long a2) {
+  double coe[9]={ Align.ax1Cor, Align.ax2Cor, Align.altCor, Align.azmCor, Align.doCor, Align.pdCor, Align.dfCor, Align.tfCor, latitude };
+  if ((a1 == coordCache.axis1) && (a2 == coordCache.axis2) && (atHome == coordCache.atHome) && (memcmp(coe,coordCache.coe,sizeof(coe)) == 0)) return;
+  coordCache.axis1=a1; coordCache.axis2=a2; coordCache.atHome=atHome; memcpy(coordCache.coe,coe,sizeof(coe));
+  coordCache.equValid=false; coordCache.horValid=false; coordCache.approxValid=false;
+}
+
+// gets the current step positions (with index) and clears the cached coordinates unless they are still current
+void coordCacheUpdate(long *a1, long *a2) {
+  cli(); *a1=posAxis1; *a2=posAxis2; sei();
+  *a1+=indexAxis1Steps; *a2+=indexAxis2Steps;
+  coordCacheCheck(*a1,*a2);
+}
+
+// works out the cached HA and Dec (pointing model applied) for step positions a1 and a2 if not already done
+void coordCacheEqu(long a1, long a2) {
+  if (coordCache.equValid) return;
+  double HA,Dec;
 #if MOUNT_TYPE != ALTAZM
-  HA=getInstrAxis1();
-  *Dec=getInstrAxis2();
+  HA=stepsToInstrAxis1(a1,a2);
+  Dec=stepsToInstrAxis2(a2);
   // apply pointing model
-  Align.instrToEqu(HA,*Dec,&HA,Dec,getInstrPierSide());
+  Align.instrToEqu(HA,Dec,&HA,&Dec,stepsToInstrPierSide(a2));
 #else
-  double Z=getInstrAxis1();
-  double A=getInstrAxis2();
+  double Z=stepsToInstrAxis1(a1,a2);
+  double A=stepsToInstrAxis2(a2);
   // apply pointing model
-  Align.instrToHor(A,Z,&A,&Z,getInstrPierSide());
-  horToEqu(A,Z,&HA,Dec);
+  Align.instrToHor(A,Z,&A,&Z,stepsToInstrPierSide(a2));
+  horToEqu(A,Z,&HA,&Dec);
 #endif
+  coordCache.ha=HA; coordCache.dec=Dec; coordCache.equValid=true;
+}
+
+// works out the cached Alt and Azm from the cached HA and Dec if not already done
+void coordCacheHor() {
+  if (coordCache.horValid) return;
+  equToHor(coordCache.ha,coordCache.dec,&coordCache.alt,&coordCache.azm); coordCache.horValid=true;
+}
+
+// gets the telescopes current RA and Dec, set returnHA to true for Horizon Angle instead of RA
+boolean getEqu(double *RA, double *Dec, boolean returnHA) {
+  long a1,a2;
+
+  coordCacheUpdate(&a1,&a2);
+  coordCacheEqu(a1,a2);
+  *Dec=coordCache.dec;
 
   // return either the RA or the HA depending on returnHA
   if (!returnHA) {
-    *RA=(LST()*15.0-HA);
+    *RA=(LST()*15.0-coordCache.ha);
     while (*RA >= 360.0) *RA-=360.0;
     while (*RA < 0.0) *RA+=360.0;
-  } else *RA=HA;
+  } else *RA=coordCache.ha;
   
   return true;
 }
@@ -172,19 +207,24 @@ boolean getEqu(double *RA, double *Dec, boolean returnHA) {
 // gets the telescopes current RA and Dec, set returnHA to true for Horizon Angle instead of RA
 boolean getApproxEqu(double *RA, double *Dec, boolean returnHA) {
   double HA;
-  
+  long a1,a2;
+
+  coordCacheUpdate(&a1,&a2);
+  if (!coordCache.approxValid) {
 #if MOUNT_TYPE != ALTAZM
-  HA=getInstrAxis1();
-  *Dec=getInstrAxis2();
+    HA=stepsToInstrAxis1(a1,a2);
+    *Dec=stepsToInstrAxis2(a2);
 #else
-  double Z=getInstrAxis1();
-  double A=getInstrAxis2();
-  horToEqu(A,Z,&HA,Dec);
+    double Z=stepsToInstrAxis1(a1,a2);
+    double A=stepsToInstrAxis2(a2);
+    horToEqu(A,Z,&HA,Dec);
 #endif
 
-  HA=haRange(HA);
-  if (*Dec > 90.0) *Dec=+90.0;
-  if (*Dec < -90.0) *Dec=-90.0;
+    HA=haRange(HA);
+    if (*Dec > 90.0) *Dec=+90.0;
+    if (*Dec < -90.0) *Dec=-90.0;
+    coordCache.approxHa=HA; coordCache.approxDec=*Dec; coordCache.approxValid=true;
+  } else { HA=coordCache.approxHa; *Dec=coordCache.approxDec; }
   
   // return either the RA or the HA depending on returnHA
   if (!returnHA) {
@@ -195,9 +235,11 @@ boolean getApproxEqu(double *RA, double *Dec, boolean returnHA) {
 
 // gets the telescopes current Alt and Azm
 boolean getHor(double *Alt, double *Azm) {
-  double h,d;
-  getEqu(&h,&d,true);
-  equToHor(h,d,Alt,Azm);
+  long a1,a2;
+  coordCacheUpdate(&a1,&a2);
+  coordCacheEqu(a1,a2);
+  coordCacheHor();
+  *Alt=coordCache.alt; *Azm=coordCache.azm;
   return true;
 }
 
@@ -376,12 +418,21 @@ GotoErrors goTo(double thisTargetAxis1, double thisTargetAxis2, double altTarget
   int p=PierSideEast; switch (thisPierSide) { case PierSideWest: case PierSideFlipEW1: p=PierSideWest; break; }
   setTargetAxis1(thisTargetAxis1,p);
   setTargetAxis2(thisTargetAxis2,p);
+#ifdef SLEW_PLANNER
+  slewProfilePlan();
+#endif
 
 #if (MFLIP_SKIP_HOME == ON)
   boolean gotoDirect=true;
 #else
   boolean gotoDirect=false;
 #endif
+#ifdef MFLIP_PLANNER_ON
+  // plan the meridian flip now, a direct slew if it's safe and fastest.  pausing at home needs the classic waypoints
+  if (!gotoDirect && ((thisPierSide == PierSideFlipWE1) || (thisPierSide == PierSideFlipEW1))) {
+    if (flipPathPlan(thisPierSide,pauseHome) == 0) gotoDirect=true;
+  }
+#endif
 
   if (!pauseHome && gotoDirect) {
     if (thisPierSide == PierSideFlipWE1) pierSideControl=PierSideEast; else
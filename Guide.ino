@@ -126,6 +126,7 @@ bool startGuideAxis1(char direction, int guideRate, long guideDuration) {
     guideTimeRemainingAxis1=guideDuration*1000L;
     cli();
     if (guideDirAxis1 == 'e') guideTimerRateAxis1=-guideTimerBaseRateAxis1; else guideTimerRateAxis1=guideTimerBaseRateAxis1; 
+    TIMER_RATE_Q(guideTimerRateAxis1Q=toQ16(guideTimerRateAxis1));
     sei();
   } else return false;
   return true;
@@ -149,6 +150,7 @@ bool startGuideAxis2(char direction, int guideRate, long guideDuration, bool abs
     if (guideDirAxis2 == 's') { cli(); guideTimerRateAxis2=-guideTimerBaseRateAxis2; sei(); } 
     if (guideDirAxis2 == 'n') { cli(); guideTimerRateAxis2= guideTimerBaseRateAxis2; sei(); }
     if (!absolute && (getInstrPierSide() == PierSideWest)) { cli(); guideTimerRateAxis2=-guideTimerRateAxis2; sei(); }
+    TIMER_RATE_Q(cli(); guideTimerRateAxis2Q=toQ16(guideTimerRateAxis2); sei());
   } else return false;
   return true;
 }
@@ -175,6 +177,7 @@ bool customGuideRateAxis1(double rate, long guideDuration) {
     cli();
     if (guideDirAxis1 == 'e') guideTimerRateAxis1=-guideTimerBaseRateAxis1;
     if (guideDirAxis1 == 'w') guideTimerRateAxis1=guideTimerBaseRateAxis1; 
+    TIMER_RATE_Q(guideTimerRateAxis1Q=toQ16(guideTimerRateAxis1));
     sei();
   } else return false;
   return true;
@@ -191,6 +194,7 @@ bool customGuideRateAxis2(double rate, long guideDuration) {
     if (guideDirAxis2 == 's') { cli(); guideTimerRateAxis2=-guideTimerBaseRateAxis2; sei(); } 
     if (guideDirAxis2 == 'n') { cli(); guideTimerRateAxis2= guideTimerBaseRateAxis2; sei(); }
     if (getInstrPierSide() == PierSideWest) { cli(); guideTimerRateAxis2=-guideTimerRateAxis2; sei(); }
+    TIMER_RATE_Q(cli(); guideTimerRateAxis2Q=toQ16(guideTimerRateAxis2); sei());
   } else return false;
   return true;
 }
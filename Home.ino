@@ -136,15 +136,15 @@ GotoErrors setHome() {
  
   // not parked, but don't wipe the park position if it's saved - we can still use it
   parkStatus=NotParked;
-  nv.write(EE_parkStatus,parkStatus);
+  nvj.write(EE_parkStatus,parkStatus);
   
   // reset PEC, unless we have an index to recover from this
-  pecRecorded=nv.read(EE_pecRecorded);
+  pecRecorded=nvj.read(EE_pecRecorded);
   #if PEC_SENSE == OFF
     pecStatus=IgnorePEC;
-    nv.write(EE_pecStatus,pecStatus);
+    nvj.write(EE_pecStatus,pecStatus);
   #else
-    pecStatus=nv.read(EE_pecStatus);
+    pecStatus=nvj.read(EE_pecStatus);
   #endif
   if (!pecRecorded) pecStatus=IgnorePEC;
 
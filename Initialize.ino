@@ -86,8 +86,9 @@ void initStartupValues() {
   waitingHomeContinue = false;
 
   // PEC sanity check
-  if ((pecBufferSize < 0) || (pecBufferSize > 3384)) pecBufferSize=0;
-  if (SecondsPerWormRotationAxis1>pecBufferSize) SecondsPerWormRotationAxis1=pecBufferSize;
+  if ((pecBufferSize < 0) || (pecBufferSize > 3384L*PEC_BINS)) pecBufferSize=0;
+  if (PecBinsPerWormRotationAxis1>pecBufferSize) PecBinsPerWormRotationAxis1=pecBufferSize;
+  if (SecondsPerWormRotationAxis1>pecBufferSize/PEC_BINS) SecondsPerWormRotationAxis1=pecBufferSize/PEC_BINS;
 
   // reset tracking and rates
   cli();
@@ -246,6 +247,17 @@ void initPins() {
   StepperModeTrackingInit();
 }
 
+// catalogs saved with another NV layout are moved to where the catalog is now, and a journal in what was catalog space erased
+void initNvLayout() {
+  if (nv.readLong(EE_autoInitKey) != initKey) return;
+  int first, last;
+  if (!Lib.savedRange(&first,&last)) { first=EE_pecTable+(int)PEC_BUFFER_SIZE; last=E2END-100; }
+  if (!Lib.relocate(first,last)) return;
+  if (last >= EE_journal) nvj.clear();
+  // the PEC table's size changed
+  if (first != EE_pecTable+pecTableBytes) { nvj.write(EE_pecStatus,IgnorePEC); nvj.write(EE_pecRecorded,false); }
+}
+
 void initReadNvValues() {
   // get the site information, if a GPS were attached we would use that here instead
   currentSite=nv.read(EE_currentSite); if (currentSite > 3) currentSite=0; // site index is valid?
@@ -303,9 +315,13 @@ void initReadNvValues() {
   
 #if MOUNT_TYPE != ALTAZM
   // get the PEC status
-  pecStatus  =nv.read(EE_pecStatus);
-  pecRecorded=nv.read(EE_pecRecorded); if (!pecRecorded) pecStatus=IgnorePEC;
-  for (int i=0; i < pecBufferSize; i++) pecBuffer[i]=nv.read(EE_pecTable+i);
+  pecStatus  =nvj.read(EE_pecStatus);
+  pecRecorded=nvj.read(EE_pecRecorded); if (!pecRecorded) pecStatus=IgnorePEC;
+  #ifdef PEC_HIRES_ON
+    if (!pecLoad()) { pecRecorded=false; pecStatus=IgnorePEC; }
+  #else
+    for (int i=0; i < pecBufferSize; i++) pecBuffer[i]=nv.read(EE_pecTable+i);
+  #endif
   wormSensePos=nv.readLong(EE_wormSensePos);
   #if PEC_SENSE == OFF
     wormSensePos=0;
@@ -315,9 +331,9 @@ void initReadNvValues() {
 
   // get the Park status
   parkSaved=nv.read(EE_parkSaved);
-  parkStatus=nv.read(EE_parkStatus);
+  parkStatus=nvj.read(EE_parkStatus);
   // tried to park but crashed?
-  if (parkStatus == Parking) { parkStatus=ParkFailed; nv.write(EE_parkStatus,parkStatus); }
+  if (parkStatus == Parking) { parkStatus=ParkFailed; nvj.write(EE_parkStatus,parkStatus); }
 
   // get the pulse-guide rate
   currentPulseGuideRate=nv.read(EE_pulseGuideRate); if (currentPulseGuideRate > GuideRate1x) currentPulseGuideRate=GuideRate1x;
@@ -382,6 +398,9 @@ void initWriteNvValues() {
   if (INIT_KEY) nv.writeLong(EE_autoInitKey,autoInitKey);
   thisAutoInitKey=nv.readLong(EE_autoInitKey);
   if (autoInitKey != thisAutoInitKey) {
+    // erase the journal
+    nvj.clear();
+
     // init the site information, lat/long/tz/name
     nv.write(EE_currentSite,0);
     latitude=0; longitude=0;
@@ -413,15 +432,19 @@ void initWriteNvValues() {
     nv.writeInt(EE_backlashAxis1,0);
   
     // init the PEC status, clear the index and buffer
-    nv.write(EE_pecStatus,IgnorePEC);
-    nv.write(EE_pecRecorded,false);
+    nvj.write(EE_pecStatus,IgnorePEC);
+    nvj.write(EE_pecRecorded,false);
+  #ifdef PEC_HIRES_ON
+    for (int l=0; l < 6; l++) nv.write(EE_pecTable+l,0);
+  #else
     for (int l=0; l < pecBufferSize; l++) nv.write(EE_pecTable+l,128);
+  #endif
     wormSensePos=0;
     nv.writeLong(EE_wormSensePos,wormSensePos);
     
     // init the Park status
     nv.write(EE_parkSaved,false);
-    nv.write(EE_parkStatus,NotParked);
+    nvj.write(EE_parkStatus,NotParked);
   
     // init the pulse-guide rate
     nv.write(EE_pulseGuideRate,GuideRate1x);
@@ -440,8 +463,8 @@ void initWriteNvValues() {
     nv.writeLong(EE_siderealInterval,siderealInterval);
 
     // set default focuser positions at zero
-    nv.writeLong(EE_posAxis4,0L);
-    nv.writeLong(EE_posAxis5,0L);
+    nvj.writeLong(EE_posAxis4,0L);
+    nvj.writeLong(EE_posAxis5,0L);
     // for DC focusers read in the % power
     nv.write(EE_dcPwrAxis4,50);
     nv.write(EE_dcPwrAxis5,50);
@@ -453,6 +476,7 @@ void initWriteNvValues() {
 
     // clear the library/catalogs
     Lib.clearAll();
+    Lib.saveRange();
 
     // finally, stop the init from happening again
     nv.writeLong(EE_autoInitKey,autoInitKey);
@@ -17,45 +17,22 @@ void moveTo() {
     timerRateAxis2=SiderealRate;
     sei();
 
-    // first phase, decide if we should move to 60 deg. HA (4 hours) to get away from the horizon limits or just go straight to the home position
-    if (pierSideControl == PierSideFlipWE1) {
-      if (homePositionAxis1 == 0.0) setTargetAxis1(0.0,PierSideWest); else {
-        if ((currentAlt < 10.0) && (getStartAxis1() > -90.0)) setTargetAxis1(-60.0,PierSideWest); else setTargetAxis1(-homePositionAxis1,PierSideWest);
-      }
-      setTargetAxis2(homePositionAxis2,PierSideWest);
-    } else {
-      if (homePositionAxis1 == 0.0) setTargetAxis1(0.0,PierSideEast); else {
-        if ((currentAlt < 10.0) && (getStartAxis1() < 90.0)) setTargetAxis1(60.0,PierSideEast); else setTargetAxis1(homePositionAxis1,PierSideEast);
-      }
-      setTargetAxis2(homePositionAxis2,PierSideEast);
-    }
-
-    // first phase, override above for additional waypoints
-    if (homePositionAxis2 > 0.0) {
-      if (getInstrAxis2() > 90.0-latitude) {
-        // if Dec is in the general area of the pole, slew both axis back at once
-        if (pierSideControl == PierSideFlipWE1) setTargetAxis1(-homePositionAxis1,PierSideWest); else setTargetAxis1(homePositionAxis1,PierSideEast);
-      } else {
-        // if we're at a low latitude and in the opposite sky, |HA|=6 is very low on the horizon in this orientation and we need to delay arriving there during a meridian flip
-        // in the extreme case, where the user is very near the (Earths!) equator an Horizon limit of -10 or -15 may be necessary for proper operation.
-        if ((currentAlt < 20.0) && (abs(latitude) < 45.0) && (getInstrAxis2() < 0.0)) {
-          if (pierSideControl == PierSideFlipWE1) setTargetAxis1(-45.0,PierSideWest); else setTargetAxis1(45.0,PierSideEast);
-        }
-      }
-    } else {
-      if (getInstrAxis2() < -90.0-latitude) {
-        // if Dec is in the general area of the pole, slew both axis back at once
-        if (pierSideControl == PierSideFlipWE1) setTargetAxis1(-homePositionAxis1,PierSideWest); else setTargetAxis1(homePositionAxis1,PierSideEast);
-      } else { 
-        // if we're at a low latitude and in the opposite sky, |HA|=6 is very low on the horizon in this orientation and we need to delay arriving there during a meridian flip
-        if ((currentAlt < 20.0) && (abs(latitude) < 45.0) && (getInstrAxis2() > 0.0)) {
-          if (pierSideControl == PierSideFlipWE1) setTargetAxis1(-45.0,PierSideWest); else setTargetAxis1(45.0,PierSideEast);
-        }
-      }
+#ifdef MFLIP_PLANNER_ON
+    // first phase, head for the first of the waypoints planned in goTo()
+    flipPoint_t w;
+    if (flipPath.next(&w)) { setTargetAxis1(w.axis1,PierSideEast); setTargetAxis2(w.axis2,PierSideEast); } else
+#endif
+    {
+      int p=PierSideEast; if (pierSideControl == PierSideFlipWE1) p=PierSideWest;
+      setTargetAxis1(flipFirstWaypointAxis1(pierSideControl),p);
+      setTargetAxis2(homePositionAxis2,p);
     }
 
     pierSideControl++;
     forceRefreshGetEqu();
+#ifdef SLEW_PLANNER
+    slewProfilePlan();
+#endif
   }
 
   long distStartAxis1,distStartAxis2,distDestAxis1,distDestAxis2;
@@ -110,7 +87,7 @@ void moveTo() {
     if (parkStatus == Parking) {
       lastTrackingState=abortTrackingState;
       parkStatus=NotParked;
-      nv.write(EE_parkStatus,parkStatus);
+      nvj.write(EE_parkStatus,parkStatus);
     } else
     if (homeMount) {
       lastTrackingState=abortTrackingState;
@@ -127,13 +104,21 @@ void moveTo() {
 
   // First, for Right Ascension
   long temp;
+#ifdef SLEW_PLANNER
+  temp=slewProfileRate(distStartAxis1,distDestAxis1,rampStepsAxis1,peakAxis1);
+#else
   if (distStartAxis1 > distDestAxis1) {
     temp=(StepsForRateChangeAxis1/isqrt32(distDestAxis1));   // slow down (temp gets bigger)
   } else {
     temp=(StepsForRateChangeAxis1/isqrt32(distStartAxis1));  // speed up (temp gets smaller)
   }
+#endif
   if (temp < maxRate) temp=maxRate;                          // fastest rate 
   if (temp > TakeupRate) temp=TakeupRate;                    // slowest rate
+#ifdef SLEW_COORDINATED_ON
+  temp=slewCoordinatedRate(temp,(double)distDestAxis1/AXIS1_STEPS_PER_DEGREE,
+    slewProfileRate(distStartAxis2,distDestAxis2,rampStepsAxis2,peakAxis2),(double)distDestAxis2/AXIS2_STEPS_PER_DEGREE);
+#endif
   if (abortSlew != 0) {
     if (abortSlew == 2) { a1r=(double)SiderealRate/(double)temp; } else
     if (abortSlew == 3) {
@@ -146,13 +131,21 @@ void moveTo() {
   cli(); timerRateAxis1=temp; sei();
 
   // Now, for Declination
+#ifdef SLEW_PLANNER
+  temp=slewProfileRate(distStartAxis2,distDestAxis2,rampStepsAxis2,peakAxis2);
+#else
   if (distStartAxis2 > distDestAxis2) {
     temp=(StepsForRateChangeAxis2/isqrt32(distDestAxis2));   // slow down
   } else {
     temp=(StepsForRateChangeAxis2/isqrt32(distStartAxis2));  // speed up
   }
+#endif
   if (temp < maxRate) temp=maxRate;                          // fastest rate
   if (temp > TakeupRate) temp=TakeupRate;                    // slowest rate
+#ifdef SLEW_COORDINATED_ON
+  temp=slewCoordinatedRate(temp,(double)distDestAxis2/AXIS2_STEPS_PER_DEGREE,
+    slewProfileRate(distStartAxis1,distDestAxis1,rampStepsAxis1,peakAxis1),(double)distDestAxis1/AXIS1_STEPS_PER_DEGREE);
+#endif
   if (abortSlew != 0) {
     if (abortSlew == 2) { a2r=(double)SiderealRate/(double)temp; abortSlew++; } else
     if (abortSlew == 3) { 
@@ -201,6 +194,11 @@ void moveTo() {
       startAxis1=posAxis1;
       startAxis2=posAxis2;
       sei();
+#ifdef MFLIP_PLANNER_ON
+      // the next waypoint if there is one, otherwise stay put and the third phase heads for the destination
+      flipPoint_t w;
+      if (flipPath.next(&w)) { setTargetAxis1(w.axis1,PierSideEast); setTargetAxis2(w.axis2,PierSideEast); }
+#else
       if (homePositionAxis1 == 0.0) {
         // for fork mounts
         if (pierSideControl == PierSideFlipEW2) setTargetAxis1(180.0,PierSideEast); else setTargetAxis1(-180.0,PierSideWest);
@@ -208,7 +206,11 @@ void moveTo() {
         // for eq mounts
         if (pierSideControl == PierSideFlipEW2) setTargetAxis1(homePositionAxis1,PierSideEast); else setTargetAxis1(-homePositionAxis1,PierSideWest);
       }
+#endif
       pierSideControl++;
+#ifdef SLEW_PLANNER
+      slewProfilePlan();
+#endif
 
       stepperModeGoto();
       forceRefreshGetEqu();
@@ -224,6 +226,9 @@ void moveTo() {
       startAxis2=posAxis2;
       targetAxis2.part.m=origTargetAxis2; targetAxis2.part.f=0;
       sei();
+#ifdef SLEW_PLANNER
+      slewProfilePlan();
+#endif
 
       stepperModeGoto();
       forceRefreshGetEqu();
@@ -235,7 +240,7 @@ void moveTo() {
         int i=parkClearBacklash(); if (i == -1) return; // working
 
         // stop the motor timers (except guiding)
-        cli(); trackingTimerRateAxis1=0.0; trackingTimerRateAxis2=0.0; sei(); delay(11);
+        cli(); trackingTimerRateAxis1=0.0; trackingTimerRateAxis2=0.0; TIMER_RATE_Q(trackingTimerRateAxis1Q=0; trackingTimerRateAxis2Q=0); sei(); delay(11);
         
         // restore trackingState
         trackingState=lastTrackingState; lastTrackingState=TrackingNone;
@@ -243,7 +248,7 @@ void moveTo() {
 
         // validate location
         byte parkPierSide=nv.read(EE_pierSide);
-        if ((blAxis1 != 0) || (blAxis2 != 0) || (posAxis1 != (long)targetAxis1.part.m) || (posAxis2 != (long)targetAxis2.part.m) || (pierSideControl != parkPierSide) || (i != 1)) { parkStatus=ParkFailed; nv.write(EE_parkStatus,parkStatus); }
+        if ((blAxis1 != 0) || (blAxis2 != 0) || (posAxis1 != (long)targetAxis1.part.m) || (posAxis2 != (long)targetAxis2.part.m) || (pierSideControl != parkPierSide) || (i != 1)) { parkStatus=ParkFailed; nvj.write(EE_parkStatus,parkStatus); }
 
         // sound park done
         soundAlert();
@@ -287,6 +292,168 @@ void moveTo() {
   }
 }
 
+// first phase of a meridian flip, decide if we should move to 60 deg. HA (4 hours) to get away from the horizon limits or just go straight to the home position
+// returns Axis1 for the waypoint (on the side of the pier we're flipping from,) Axis2 goes to the home position
+double flipFirstWaypointAxis1(int flipPhase) {
+  double a1;
+  if (flipPhase == PierSideFlipWE1) {
+    if (homePositionAxis1 == 0.0) a1=0.0; else {
+      if ((currentAlt < 10.0) && (getStartAxis1() > -90.0)) a1=-60.0; else a1=-homePositionAxis1;
+    }
+  } else {
+    if (homePositionAxis1 == 0.0) a1=0.0; else {
+      if ((currentAlt < 10.0) && (getStartAxis1() < 90.0)) a1=60.0; else a1=homePositionAxis1;
+    }
+  }
+
+  // override above for additional waypoints
+  if (homePositionAxis2 > 0.0) {
+    if (getInstrAxis2() > 90.0-latitude) {
+      // if Dec is in the general area of the pole, slew both axis back at once
+      if (flipPhase == PierSideFlipWE1) a1=-homePositionAxis1; else a1=homePositionAxis1;
+    } else {
+      // if we're at a low latitude and in the opposite sky, |HA|=6 is very low on the horizon in this orientation and we need to delay arriving there during a meridian flip
+      // in the extreme case, where the user is very near the (Earths!) equator an Horizon limit of -10 or -15 may be necessary for proper operation.
+      if ((currentAlt < 20.0) && (abs(latitude) < 45.0) && (getInstrAxis2() < 0.0)) {
+        if (flipPhase == PierSideFlipWE1) a1=-45.0; else a1=45.0;
+      }
+    }
+  } else {
+    if (getInstrAxis2() < -90.0-latitude) {
+      // if Dec is in the general area of the pole, slew both axis back at once
+      if (flipPhase == PierSideFlipWE1) a1=-homePositionAxis1; else a1=homePositionAxis1;
+    } else { 
+      // if we're at a low latitude and in the opposite sky, |HA|=6 is very low on the horizon in this orientation and we need to delay arriving there during a meridian flip
+      if ((currentAlt < 20.0) && (abs(latitude) < 45.0) && (getInstrAxis2() > 0.0)) {
+        if (flipPhase == PierSideFlipWE1) a1=-45.0; else a1=45.0;
+      }
+    }
+  }
+  return a1;
+}
+
+#ifdef MFLIP_PLANNER_ON
+// plans the meridian flip path once, for goTo() after the start and target are set.  the classic waypoints are those moveTo() would
+// otherwise visit: the first phase waypoint then the home position on the other side of the pier
+// returns the number of waypoints, 0 for a direct slew
+int flipPathPlan(int flipPhase, bool classicOnly) {
+  flipPath.init(latitude,minAlt,AXIS1_LIMIT_UNDER_POLE,AXIS2_LIMIT_MIN,AXIS2_LIMIT_MAX,homePositionAxis2,SLEW_ACCELERATION_DIST,
+#ifdef SLEW_COORDINATED_ON
+    true);
+#else
+    false);
+#endif
+
+  flipPoint_t classic[2];
+  bool fromWest=(flipPhase == PierSideFlipWE1);
+  classic[0]=flipPath.toMech(flipFirstWaypointAxis1(flipPhase),homePositionAxis2,fromWest);
+  if (homePositionAxis1 == 0.0) {
+    // for fork mounts
+    if (fromWest) classic[1]=flipPath.toMech(-180.0,homePositionAxis2,true); else classic[1]=flipPath.toMech(180.0,homePositionAxis2,false);
+  } else {
+    // for eq mounts
+    if (fromWest) classic[1]=flipPath.toMech(-homePositionAxis1,homePositionAxis2,true); else classic[1]=flipPath.toMech(homePositionAxis1,homePositionAxis2,false);
+  }
+
+  flipPoint_t start, target;
+  cli();
+  start.axis1=(double)(startAxis1+indexAxis1Steps)/(double)AXIS1_STEPS_PER_DEGREE;
+  start.axis2=(double)(startAxis2+indexAxis2Steps)/(double)AXIS2_STEPS_PER_DEGREE;
+  target.axis1=(double)((long)targetAxis1.part.m+indexAxis1Steps)/(double)AXIS1_STEPS_PER_DEGREE;
+  target.axis2=(double)((long)targetAxis2.part.m+indexAxis2Steps)/(double)AXIS2_STEPS_PER_DEGREE;
+  sei();
+
+  return flipPath.plan(start,target,classic,2,classicOnly);
+}
+#endif
+
+#ifdef SLEW_PLANNER
+#ifdef SLEW_SCURVE_ON
+// S-curve (constant jerk, the acceleration ramps up then back down) velocity as a fraction of the peak (0 to 65535) at
+// distances of 0/32 to 32/32 of the way through a ramp, the same curve is used to speed up and (mirrored) to slow down
+const uint16_t sCurveVelocity[33] = {
+      0, 10734, 17040, 22328, 27049, 31388, 35342, 38719, 41654, 44247, 46562,
+  48646, 50533, 52248, 53810, 55236, 56539, 57727, 58811, 59797, 60691, 61499,
+  62225, 62871, 63443, 63941, 64369, 64728, 65020, 65246, 65407, 65503, 65535 };
+#endif
+
+// with constant acceleration the ramp is always accelDist long, a shorter segment just peaks half way
+// for the S-curve a segment too short to reach the slew rate (2x SLEW_ACCELERATION_DIST) peaks half way at a lower velocity with
+// the same jerk, the ramp distance goes as velocity^1.5 so the peak is (dist/(2*accelDist))^(2/3) of the slew rate
+void slewProfilePlanAxis(long dist, double accelDist, long *rampSteps, double *peak) {
+#ifdef SLEW_SCURVE_ON
+  if (dist >= accelDist*2.0) { *rampSteps=round(accelDist); *peak=1.0; } else {
+    *rampSteps=dist/2; if (*rampSteps < 1) *rampSteps=1;
+    *peak=pow((double)dist/(accelDist*2.0),2.0/3.0);
+  }
+#else
+  (void)dist;
+  *rampSteps=round(accelDist); *peak=1.0;
+#endif
+}
+
+// plans the ramps for a goto segment from the current position to the target, call whenever a segment starts
+void slewProfilePlan() {
+  cli();
+  long d1=abs((long)targetAxis1.part.m-posAxis1);
+  long d2=abs((long)targetAxis2.part.m-posAxis2);
+  sei();
+  slewProfilePlanAxis(d1,SLEW_ACCELERATION_DIST*AXIS1_STEPS_PER_DEGREE,&rampStepsAxis1,&peakAxis1);
+  slewProfilePlanAxis(d2,SLEW_ACCELERATION_DIST*AXIS2_STEPS_PER_DEGREE,&rampStepsAxis2,&peakAxis2);
+
+#ifdef SLEW_COORDINATED_ON
+  // both axes run at the same degrees per second for a given rate, so the axis with the longer move (in degrees) takes the
+  // longest and sets the pace at its limits.  the other axis follows the same profile scaled by k (the ratio of the moves,)
+  // its peak velocity and ramp length (and so acceleration) are k times as large and it arrives at the same time.  both axes
+  // share the one rate and acceleration limit (in degrees) so the longer move's time is already the shortest possible,
+  // this doesn't make gotos any quicker it just keeps the shorter move from finishing early.  moveTo() keeps them in step as
+  // the goto runs, see slewCoordinatedRate()
+  double deg1=(double)d1/AXIS1_STEPS_PER_DEGREE;
+  double deg2=(double)d2/AXIS2_STEPS_PER_DEGREE;
+  if ((d1 > 0) && (d2 > 0)) {
+    if (deg1 >= deg2) {
+      double k=deg2/deg1;
+      rampStepsAxis2=round(((double)rampStepsAxis1/AXIS1_STEPS_PER_DEGREE)*k*AXIS2_STEPS_PER_DEGREE); if (rampStepsAxis2 < 1) rampStepsAxis2=1;
+      peakAxis2=peakAxis1*k;
+    } else {
+      double k=deg1/deg2;
+      rampStepsAxis1=round(((double)rampStepsAxis2/AXIS2_STEPS_PER_DEGREE)*k*AXIS1_STEPS_PER_DEGREE); if (rampStepsAxis1 < 1) rampStepsAxis1=1;
+      peakAxis1=peakAxis2*k;
+    }
+  }
+#endif
+}
+
+#ifdef SLEW_COORDINATED_ON
+// rate (in microseconds*16) for an axis with deg degrees left to go given the other axis' rate and degrees left.  the planned
+// profiles alone leave the shorter move early whenever the target moves during the goto (tracking,) so the shorter move's rate
+// is instead the longer one's slowed by the ratio of what each has left, it catches up if behind and they arrive together
+long slewCoordinatedRate(long rate, double deg, long otherRate, double otherDeg) {
+  if ((deg <= 0.0) || (deg >= otherDeg)) return rate;
+  double r=(double)otherRate*(otherDeg/deg);
+  if (r > SiderealRate/2.0) r=SiderealRate/2.0;              // no slower than 2x sidereal, Axis1 has to catch up with its target
+  return round(r);
+}
+#endif
+
+// rate (in microseconds*16) at distStart steps into and distDest steps from the end of the current segment
+long slewProfileRate(long distStart, long distDest, long rampSteps, double peak) {
+  long d=distStart; if (distDest < d) d=distDest;
+  double v=peak;
+  if (d < rampSteps) {
+#ifdef SLEW_SCURVE_ON
+    double x=((double)d/(double)rampSteps)*32.0;
+    int i=(int)x;
+    v*=(sCurveVelocity[i]+(sCurveVelocity[i+1]-(double)sCurveVelocity[i])*(x-i))/65535.0;
+#else
+    v*=sqrt((double)d/(double)rampSteps);
+#endif
+  }
+  if (v*TakeupRate < maxRate) return TakeupRate;
+  return round(maxRate/v);
+}
+#endif
+
 // fast integer square root routine, Integer Square Roots by Jack W. Crenshaw
 uint32_t isqrt32 (uint32_t n) {
     register uint32_t root=0, remainder, place= 0x40000000;
@@ -73,6 +73,93 @@
   #define DHL(x,y)
 #endif
 
+// These two default by platform, which a _OFF/_ON define can't say, so they're ON or OFF like a Config.h setting.  To choose
+// add "#define TIMER_FIXED_POINT ON" (or OFF) to Config.h
+
+// Use fixed point math for the timerSupervisor() guide ramp and rate to interval conversion ---------
+// default=ON for HAL_SLOW_PROCESSOR (no FPU, double is emulated in software,) otherwise OFF
+#ifndef TIMER_FIXED_POINT
+  #ifdef HAL_SLOW_PROCESSOR
+    #define TIMER_FIXED_POINT ON
+  #else
+    #define TIMER_FIXED_POINT OFF
+  #endif
+#endif
+
+// Precompute the Axis1 timer intervals for the PEC corrections at the current tracking/guide rates ---
+// default=ON for HAL_FAST_PROCESSOR (the table is about 6KB of RAM,) otherwise OFF.  Not used with TIMER_FIXED_POINT
+// or on ALTAZM mounts, where there's no PEC and the tracking rate changes constantly
+#ifndef TIMER_RATE_TABLE
+  #if defined(HAL_FAST_PROCESSOR) && TIMER_FIXED_POINT == OFF && MOUNT_TYPE != ALTAZM
+    #define TIMER_RATE_TABLE ON
+  #else
+    #define TIMER_RATE_TABLE OFF
+  #endif
+#endif
+#if (TIMER_FIXED_POINT != ON && TIMER_FIXED_POINT != OFF) || (TIMER_RATE_TABLE != ON && TIMER_RATE_TABLE != OFF)
+  #error "TIMER_FIXED_POINT and TIMER_RATE_TABLE must be ON or OFF"
+#endif
+#if TIMER_RATE_TABLE == ON && TIMER_FIXED_POINT == ON
+  #error "TIMER_RATE_TABLE and TIMER_FIXED_POINT can't both be ON"
+#endif
+
+// Use a jerk limited (S-curve) rate profile for gotos -----------------------------------------------
+// SLEW_ACCELERATION_DIST is still the distance to reach the slew rate, peak acceleration is 2x at mid-ramp
+#define SLEW_SCURVE_OFF       // default=_OFF, use "SLEW_SCURVE_ON" to activate
+
+// Coordinate gotos so both axes arrive together, the shorter move follows the longer move's profile scaled down --
+// the total slew time is unchanged (the longer move is still at the slew rate and acceleration limits,) it's for smoother motion
+#define SLEW_COORDINATED_OFF  // default=_OFF, use "SLEW_COORDINATED_ON" to activate
+#if defined(SLEW_SCURVE_ON) || defined(SLEW_COORDINATED_ON)
+  #define SLEW_PLANNER
+#endif
+
+// Fit the pointing model with the original coarse to fine grid search instead of least squares -------
+#define ALIGN_GRID_SEARCH_OFF // default=_OFF, use "ALIGN_GRID_SEARCH_ON" to activate
+
+// Work the pointing model's corrections out from tables of sin/tan/sec/cos, within 0.2" (equatorial mounts) -------
+#define ALIGN_CORRECTION_GRID_OFF // default=_OFF, use "ALIGN_CORRECTION_GRID_ON" to activate
+#if defined(ALIGN_CORRECTION_GRID_ON) && !defined(HAL_FAST_PROCESSOR)
+  #error "ALIGN_CORRECTION_GRID_ON needs a HAL_FAST_PROCESSOR platform, for the 10KB of RAM the tables take"
+#endif
+
+// Plan meridian flips once at goto time, the fastest path that keeps clear of the horizon and limits --
+// the pier and tripod aren't modeled, the limits have to keep the tube and counterweights clear of them
+#define MFLIP_PLANNER_OFF     // default=_OFF, use "MFLIP_PLANNER_ON" to activate
+#if defined(MFLIP_PLANNER_ON) && !defined(HAL_FAST_PROCESSOR)
+  #error "MFLIP_PLANNER_ON needs a HAL_FAST_PROCESSOR platform, planning takes up to 1000 samples of the path in goTo()"
+#endif
+
+// Step the rotator and focusers from a spare hardware timer (Teensy3.x, Teensy4.0, Linux) -------------
+#define AUX_AXIS_TIMER_OFF    // default=_OFF, use "AUX_AXIS_TIMER_ON" to activate
+#define AUX_AXIS_TIMER_PERIOD 50 // in microseconds, AXISn_STEP_RATE_MAX is rounded up to a whole number of periods
+                                  // and a step takes at least two (step pin high then low,) so 10kHz at most
+#if defined(AUX_AXIS_TIMER_ON) && !defined(HAL_AUX_TIMER)
+  #error "AUX_AXIS_TIMER_ON isn't supported on this platform"
+#endif
+#if defined(AUX_AXIS_TIMER_ON) && defined(HAL_AUX_TIMER_PIT) && BUZZER >= 0
+  #error "AUX_AXIS_TIMER_ON takes the last PIT channel on the Teensy, BUZZER can't use tone() with it (use BUZZER ON or OFF)"
+#endif
+
+// Record and play PEC in PEC_HIRES_BINS bins per sidereal second with 16 bit corrections, interpolated between bins --
+// the table is kept delta encoded in NV and :Vr# returns four hex digits per bin, PECprep's one byte per second tables don't apply
+#define PEC_HIRES_OFF         // default=_OFF, use "PEC_HIRES_ON" to activate
+#define PEC_HIRES_BINS 10     // bins per sidereal second, 2, 4, 5, or 10
+#ifdef PEC_HIRES_ON
+  #if !defined(HAL_FAST_PROCESSOR)
+    #error "PEC_HIRES_ON needs a HAL_FAST_PROCESSOR platform, for the RAM"
+  #endif
+  #if (PEC_HIRES_BINS < 2) || (PEC_HIRES_BINS > 10) || (100%PEC_HIRES_BINS != 0)
+    #error "PEC_HIRES_BINS must be 2, 4, 5, or 10"
+  #endif
+  #define PEC_BINS PEC_HIRES_BINS
+#else
+  #define PEC_BINS 1
+#endif
+
+// Enable execution time profiling of the ISR's and main tasks, read with :GXYn# and :GXZn# -----------
+#define PROFILE_OFF           // default=_OFF, use "PROFILE_ON" to activate
+
 // ---------------------------------------------------------------------------------------------------
 
 #include "src/lib/St4SerialMaster.h"
@@ -80,15 +167,22 @@
 #include "Globals.h"
 #include "src/lib/Julian.h"
 #include "src/lib/Misc.h"
+#include "src/lib/Profile.h"
 #include "src/lib/Sound.h"
 #include "src/lib/Coord.h"
 #include "Align.h"
 #include "src/lib/Library.h"
+#include "src/lib/Journal.h"
 #include "src/lib/Command.h"
 #include "src/lib/RTC.h"
 #include "src/lib/Weather.h"
 weather ambient;
 
+#ifdef MFLIP_PLANNER_ON
+  #include "src/lib/FlipPlanner.h"
+  flipPlanner flipPath;
+#endif
+
 #if ROTATOR == ON
   #include "src/lib/Rotator.h"
   rotator rot;
@@ -162,6 +256,10 @@ void setup() {
   // Call hardware specific initialization
   HAL_Init();
 
+#ifdef PROFILE_ON
+  profile.init();
+#endif
+
   SerialA.begin(SERIAL_A_BAUD_DEFAULT);
 #ifdef HAL_SERIAL_B_ENABLED
   SerialB.begin(SERIAL_B_BAUD_DEFAULT);
@@ -178,6 +276,8 @@ void setup() {
 
   // initialize the Non-Volatile Memory
   nv.init();
+  nvj.init();
+  initNvLayout();
 
   // initialize the Object Library
   Lib.init();
@@ -314,6 +414,11 @@ void setup() {
   #endif
 #endif
 
+#if defined(AUX_AXIS_TIMER_ON) && (ROTATOR == ON || FOCUSER1 == ON || FOCUSER2 == ON)
+  // start stepping the rotator/focusers
+  HAL_Init_Timer_Aux(AUX_AXIS_TIMER_PERIOD*16L);
+#endif
+
   // prep counters (for keeping time in main loop)
   cli(); siderealTimer=lst; guideSiderealTimer=lst; PecSiderealTimer=lst; sei();
   last_loop_micros=micros();
@@ -321,7 +426,9 @@ void setup() {
 
 void loop() {
   loop2();
+  PROFILE_START(PROFILE_MODEL);
   Align.model(0); // GTA compute pointing model, this will call loop2() during extended processing
+  PROFILE_END(PROFILE_MODEL);
 }
 
 void loop2() {
@@ -348,16 +455,14 @@ void loop2() {
     siderealTimer=tempLst;
 
 #ifdef ESP32
+    PROFILE_START(PROFILE_SUPERVISOR);
     timerSupervisor(true);
+    PROFILE_END(PROFILE_SUPERVISOR);
 #endif
     
 #if MOUNT_TYPE != ALTAZM
     // WRITE PERIODIC ERROR CORRECTION TO EEPROM
-    if (pecAutoRecord > 0) {
-      // write PEC table to EEPROM, should do several hundred bytes/second
-      pecAutoRecord--;
-      nv.update(EE_pecTable+pecAutoRecord,pecBuffer[pecAutoRecord]);
-    }
+    if (pecAutoRecord > 0) pecSavePoll();
 #endif
 
     // FLASH LED DURING SIDEREAL TRACKING
@@ -370,7 +475,9 @@ void loop2() {
     // SIDEREAL TRACKING DURING GOTOS
     // keeps the target where it's supposed to be while doing gotos
     if (trackingState == TrackingMoveTo) {
+      PROFILE_START(PROFILE_MOVETO);
       moveTo();
+      PROFILE_END(PROFILE_MOVETO);
       if (lastTrackingState == TrackingSidereal) {
         // origTargetAxisn isn't used in Alt/Azm mode since meridian flips never happen
         origTargetAxis1.fixed+=fstepAxis1.fixed;
@@ -446,6 +553,9 @@ void loop2() {
     autoPowerDownAxis2();
 #endif
 
+    // PUSH TELEMETRY
+    telemetryPoll();
+
     // UPDATE THE UT1 CLOCK
     cli(); long cs=lst; sei();
     double t2=(double)((cs-lst_start)/100.0)/1.00273790935;
@@ -465,7 +575,12 @@ void loop2() {
 #endif
 
   // FASTEST PPOLLING ----------------------------------------------------------------------------------
+  i2cBus.poll();
   if (!isSlewing()) nv.poll();
+  nvj.poll();
+#if TIMER_RATE_TABLE == ON
+  rateTablePoll();
+#endif
  
   // WORKLOAD MONITORING -------------------------------------------------------------------------------
   long this_loop_micros=micros();
@@ -574,6 +689,8 @@ void loop2() {
 
   } else {
     // COMMAND PROCESSING --------------------------------------------------------------------------------
+    PROFILE_START(PROFILE_COMMANDS);
     processCommands();
+    PROFILE_END(PROFILE_COMMANDS);
   }
 }
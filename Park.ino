@@ -47,7 +47,7 @@ byte park() {
 
     // record our park status
     int lastParkStatus=parkStatus; 
-    parkStatus=Parking; nv.write(EE_parkStatus,parkStatus);
+    parkStatus=Parking; nvj.write(EE_parkStatus,parkStatus);
     
     // get suggested park position
     double parkTargetAxis1=nv.readFloat(EE_posAxis1);
@@ -61,7 +61,7 @@ byte park() {
     if (gotoStatus != 0) {
       trackingState=abortTrackingState; // resume tracking state
       parkStatus=lastParkStatus;        // revert the park status
-      nv.write(EE_parkStatus,parkStatus);
+      nvj.write(EE_parkStatus,parkStatus);
     }
 
     return gotoStatus;
@@ -72,7 +72,7 @@ byte park() {
 void parkFinish() {
   if (parkStatus != ParkFailed) {
     // success, we're parked
-    parkStatus=Parked; nv.write(EE_parkStatus,parkStatus);
+    parkStatus=Parked; nvj.write(EE_parkStatus,parkStatus);
   
     // store the pointing model
     saveAlignModel();
@@ -165,7 +165,7 @@ boolean unPark(bool withTrackingOn) {
 #else
   if ((parkStatus == Parked) || ((atHome) && (parkStatus == NotParked))) {
 #endif
-    parkStatus=nv.read(EE_parkStatus);
+    parkStatus=nvj.read(EE_parkStatus);
     parkSaved =nv.read(EE_parkSaved);
     parkStatus=Parked;
     if (parkStatus == Parked) {
@@ -187,7 +187,7 @@ boolean unPark(bool withTrackingOn) {
         InitStartPosition();
   
         // stop the motor timers (except guiding)
-        cli(); trackingTimerRateAxis1=0.0; trackingTimerRateAxis2=0.0; sei(); delay(11);
+        cli(); trackingTimerRateAxis1=0.0; trackingTimerRateAxis2=0.0; TIMER_RATE_Q(trackingTimerRateAxis1Q=0; trackingTimerRateAxis2Q=0); sei(); delay(11);
 
         // load the pointing model
         loadAlignModel();
@@ -216,15 +216,15 @@ boolean unPark(bool withTrackingOn) {
         if (withTrackingOn) {
           // update our status, we're not parked anymore
           parkStatus=NotParked;
-          nv.write(EE_parkStatus,parkStatus);
+          nvj.write(EE_parkStatus,parkStatus);
   
           // start tracking
           trackingState=TrackingSidereal;
           enableStepperDrivers();
   
           // get PEC status
-          pecStatus  =nv.read(EE_pecStatus);
-          pecRecorded=nv.read(EE_pecRecorded); if (!pecRecorded) pecStatus=IgnorePEC;
+          pecStatus  =nvj.read(EE_pecStatus);
+          pecRecorded=nvj.read(EE_pecRecorded); if (!pecRecorded) pecStatus=IgnorePEC;
         }
 
         return true;
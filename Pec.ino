@@ -16,6 +16,24 @@
 long pecRecordStopTime  = 0;
 long wormRotationPos    = 0;
 long lastWormRotationPos=-1;
+int pecSaveSize         = 0;
+
+#define PEC_BIN_CS (100/PEC_BINS)  // bin length in 1/100 sidereal seconds
+
+#ifdef PEC_HIRES_ON
+  long lastPecTime      =-1;
+
+  int pecGet(long i) { return pecBuffer[i]; }
+  void pecSet(long i, int v) { pecBuffer[i]=v; }
+#else
+  int pecGet(long i) { return (int)pecBuffer[i]-128; }
+  void pecSet(long i, int v) { pecBuffer[i]=v+128; }
+#endif
+
+// the PEC rate correction (x sidereal) and the same in steps per second, for the sidereal timer
+void setPecRate(double rate, int steps) {
+  cli(); pecTimerRateAxis1=rate; TIMER_RATE_Q(pecTimerRateAxis1Q=toQ24(rate)); pecStepsAxis1=steps; sei();
+}
 
 void pec() {
   // PEC is only active when we're tracking at the sidereal rate with a guide rate that makes sense
@@ -47,7 +65,7 @@ void pec() {
     } else pecBufferStart=false;
   #endif
 
-  if (pecStatus == IgnorePEC) { pecTimerRateAxis1=0.0; return; }
+  if (pecStatus == IgnorePEC) { setPecRate(0.0,0); return; }
   if (!wormSensedFirst) return;
 
   // worm step position corrected for any index found
@@ -65,25 +83,25 @@ void pec() {
 
   // start playing PEC
   if (pecStatus == ReadyPlayPEC) {
-    // makes sure the index is at the start of a second before resuming play
-    if ((long)fmod(wormRotationPos,StepsPerSecondAxis1) == 0) {
+    // makes sure the index is at the start of a bin before resuming play
+    if ((long)fmod(wormRotationPos,StepsPerPecBinAxis1) == 0) {
       pecStatus=PlayPEC;
-      pecIndex=wormRotationPos/StepsPerSecondAxis1;
+      pecIndex=wormRotationPos/StepsPerPecBinAxis1;
 
       // playback starts now
       PecSiderealTimer=t;
     }
   } else
-  // start recording PEC
+  // start recording PEC, without a shadow buffer wait until the last save is written
   if (pecStatus == ReadyRecordPEC) {
-    if ((long)fmod(wormRotationPos,StepsPerSecondAxis1) == 0) {
+    if (((long)fmod(wormRotationPos,StepsPerPecBinAxis1) == 0) && ((pecShadow != NULL) || (pecAutoRecord == 0))) {
       pecStatus=RecordPEC;
-      pecIndex=wormRotationPos/StepsPerSecondAxis1;
+      pecIndex=wormRotationPos/StepsPerPecBinAxis1;
       pecRecorded=false;
 
       // recording starts now
       PecSiderealTimer=t;
-      pecRecordStopTime=PecSiderealTimer+(long)SecondsPerWormRotationAxis1*100L;
+      pecRecordStopTime=PecSiderealTimer+PecBinsPerWormRotationAxis1*PEC_BIN_CS;
       accPecGuideHA.fixed=0;
     }
   } else
@@ -99,94 +117,114 @@ void pec() {
 
   // reset the buffer index to match the worm index
   if (pecBufferStart && (pecStatus != RecordPEC)) { pecIndex=0; PecSiderealTimer=t; }
-  // Increment the PEC index once a second and make it go back to zero when the worm finishes a rotation
-  if (t-PecSiderealTimer > 99) {
-    PecSiderealTimer=t; pecIndex=(pecIndex+1)%SecondsPerWormRotationAxis1;
+  // Increment the PEC index once a bin (a second unless PEC_HIRES_ON) and make it go back to zero when the worm finishes a rotation
+  if (t-PecSiderealTimer > PEC_BIN_CS-1) {
+    PecSiderealTimer=t; pecIndex=(pecIndex+1)%PecBinsPerWormRotationAxis1;
   }
-  pecIndex1=pecIndex; if (pecIndex1 < 0) pecIndex1+=SecondsPerWormRotationAxis1; if (pecIndex1 >= SecondsPerWormRotationAxis1) pecIndex1-=SecondsPerWormRotationAxis1;
+  pecIndex1=pecIndex; if (pecIndex1 < 0) pecIndex1+=PecBinsPerWormRotationAxis1; if (pecIndex1 >= PecBinsPerWormRotationAxis1) pecIndex1-=PecBinsPerWormRotationAxis1;
 
   accPecGuideHA.fixed+=guideAxis1.fixed;
   
-  // falls in whenever the pecIndex changes, which is once a sidereal second
+  // falls in whenever the pecIndex changes, which is once a bin
   if (pecIndex1 != lastPecIndex) {
     lastPecIndex=pecIndex1;
 
     // assume no change to tracking rate
-    pecTimerRateAxis1=0.0;
+    setPecRate(0.0,0);
 
     if (pecStatus == RecordPEC) {
       // save the correction as 1 of 3 weighted average
       int l=round(fixedToDouble(accPecGuideHA));
-      if (l < -StepsPerSecondAxis1) l=-StepsPerSecondAxis1; if (l > StepsPerSecondAxis1) l=StepsPerSecondAxis1;   // +/-1 sidereal rate range for corrections
-      if (l < -127) l=-127; if (l > 127) l=127;                                                                   // prevent overflow if StepsPerSecondAxis1 > 127
-      if (!pecFirstRecord) l=(l+((int)pecBuffer[pecIndex1]-128)*2)/3; 
-      pecBuffer[pecIndex1]=l+128;  // save the correction
+      if (l < -StepsPerPecBinAxis1) l=-StepsPerPecBinAxis1; if (l > StepsPerPecBinAxis1) l=StepsPerPecBinAxis1;   // +/-1 sidereal rate range for corrections
+      if (l < -PEC_MAX) l=-PEC_MAX; if (l > PEC_MAX) l=PEC_MAX;                                                   // prevent overflow if StepsPerPecBinAxis1 > PEC_MAX
+      if (!pecFirstRecord) l=(l+pecGet(pecIndex1)*2)/3; 
+      pecSet(pecIndex1,l);         // save the correction
       accPecGuideHA.part.m-=l;     // remove from the accumulator
     }
 
+#ifndef PEC_HIRES_ON
     if (pecStatus == PlayPEC) {
       // pecIndex2 adjusts one second before the value was recorded, an estimate of the latency between image acquisition and response
       // if sending values directly to OnStep from PECprep, etc. be sure to account for this
-      int pecIndex2=pecIndex1-1; if (pecIndex2 < 0) pecIndex2+=SecondsPerWormRotationAxis1;
+      int pecIndex2=pecIndex1-1; if (pecIndex2 < 0) pecIndex2+=PecBinsPerWormRotationAxis1;
       // number of steps ahead or behind for this 1 second slot, up to +/-127
-      int l=pecBuffer[pecIndex2]-128;
+      int l=pecGet(pecIndex2);
       if (l > StepsPerSecondAxis1) l=StepsPerSecondAxis1; if (l < -StepsPerSecondAxis1) l=-StepsPerSecondAxis1;
-      pecTimerRateAxis1=((double)l/StepsPerSecondAxis1);
+      setPecRate((double)l/StepsPerSecondAxis1,l);
     }
+#endif
+  }
+
+#ifdef PEC_HIRES_ON
+  // the correction moves linearly from bin to bin, each bin's value is taken to be at its center
+  // and playback is one second behind the recording, an estimate of the latency between image acquisition and response
+  if ((pecStatus == PlayPEC) && (t != lastPecTime)) {
+    lastPecTime=t;
+    long N=PecBinsPerWormRotationAxis1;
+    long i=(pecIndex1-PEC_BINS+N)%N;
+    double f=(double)(t-PecSiderealTimer)/PEC_BIN_CS;
+    double v;
+    if (f < 0.5) { int a=pecGet((i-1+N)%N); v=a+(pecGet(i)-a)*(f+0.5); } else { int a=pecGet(i); v=a+(pecGet((i+1)%N)-a)*(f-0.5); }
+    if (v > StepsPerPecBinAxis1) v=StepsPerPecBinAxis1; if (v < -StepsPerPecBinAxis1) v=-StepsPerPecBinAxis1;
+    setPecRate(v/StepsPerPecBinAxis1,lround(v*PEC_BINS));
   }
+#endif
 }
  
 void disablePec() {
   // give up recording if we stop tracking at the sidereal rate
-  if (pecStatus == RecordPEC)  { pecStatus=IgnorePEC; pecTimerRateAxis1=0.0; } // don't zero the PEC offset, we don't want things moving and it really doesn't matter 
+  if (pecStatus == RecordPEC)  { pecStatus=IgnorePEC; setPecRate(0.0,0); } // don't zero the PEC offset, we don't want things moving and it really doesn't matter 
   // get ready to re-index when tracking comes back
-  if (pecStatus == PlayPEC)  { pecStatus=ReadyPlayPEC; pecTimerRateAxis1=0.0; } 
+  if (pecStatus == PlayPEC)  { pecStatus=ReadyPlayPEC; setPecRate(0.0,0); } 
 }
 
+#define PEC_WRAP(i) ((((i)%N)+N)%N)
 void cleanupPec() {
+  long N=PecBinsPerWormRotationAxis1;
+
   // low pass filter ----------------------------------------------------------
   int j,J1,J4,J9,J17;
-  for (int scc=0+3; scc < SecondsPerWormRotationAxis1+3; scc++) {
-    j=pecBuffer[((scc)%SecondsPerWormRotationAxis1)]-128;
+  for (long scc=0+3; scc < N+3; scc++) {
+    j=pecGet(PEC_WRAP(scc));
 
     J1=(int)round((float)j*0.01);
     J4=(int)round((float)j*0.04);
     J9=(int)round((float)j*0.09);
     J17=(int)round((float)j*0.17);
-    pecBuffer[((scc-4)%SecondsPerWormRotationAxis1)]=(((int)pecBuffer[((scc-4)%SecondsPerWormRotationAxis1)]-128)+J1)+128;
-    pecBuffer[((scc-3)%SecondsPerWormRotationAxis1)]=(((int)pecBuffer[((scc-3)%SecondsPerWormRotationAxis1)]-128)+J4)+128;
-    pecBuffer[((scc-2)%SecondsPerWormRotationAxis1)]=(((int)pecBuffer[((scc-2)%SecondsPerWormRotationAxis1)]-128)+J9)+128;
-    pecBuffer[((scc-1)%SecondsPerWormRotationAxis1)]=(((int)pecBuffer[((scc-1)%SecondsPerWormRotationAxis1)]-128)+J17)+128;
-    pecBuffer[((scc  )%SecondsPerWormRotationAxis1)]=(((int)pecBuffer[((scc  )%SecondsPerWormRotationAxis1)]-128)-(J17+J17+J9+J9+J4+J4+J1+J1))+128;
-    pecBuffer[((scc+1)%SecondsPerWormRotationAxis1)]=(((int)pecBuffer[((scc+1)%SecondsPerWormRotationAxis1)]-128)+J17)+128;
-    pecBuffer[((scc+2)%SecondsPerWormRotationAxis1)]=(((int)pecBuffer[((scc+2)%SecondsPerWormRotationAxis1)]-128)+J9)+128;
-    pecBuffer[((scc+3)%SecondsPerWormRotationAxis1)]=(((int)pecBuffer[((scc+3)%SecondsPerWormRotationAxis1)]-128)+J4)+128;
-    pecBuffer[((scc+4)%SecondsPerWormRotationAxis1)]=(((int)pecBuffer[((scc+4)%SecondsPerWormRotationAxis1)]-128)+J1)+128;
+    pecSet(PEC_WRAP(scc-4),pecGet(PEC_WRAP(scc-4))+J1);
+    pecSet(PEC_WRAP(scc-3),pecGet(PEC_WRAP(scc-3))+J4);
+    pecSet(PEC_WRAP(scc-2),pecGet(PEC_WRAP(scc-2))+J9);
+    pecSet(PEC_WRAP(scc-1),pecGet(PEC_WRAP(scc-1))+J17);
+    pecSet(PEC_WRAP(scc  ),pecGet(PEC_WRAP(scc  ))-(J17+J17+J9+J9+J4+J4+J1+J1));
+    pecSet(PEC_WRAP(scc+1),pecGet(PEC_WRAP(scc+1))+J17);
+    pecSet(PEC_WRAP(scc+2),pecGet(PEC_WRAP(scc+2))+J9);
+    pecSet(PEC_WRAP(scc+3),pecGet(PEC_WRAP(scc+3))+J4);
+    pecSet(PEC_WRAP(scc+4),pecGet(PEC_WRAP(scc+4))+J1);
   }
   
   // linear regression ----------------------------------------------------------
   // the number of steps added should equal the number of steps subtracted (from the cycle)
   // first, determine how far we've moved ahead or backward in steps
-  long sum_pec=0; for (int scc=0; scc < SecondsPerWormRotationAxis1; scc++) { sum_pec+=(int)pecBuffer[scc]-128; }
+  long sum_pec=0; for (long scc=0; scc < N; scc++) { sum_pec+=pecGet(scc); }
 
   // this is the correction coefficient for a given location in the sequence
-  double Ccf = (double)sum_pec/(double)SecondsPerWormRotationAxis1;
+  double Ccf = (double)sum_pec/(double)N;
 
   // now, apply the correction to the sequence to make the PEC adjustments null out
   // this process was simulated in a spreadsheet and the roundoff error might leave us at +/- a step which is tacked on at the beginning
   long lp2=0; sum_pec=0; 
-  for (int scc=0; scc < SecondsPerWormRotationAxis1; scc++) {
+  for (long scc=0; scc < N; scc++) {
     // the correction, "now"
     long lp1=lround(-(double)scc*Ccf);
     
     // if the correction increases or decreases then add or subtract that many steps
-    pecBuffer[scc]=(int)pecBuffer[scc]+(lp1-lp2);
+    pecSet(scc,pecGet(scc)+(lp1-lp2));
 
     // sum the values for a final adjustment, if necessary
-    sum_pec+=(int)pecBuffer[scc]-128;     
+    sum_pec+=pecGet(scc);
     lp2=lp1;
   }
-  pecBuffer[0]-=sum_pec;
+  pecSet(0,pecGet(0)-sum_pec);
 
   // a reality check, make sure the buffer data looks good, if not forget it
   if ((sum_pec > 2) || (sum_pec < -2)) { pecRecorded=false; pecStatus=IgnorePEC; }
@@ -194,9 +232,137 @@ void cleanupPec() {
 
 // it often takes a couple of ms to record a value to EEPROM, this can effect tracking performance since interrupts are disabled during the operation.
 // so we store PEC data in RAM while recording.  When done, sidereal tracking is turned off and the data is written to EEPROM.
+// saving copies the table to a shadow buffer that's written in the background, so playing and recording can go on meanwhile.
 void createPecBuffer() {
-  pecBuffer = (byte*)malloc(pecBufferSize * sizeof(*pecBuffer));
+  pecBuffer = (PEC_BUFFER_TYPE*)malloc(pecBufferSize * sizeof(*pecBuffer));
   if (!pecBuffer) pecBufferSize=0;
+#ifndef HAL_SLOW_PROCESSOR
+  if (pecBufferSize > 0) pecShadow = (byte*)malloc(pecTableBytes);
+#endif
+}
+
+#ifdef PEC_HIRES_ON
+// the table is stored as a 6 byte header (number of bins, length of the data, CRC16 of the data) then the data, a stream of
+// 4 bit codes high nibble first: 1 to 14 is a change of -7 to +6 from the last value, 0 n repeats the last value n+2 times,
+// and 15 is followed by the value as 4 nibbles.  The data is padded out to a whole byte with an 8 (no change.)
+// At most one bin in eight is written as a full value, past that larger changes are slewed at -7 to +6 a bin, so the
+// data is never longer than PEC_HIRES_NV_BYTES() (Globals.h) which is the space set aside for it in NV.  The bins that
+// come out different are counted in pecEncodeSlewed.
+#define PEC_NV_HEADER 6
+long pecEncodeSlewed=0;
+
+byte *pecNibbles; int pecNibble;
+void pecPutNibble(byte n) {
+  if (pecNibble&1) pecNibbles[pecNibble/2]|=n; else pecNibbles[pecNibble/2]=n<<4;
+  pecNibble++;
+}
+byte pecGetNibble() {
+  byte n=pecNibbles[pecNibble/2]; if (!(pecNibble&1)) n>>=4;
+  pecNibble++;
+  return n&15;
+}
+
+// encodes the table into b, returns the length in bytes or 0 if it's larger than max
+int pecEncode(byte *b, int max) {
+  long N=PecBinsPerWormRotationAxis1;
+  pecNibbles=&b[PEC_NV_HEADER]; pecNibble=0;
+  long room=(max-PEC_NV_HEADER)*2L;
+  long values=N/8;
+  int last=0;
+  pecEncodeSlewed=0;
+  for (long i=0; i < N; ) {
+    int v=pecGet(i);
+    int run=0; while ((i+run < N) && (run < 17) && (pecGet(i+run) == last)) run++;
+    if (run >= 2) {
+      if (pecNibble+2 > room) return 0;
+      pecPutNibble(0); pecPutNibble(run-2); i+=run; continue;
+    }
+    int d=v-last;
+    if ((d < -7 || d > 6) && (values > 0)) {
+      if (pecNibble+5 > room) return 0;
+      pecPutNibble(15);
+      for (int s=12; s >= 0; s-=4) pecPutNibble(((uint16_t)v>>s)&15);
+      values--; last=v;
+    } else {
+      if (pecNibble+1 > room) return 0;
+      if (d < -7) d=-7;
+      if (d > 6) d=6;
+      pecPutNibble(d+8); last+=d;
+      if (last != v) pecEncodeSlewed++;
+    }
+    i++;
+  }
+  if (pecNibble&1) { if (pecNibble+1 > room) return 0; pecPutNibble(8); }
+  uint16_t count=N, length=pecNibble/2, crc=crc16(&b[PEC_NV_HEADER],length);
+  memcpy(&b[0],&count,2); memcpy(&b[2],&length,2); memcpy(&b[4],&crc,2);
+  return PEC_NV_HEADER+length;
+}
+
+// decodes the table from b, false if it doesn't match the current table size
+bool pecDecode(byte *b) {
+  uint16_t count, length, crc;
+  memcpy(&count,&b[0],2); memcpy(&length,&b[2],2); memcpy(&crc,&b[4],2);
+  if ((count != PecBinsPerWormRotationAxis1) || (PEC_NV_HEADER+length > pecTableBytes)) return false;
+  if (crc16(&b[PEC_NV_HEADER],length) != crc) return false;
+  pecNibbles=&b[PEC_NV_HEADER]; pecNibble=0;
+  int last=0;
+  for (long i=0; i < count; ) {
+    if (pecNibble >= length*2) return false;
+    byte n=pecGetNibble();
+    if (n == 0) { int run=pecGetNibble()+2; while ((run-- > 0) && (i < count)) pecSet(i++,last); continue; }
+    if (n == 15) { uint16_t v=0; for (int s=0; s < 4; s++) v=(v<<4)|pecGetNibble(); last=(int16_t)v; } else last+=n-8;
+    pecSet(i++,last);
+  }
+  return true;
+}
+
+// reads the table from EEPROM, on failure the table is left zeroed and false returned
+bool pecLoad() {
+  for (int i=0; i < pecBufferSize; i++) pecSet(i,0);
+  if (pecShadow == NULL) return false;
+  nv.readBytes(EE_pecTable,pecShadow,PEC_NV_HEADER);
+  uint16_t length; memcpy(&length,&pecShadow[2],2);
+  if (PEC_NV_HEADER+length > pecTableBytes) return false;
+  for (int i=PEC_NV_HEADER; i < PEC_NV_HEADER+length; i+=64) {
+    int n=PEC_NV_HEADER+length-i; if (n > 64) n=64;
+    nv.readBytes(EE_pecTable+i,&pecShadow[i],n);
+  }
+  if (pecDecode(pecShadow)) return true;
+  for (int i=0; i < pecBufferSize; i++) pecSet(i,0);
+  return false;
+}
+
+// starts writing the PEC table to EEPROM, a save already under way starts over with the latest table
+// false if there's no room for it, or if bins had to be slewed (the closest table that fits is still written, and
+// pecSaveSlewed is set so :$QZ? can say the table in NV isn't the one in RAM)
+bool pecSave() {
+  if (pecShadow == NULL) return false;
+  int n=pecEncode(pecShadow,pecTableBytes);
+  if (n == 0) { pecAutoRecord=0; return false; }
+  pecSaveSize=n;
+  pecAutoRecord=n;
+  pecSaveSlewed=(pecEncodeSlewed > 0);
+  return !pecSaveSlewed;
+}
+#else
+// starts writing the PEC table to EEPROM, a save already under way starts over with the latest table
+bool pecSave() {
+  if (pecShadow != NULL) memcpy(pecShadow,pecBuffer,pecBufferSize);
+  pecSaveSize=pecBufferSize;
+  pecAutoRecord=pecBufferSize;
+  return true;
+}
+#endif
+
+// writes the next block of the PEC table, called once a 1/100 second while pecAutoRecord > 0
+// blocks end on NV_BLOCK_SIZE boundaries (EEPROM pages,) and wait while the I2C bus is busy (an EEPROM write cycle)
+void pecSavePoll() {
+  if (!i2cBus.idle()) return;
+  byte *b=(pecShadow != NULL)?pecShadow:(byte*)pecBuffer;
+  int i=pecSaveSize-pecAutoRecord;
+  int n=NV_BLOCK_SIZE-(EE_pecTable+i)%NV_BLOCK_SIZE; if (n > pecAutoRecord) n=pecAutoRecord;
+  nv.writeBytes(EE_pecTable+i,&b[i],n);
+  pecAutoRecord-=n;
 }
 
 #endif
@@ -58,13 +58,88 @@ void SiderealClockSetInterval(long iv) {
   isrTimerRateAxis2=0;
 }
 
+#if TIMER_RATE_TABLE == ON
+// Axis1 timer intervals (in microseconds*16) for each PEC correction (-127 to +127 steps per second) with
+// the guide rate off, at +guideTimerBaseRateAxis1, and at -guideTimerBaseRateAxis1.  These are rebuilt
+// from the main loop when the guide rate, PPS rate ratio, or sidereal rate change, or the tracking rate
+// moves far enough from the one the table was built for that the intervals would be off by more than
+// RATE_TABLE_TOLERANCE timer counts (at the sidereal rate.)  So rate compensation, which changes the
+// tracking rate a little every second, only rebuilds it now and then.  It's not used during a sync
+#define RATE_TABLE_PEC_STEPS 127
+#define RATE_TABLE_SIZE (RATE_TABLE_PEC_STEPS*2+1)
+#define RATE_TABLE_TOLERANCE 0.25
+
+rateTableEntry_t rateTableAxis1[3][RATE_TABLE_SIZE];
+volatile boolean rateTableValidAxis1 = false;
+double rateTableTrackingRate = 0.0;   // the tracking rate the table is good for, the ISR looks for this exactly
+double rateTableBuiltRate = 0.0;      // and the one it was built for
+double rateTableGuideRate = 0.0;
+double rateTablePPSrateRatio = 0.0;
+long rateTableSiderealRate = 0;
+
+// returns the entry for the Axis1 guide rate (guideA) and the current PEC correction, or NULL if not in the table
+// called from within the sidereal timer ISR
+const rateTableEntry_t *rateTableLookupAxis1(double guideA) {
+  if (!rateTableValidAxis1) return NULL;
+  if ((trackingTimerRateAxis1 != rateTableTrackingRate) || (PPSrateRatio != rateTablePPSrateRatio) || (SiderealRate != rateTableSiderealRate)) return NULL;
+  int g;
+  if (guideA == 0.0) g=0; else if (guideA == rateTableGuideRate) g=1; else if (guideA == -rateTableGuideRate) g=2; else return NULL;
+  int p=pecStepsAxis1;
+  if ((p < -RATE_TABLE_PEC_STEPS) || (p > RATE_TABLE_PEC_STEPS)) return NULL;
+  const rateTableEntry_t *e=&rateTableAxis1[g][p+RATE_TABLE_PEC_STEPS];
+  if (e->interval == 0) return NULL;
+  return e;
+}
+
+// rebuilds the table if any of the rates it depends on have changed
+void rateTablePoll() {
+  cli();
+  double trackingRate=trackingTimerRateAxis1;
+  double ppsRatio=PPSrateRatio;
+  sei();
+  double guideRate=fabs(guideTimerBaseRateAxis1);
+  if (trackingSyncSeconds > 0) { if (rateTableValidAxis1) { cli(); rateTableValidAxis1=false; sei(); } return; }
+  if (rateTableValidAxis1 && (guideRate == rateTableGuideRate) && (ppsRatio == rateTablePPSrateRatio) && (SiderealRate == rateTableSiderealRate)) {
+    if (trackingRate == rateTableTrackingRate) return;
+    if (fabs(trackingRate-rateTableBuiltRate)*SiderealRate <= RATE_TABLE_TOLERANCE) { cli(); rateTableTrackingRate=trackingRate; sei(); return; }
+  }
+
+  // the ISR uses the original calculation until we're done
+  cli(); rateTableValidAxis1=false; sei();
+
+  for (int g=0; g < 3; g++) {
+    double guideA=0.0; if (g == 1) guideA=guideRate; else if (g == 2) guideA=-guideRate;
+    for (int p=-RATE_TABLE_PEC_STEPS; p <= RATE_TABLE_PEC_STEPS; p++) {
+      rateTableEntry_t *e=&rateTableAxis1[g][p+RATE_TABLE_PEC_STEPS];
+      // same as timerSupervisor()
+      double timerRateAxis1B=guideA+((double)p/StepsPerSecondAxis1)+trackingRate;
+      if (fabs(timerRateAxis1B) <= 0.00001) { e->interval=0; e->preset=0; continue; }
+      long iv=round((double)SiderealRate/fabs(timerRateAxis1B));
+      e->preset=iv/ppsRatio;
+      e->interval=(timerRateAxis1B < 0) ? -iv : iv;
+    }
+  }
+
+  cli();
+  rateTableTrackingRate=trackingRate; rateTableBuiltRate=trackingRate; rateTableGuideRate=guideRate; rateTablePPSrateRatio=ppsRatio; rateTableSiderealRate=SiderealRate;
+  rateTableValidAxis1=true;
+  sei();
+}
+#endif
+
 //--------------------------------------------------------------------------------------------------
 // Timer1 handles sidereal time and setting up the Axis1/2 intervals for later programming
 volatile boolean gotoRateAxis1=false;
 volatile boolean gotoRateAxis2=false;
 volatile byte siderealClockCycleCount=0;
+#if TIMER_FIXED_POINT == ON
+// rates (x sidereal) are Q16.16 fixed point where 1.0 = 65536, Q8.24 where 1.0 = 2^24, or Q32.32 where 1.0 = 2^32
+volatile long guideTimerRateAxis1AQ=0;
+volatile long guideTimerRateAxis2AQ=0;
+#else
 volatile double guideTimerRateAxis1A=0.0;
 volatile double guideTimerRateAxis2A=0.0;
+#endif
 volatile byte guideDirChangeTimerAxis1=0;
 volatile byte lastGuideDirAxis1=0;
 volatile byte guideDirChangeTimerAxis2=0;
@@ -79,6 +154,7 @@ IRAM_ATTR ISR(TIMER1_COMPA_vect)
 #ifdef HAL_TIMER1_PREFIX
   HAL_TIMER1_PREFIX;
 #endif
+  PROFILE_START(PROFILE_TIMER1);
 
   // run at 3x the rate, unless a goto is happening
   bool centiSecond=true;
@@ -99,20 +175,129 @@ IRAM_ATTR ISR(TIMER1_COMPA_vect)
   }
 
 #ifndef ESP32
-  timerSupervisor(centiSecond);
+  { PROFILE_START(PROFILE_SUPERVISOR); timerSupervisor(centiSecond); PROFILE_END(PROFILE_SUPERVISOR); }
 #endif
 
 #ifndef HAL_FAST_PROCESSOR
 done: {}
 #endif
 
+  PROFILE_END(PROFILE_TIMER1);
 #ifdef HAL_TIMER1_SUFFIX
   HAL_TIMER1_SUFFIX;
 #endif
 }
 
 void timerSupervisor(bool isCentiSecond) {
+#if TIMER_RATE_TABLE == ON
+  const rateTableEntry_t *rateEntryAxis1=NULL;
+#endif
   if (trackingState != TrackingMoveTo) {
+#if TIMER_FIXED_POINT == ON
+    // automatic rate calculation HA
+    long calculatedTimerRateAxis1;
+
+    // guide rate acceleration/deceleration and control
+    long gtr1=guideTimerRateAxis1Q;
+    if (guideDirAxis1) {
+      if ((labs(gtr1) < 10L*65536L) && (labs(guideTimerRateAxis1AQ) < 10L*65536L)) {
+        // slow speed guiding, no acceleration
+        guideTimerRateAxis1AQ=gtr1; 
+        // break
+        if (guideDirAxis1 == 'b') { guideDirAxis1=0; guideTimerRateAxis1=0.0; guideTimerRateAxis1Q=0; guideTimerRateAxis1AQ=0; }
+      } else {
+        if ((isCentiSecond) && (!inbacklashAxis1)) {
+          // high speed guiding
+          stepperModeGoto();
+
+          // at higher step rates where torque is reduced make smaller rate changes
+          long r=guideRampStepQ16(guideTimerRateAxis1AQ);
+  
+          // acceleration/deceleration control
+          if ((guideDirAxis1 != lastGuideDirAxis1) && (lastGuideDirAxis1 != 0)) guideDirChangeTimerAxis1=25;
+          lastGuideDirAxis1=guideDirAxis1;
+  
+          if (guideDirAxis1 == 'b') gtr1=0;
+          if (guideDirChangeTimerAxis1 > 0) guideDirChangeTimerAxis1--; else {
+            if (guideTimerRateAxis1AQ > gtr1) { guideTimerRateAxis1AQ-=r; if (guideTimerRateAxis1AQ < gtr1) guideTimerRateAxis1AQ=gtr1; }
+            if (guideTimerRateAxis1AQ < gtr1) { guideTimerRateAxis1AQ+=r; if (guideTimerRateAxis1AQ > gtr1) guideTimerRateAxis1AQ=gtr1; }
+          }
+  
+          // stop guiding
+          if (guideDirAxis1 == 'b') {
+            if (labs(guideTimerRateAxis1AQ) < 66L) { guideDirAxis1=0; lastGuideDirAxis1=0; guideTimerRateAxis1=0.0; guideTimerRateAxis1Q=0; guideTimerRateAxis1AQ=0; guideDirChangeTimerAxis1=0; if (!guideDirAxis2) stepperModeTracking(false); }
+          }
+        }
+      }
+    } else guideTimerRateAxis1AQ=0;
+
+    int64_t timerRateAxis1B=((int64_t)guideTimerRateAxis1AQ<<16)+((int64_t)(pecTimerRateAxis1Q+trackingTimerRateAxis1Q)<<8);
+    if (timerRateAxis1B < -42950LL) { timerRateAxis1B=-timerRateAxis1B; cli(); timerDirAxis1=-1; sei(); } else 
+      if (timerRateAxis1B > 42950LL) { cli(); timerDirAxis1=1; sei(); } else { cli(); timerDirAxis1=0; sei(); timerRateAxis1B=1LL<<32; }
+    // only do the divide when the rate changes
+    static int64_t lastTimerRateAxis1B=0;
+    static long lastCalculatedTimerRateAxis1=0;
+    static long lastSiderealRateAxis1=0;
+    if ((timerRateAxis1B != lastTimerRateAxis1B) || (SiderealRate != lastSiderealRateAxis1)) {
+      lastTimerRateAxis1B=timerRateAxis1B; lastSiderealRateAxis1=SiderealRate;
+      lastCalculatedTimerRateAxis1=rateToIntervalQ32(timerRateAxis1B);
+    }
+    calculatedTimerRateAxis1=lastCalculatedTimerRateAxis1;
+    // remember our "running" rate and only update the actual rate when it changes
+    if (runTimerRateAxis1 != calculatedTimerRateAxis1) { timerRateAxis1=calculatedTimerRateAxis1; runTimerRateAxis1=calculatedTimerRateAxis1; }
+
+    // automatic rate calculation Dec
+    long calculatedTimerRateAxis2;
+
+    // guide rate acceleration/deceleration
+    long gtr2=guideTimerRateAxis2Q;
+    if (guideDirAxis2) {
+      if ((labs(gtr2) < 10L*65536L) && (labs(guideTimerRateAxis2AQ) < 10L*65536L)) {
+        // slow speed guiding, no acceleration
+        guideTimerRateAxis2AQ=gtr2; 
+        // break mode
+        if (guideDirAxis2 == 'b') { guideDirAxis2=0; guideTimerRateAxis2=0.0; guideTimerRateAxis2Q=0; guideTimerRateAxis2AQ=0; }
+      } else {
+        if ((isCentiSecond) && (!inbacklashAxis2)) {
+          // use acceleration
+          stepperModeGoto();
+  
+          // at higher step rates where torque is reduced make smaller rate changes
+          long r=guideRampStepQ16(guideTimerRateAxis2AQ);
+  
+          // acceleration/deceleration control
+          if ((guideDirAxis2 != lastGuideDirAxis2) && (lastGuideDirAxis2 != 0)) guideDirChangeTimerAxis2=25;
+          lastGuideDirAxis2=guideDirAxis2;
+  
+          if (guideDirAxis2 == 'b') gtr2=0;
+          if (guideDirChangeTimerAxis2 > 0) guideDirChangeTimerAxis2--; else {
+            if (guideTimerRateAxis2AQ > gtr2) { guideTimerRateAxis2AQ-=r; if (guideTimerRateAxis2AQ < gtr2) guideTimerRateAxis2AQ=gtr2; }
+            if (guideTimerRateAxis2AQ < gtr2) { guideTimerRateAxis2AQ+=r; if (guideTimerRateAxis2AQ > gtr2) guideTimerRateAxis2AQ=gtr2; }
+          }
+  
+          // stop guiding
+          if (guideDirAxis2 == 'b') {
+            if (labs(guideTimerRateAxis2AQ) < 66L) { guideDirAxis2=0; lastGuideDirAxis2=0; guideTimerRateAxis2=0.0; guideTimerRateAxis2Q=0; guideTimerRateAxis2AQ=0; guideDirChangeTimerAxis2=0; if (!guideDirAxis1) stepperModeTracking(false); }
+          }
+        }
+      }
+    } else guideTimerRateAxis2AQ=0;
+
+    int64_t timerRateAxis2B=((int64_t)guideTimerRateAxis2AQ<<16)+((int64_t)trackingTimerRateAxis2Q<<8);
+    if (timerRateAxis2B < -429497LL) { timerRateAxis2B=-timerRateAxis2B; cli(); timerDirAxis2=-1; sei(); } else
+      if (timerRateAxis2B > 429497LL) { cli(); timerDirAxis2=1; sei(); } else { cli(); timerDirAxis2=0; sei(); timerRateAxis2B=1LL<<32; }
+    // only do the divide when the rate changes
+    static int64_t lastTimerRateAxis2B=0;
+    static long lastCalculatedTimerRateAxis2=0;
+    static long lastSiderealRateAxis2=0;
+    if ((timerRateAxis2B != lastTimerRateAxis2B) || (SiderealRate != lastSiderealRateAxis2)) {
+      lastTimerRateAxis2B=timerRateAxis2B; lastSiderealRateAxis2=SiderealRate;
+      lastCalculatedTimerRateAxis2=rateToIntervalQ32(timerRateAxis2B);
+    }
+    calculatedTimerRateAxis2=lastCalculatedTimerRateAxis2;
+    // remember our "running" rate and only update the actual rate when it changes
+    if (runTimerRateAxis2 != calculatedTimerRateAxis2) { timerRateAxis2=calculatedTimerRateAxis2; runTimerRateAxis2=calculatedTimerRateAxis2; }
+#else
     // automatic rate calculation HA
     long calculatedTimerRateAxis1;
 
@@ -150,11 +335,21 @@ void timerSupervisor(bool isCentiSecond) {
       }
     } else guideTimerRateAxis1A=0.0;
 
+#if TIMER_RATE_TABLE == ON
+    // use the precomputed interval when available
+    rateEntryAxis1=rateTableLookupAxis1(guideTimerRateAxis1A);
+    if (rateEntryAxis1 != NULL) {
+      if (rateEntryAxis1->interval < 0) { cli(); timerDirAxis1=-1; sei(); calculatedTimerRateAxis1=-rateEntryAxis1->interval; } else { cli(); timerDirAxis1=1; sei(); calculatedTimerRateAxis1=rateEntryAxis1->interval; }
+    } else {
+#endif
     double timerRateAxis1A=trackingTimerRateAxis1;
     double timerRateAxis1B=guideTimerRateAxis1A+pecTimerRateAxis1+timerRateAxis1A;
     if (timerRateAxis1B < -0.00001) { timerRateAxis1B=fabs(timerRateAxis1B); cli(); timerDirAxis1=-1; sei(); } else 
       if (timerRateAxis1B > 0.00001) { cli(); timerDirAxis1=1; sei(); } else { cli(); timerDirAxis1=0; sei(); timerRateAxis1B=1.0; }
     calculatedTimerRateAxis1=round((double)SiderealRate/timerRateAxis1B);
+#if TIMER_RATE_TABLE == ON
+    }
+#endif
     // remember our "running" rate and only update the actual rate when it changes
     if (runTimerRateAxis1 != calculatedTimerRateAxis1) { timerRateAxis1=calculatedTimerRateAxis1; runTimerRateAxis1=calculatedTimerRateAxis1; }
 
@@ -202,6 +397,7 @@ void timerSupervisor(bool isCentiSecond) {
     calculatedTimerRateAxis2=round((double)SiderealRate/timerRateAxis2B);
     // remember our "running" rate and only update the actual rate when it changes
     if (runTimerRateAxis2 != calculatedTimerRateAxis2) { timerRateAxis2=calculatedTimerRateAxis2; runTimerRateAxis2=calculatedTimerRateAxis2; }
+#endif
   }
   
   thisTimerRateAxis1=timerRateAxis1;
@@ -224,6 +420,9 @@ void timerSupervisor(bool isCentiSecond) {
 
   // set the rates
   if (thisTimerRateAxis1 != isrTimerRateAxis1) {
+#if TIMER_RATE_TABLE == ON
+    if ((rateEntryAxis1 != NULL) && (thisTimerRateAxis1 == labs(rateEntryAxis1->interval))) PresetTimerInterval(rateEntryAxis1->preset, TIMER_PULSE_STEP_MULTIPLIER, &nextAxis1Rate, &slowAxis1Rep); else
+#endif
     PresetTimerInterval(thisTimerRateAxis1/PPSrateRatio, TIMER_PULSE_STEP_MULTIPLIER, &nextAxis1Rate, &slowAxis1Rep);
     isrTimerRateAxis1=thisTimerRateAxis1;
   }
@@ -233,172 +432,258 @@ void timerSupervisor(bool isCentiSecond) {
   }
 }
 
-IRAM_ATTR ISR(TIMER3_COMPA_vect)
-{
-#ifdef HAL_TIMER3_PREFIX
-  HAL_TIMER3_PREFIX;
-#endif
-
-  if (slowAxis1Rep > 1) { slowAxis1Cnt++; if (slowAxis1Cnt%slowAxis1Rep != 0) goto done; }
+#if TIMER_FIXED_POINT == ON
+// guide rate acceleration/deceleration amount per 1/100 second (Q16.16) for the current guide rate (Q16.16)
+// this is (accXPerSec/100)*r where r=1.2-sqrt(|rate|/slewRateX) limited to 0.2..1.2, r is Q8.8 here
+long guideRampStepQ16(long rateQ16) {
+  // isqrt32() of a Q16.16 value is Q8.8
+  long r=307L-(long)(((unsigned long)isqrt32(labs(rateQ16))*slewRateXInvSqrtQ16)>>16);
+  if (r < 51L) r=51L; if (r > 307L) r=307L;
+  return (accXPerCsQ16*r)>>8;
+}
 
-#if STEP_WAVE_FORM != DEDGE
-  StepPinAxis1_LOW;
+// timer interval (in microseconds*16) for rate (Q32.32, > 0,) same as round(SiderealRate/rate)
+// the rate is cut to a 31 bit mantissa m (rate=m/2^p) and SiderealRate*2^p/m is divided out a bit at a time, all in 32 bits
+long rateToIntervalQ32(int64_t rateQ32) {
+  uint32_t hi=(uint64_t)rateQ32>>32, m=(uint32_t)rateQ32;
+  int p=32;
+  while ((hi != 0) || (m >= 0x80000000UL)) { m=(m>>1)|(hi<<31); hi>>=1; p--; }
+
+  uint32_t s=SiderealRate, q=0, rem=0;
+  int bits=32; while ((bits > 0) && !(s & 0x80000000UL)) { s<<=1; bits--; }
+  for (bits+=p; bits > 0; bits--) {
+    rem=(rem<<1)|(s>>31); s<<=1;
+    q<<=1; if (rem >= m) { rem-=m; q|=1; }
+  }
+  if ((rem<<1) >= m) q++;
+  return (long)q;
+}
 #endif
 
+//--------------------------------------------------------------------------------------------------
+// Motor timers, both ISR's are generated from one axisStepper<> implementation using each axis' traits
+
+// the traits are resolved at compile time and everything inlines into the ISR, there's no runtime overhead
+#define AXIS_INLINE inline __attribute__((always_inline))
+
+struct axis1Traits {
+  static AXIS_INLINE volatile uint16_t &slowRep() { return slowAxis1Rep; }
+  static AXIS_INLINE volatile uint16_t &slowCnt() { return slowAxis1Cnt; }
+  static AXIS_INLINE uint32_t nextRate() { return nextAxis1Rate; }
+  static AXIS_INLINE void quickSetInterval(uint32_t r) { QuickSetIntervalAxis1(r); }
+
+  static AXIS_INLINE void stepLow() { StepPinAxis1_LOW; }
+  static AXIS_INLINE void stepHigh() { StepPinAxis1_HIGH; }
+  static AXIS_INLINE void dirLow() { DirPinAxis1_LOW; }
+  static AXIS_INLINE void dirHigh() { DirPinAxis1_HIGH; }
+  static const bool reverse = (AXIS1_DRIVER_REVERSE == ON);
+
+  static AXIS_INLINE volatile long &pos() { return posAxis1; }
+  static AXIS_INLINE volatile fixed_t &target() { return targetAxis1; }
+  static AXIS_INLINE long step() { return stepAxis1; }
+  static AXIS_INLINE long timerDir() { return timerDirAxis1; }
+  static AXIS_INLINE volatile byte &dir() { return dirAxis1; }
+  static AXIS_INLINE byte defaultDir() { return defaultDirAxis1; }
+  static AXIS_INLINE bool powered() { return true; }
+
+  static AXIS_INLINE volatile int &bl() { return blAxis1; }
+  static AXIS_INLINE int backlash() { return backlashAxis1; }
+  static AXIS_INLINE volatile boolean &inBacklash() { return inbacklashAxis1; }
+
 #if STEP_WAVE_FORM == SQUARE
-  if (clearAxis1) {
-    takeStepAxis1=false;
+  static AXIS_INLINE volatile boolean &clear() { return clearAxis1; }
+  static AXIS_INLINE volatile boolean &takeStep() { return takeStepAxis1; }
+#elif STEP_WAVE_FORM == DEDGE
+  static AXIS_INLINE volatile byte &toggleState() { return toggleStateAxis1; }
 #endif
 
 #if defined(AXIS1_DRIVER_MICROSTEP_CODE) && defined(AXIS1_DRIVER_MICROSTEP_CODE_GOTO) && MODE_SWITCH_BEFORE_SLEW == OFF
-  // switch micro-step mode
-  if (gotoModeAxis1 != gotoRateAxis1) {
-    // only when at an allowed position
-    if ((gotoModeAxis1) || ((posAxis1+blAxis1)%AXIS1_DRIVER_STEP_GOTO == 0)) {
-      // switch mode
-      if (gotoModeAxis1) { stepAxis1=1; AXIS1_DRIVER_MICROSTEP_CODE_NEXT=AXIS1_DRIVER_MICROSTEP_CODE; gotoModeAxis1=false; } else { stepAxis1=AXIS1_DRIVER_STEP_GOTO; AXIS1_DRIVER_MICROSTEP_CODE_NEXT=AXIS1_DRIVER_MICROSTEP_CODE_GOTO; gotoModeAxis1=true; }
-      digitalWrite(Axis1_M0,(AXIS1_DRIVER_MICROSTEP_CODE_NEXT & 1));
-      digitalWrite(Axis1_M1,(AXIS1_DRIVER_MICROSTEP_CODE_NEXT>>1 & 1));
-      #ifndef AXIS1_DRIVER_DISABLE_M2
-        digitalWrite(Axis1_M2,(AXIS1_DRIVER_MICROSTEP_CODE_NEXT>>2 & 1));
-      #endif
-    }
+  static const bool modeSwitch = true;
+  static const long stepGoto = AXIS1_DRIVER_STEP_GOTO;
+  static AXIS_INLINE bool gotoMode() { return gotoModeAxis1; }
+  static AXIS_INLINE bool gotoRate() { return gotoRateAxis1; }
+  static AXIS_INLINE void setGotoMode(bool g) {
+    if (g) { stepAxis1=AXIS1_DRIVER_STEP_GOTO; AXIS1_DRIVER_MICROSTEP_CODE_NEXT=AXIS1_DRIVER_MICROSTEP_CODE_GOTO; } else { stepAxis1=1; AXIS1_DRIVER_MICROSTEP_CODE_NEXT=AXIS1_DRIVER_MICROSTEP_CODE; }
+    gotoModeAxis1=g;
+    digitalWrite(Axis1_M0,(AXIS1_DRIVER_MICROSTEP_CODE_NEXT & 1));
+    digitalWrite(Axis1_M1,(AXIS1_DRIVER_MICROSTEP_CODE_NEXT>>1 & 1));
+    #ifndef AXIS1_DRIVER_DISABLE_M2
+      digitalWrite(Axis1_M2,(AXIS1_DRIVER_MICROSTEP_CODE_NEXT>>2 & 1));
+    #endif
   }
+#else
+  static const bool modeSwitch = false;
+  static const long stepGoto = 1;
+  static AXIS_INLINE bool gotoMode() { return false; }
+  static AXIS_INLINE bool gotoRate() { return false; }
+  static AXIS_INLINE void setGotoMode(bool g) { (void)g; }
 #endif
+};
+
+struct axis2Traits {
+  static AXIS_INLINE volatile uint16_t &slowRep() { return slowAxis2Rep; }
+  static AXIS_INLINE volatile uint16_t &slowCnt() { return slowAxis2Cnt; }
+  static AXIS_INLINE uint32_t nextRate() { return nextAxis2Rate; }
+  static AXIS_INLINE void quickSetInterval(uint32_t r) { QuickSetIntervalAxis2(r); }
+
+  static AXIS_INLINE void stepLow() { StepPinAxis2_LOW; }
+  static AXIS_INLINE void stepHigh() { StepPinAxis2_HIGH; }
+  static AXIS_INLINE void dirLow() { DirPinAxis2_LOW; }
+  static AXIS_INLINE void dirHigh() { DirPinAxis2_HIGH; }
+  static const bool reverse = (AXIS2_DRIVER_REVERSE == ON);
+
+  static AXIS_INLINE volatile long &pos() { return posAxis2; }
+  static AXIS_INLINE volatile fixed_t &target() { return targetAxis2; }
+  static AXIS_INLINE long step() { return stepAxis2; }
+  static AXIS_INLINE long timerDir() { return timerDirAxis2; }
+  static AXIS_INLINE volatile byte &dir() { return dirAxis2; }
+  static AXIS_INLINE byte defaultDir() { return defaultDirAxis2; }
+  static AXIS_INLINE bool powered() { return axis2Powered; }
+
+  static AXIS_INLINE volatile int &bl() { return blAxis2; }
+  static AXIS_INLINE int backlash() { return backlashAxis2; }
+  static AXIS_INLINE volatile boolean &inBacklash() { return inbacklashAxis2; }
 
-#if STEP_WAVE_FORM != SQUARE
-  QuickSetIntervalAxis1(nextAxis1Rate*stepAxis1);
+#if STEP_WAVE_FORM == SQUARE
+  static AXIS_INLINE volatile boolean &clear() { return clearAxis2; }
+  static AXIS_INLINE volatile boolean &takeStep() { return takeStepAxis2; }
+#elif STEP_WAVE_FORM == DEDGE
+  static AXIS_INLINE volatile byte &toggleState() { return toggleStateAxis2; }
 #endif
 
-  if ((trackingState != TrackingMoveTo) && (!inbacklashAxis1)) targetAxis1.part.m+=timerDirAxis1*stepAxis1;
-
-  // move the RA/Azm stepper to the target
-  if ((posAxis1 != (long)targetAxis1.part.m) || inbacklashAxis1) {
-
-    // set direction
-    if (posAxis1 < (long)targetAxis1.part.m) dirAxis1=1; else dirAxis1=0;
-    #if AXIS1_DRIVER_REVERSE == ON
-      if (defaultDirAxis1 == dirAxis1) DirPinAxis1_LOW; else DirPinAxis1_HIGH;
-    #else
-      if (defaultDirAxis1 == dirAxis1) DirPinAxis1_HIGH; else DirPinAxis1_LOW;
+#if defined(AXIS2_DRIVER_MICROSTEP_CODE) && defined(AXIS2_DRIVER_MICROSTEP_CODE_GOTO) && MODE_SWITCH_BEFORE_SLEW == OFF
+  static const bool modeSwitch = true;
+  static const long stepGoto = AXIS2_DRIVER_STEP_GOTO;
+  static AXIS_INLINE bool gotoMode() { return gotoModeAxis2; }
+  static AXIS_INLINE bool gotoRate() { return gotoRateAxis2; }
+  static AXIS_INLINE void setGotoMode(bool g) {
+    if (g) { stepAxis2=AXIS2_DRIVER_STEP_GOTO; AXIS2_DRIVER_MICROSTEP_CODE_NEXT=AXIS2_DRIVER_MICROSTEP_CODE_GOTO; } else { stepAxis2=1; AXIS2_DRIVER_MICROSTEP_CODE_NEXT=AXIS2_DRIVER_MICROSTEP_CODE; }
+    gotoModeAxis2=g;
+    digitalWrite(Axis2_M0,(AXIS2_DRIVER_MICROSTEP_CODE_NEXT & 1));
+    digitalWrite(Axis2_M1,(AXIS2_DRIVER_MICROSTEP_CODE_NEXT>>1 & 1));
+    #ifndef AXIS2_DRIVER_DISABLE_M2
+      digitalWrite(Axis2_M2,(AXIS2_DRIVER_MICROSTEP_CODE_NEXT>>2 & 1));
     #endif
-  
-    // telescope moves WEST with the sky, blAxis1 is the amount of EAST backlash
-    if (dirAxis1 == 1) {
-      if (blAxis1 < backlashAxis1) { blAxis1+=stepAxis1; inbacklashAxis1=true; } else { inbacklashAxis1=false; posAxis1+=stepAxis1; }
-    } else {
-      if (blAxis1 > 0)             { blAxis1-=stepAxis1; inbacklashAxis1=true; } else { inbacklashAxis1=false; posAxis1-=stepAxis1; }
-    }
-
-#if STEP_WAVE_FORM == SQUARE
-      takeStepAxis1=true;
-    }
-    clearAxis1=false;
-  } else { 
-    if (takeStepAxis1) StepPinAxis1_HIGH;
-    clearAxis1=true;
-
-    QuickSetIntervalAxis1(nextAxis1Rate*stepAxis1);
   }
 #else
-#if STEP_WAVE_FORM == DEDGE
-    toggleStateAxis1++;
-    if (toggleStateAxis1%2 == 0) StepPinAxis1_LOW; else StepPinAxis1_HIGH;
-#else
-    StepPinAxis1_HIGH;
-#endif
-  }
-#endif
-
-done: {}
-#ifdef HAL_TIMER3_SUFFIX
-  HAL_TIMER3_SUFFIX;
-#endif
-}
-
-IRAM_ATTR ISR(TIMER4_COMPA_vect)
-{
-#ifdef HAL_TIMER4_PREFIX
-  HAL_TIMER4_PREFIX;
+  static const bool modeSwitch = false;
+  static const long stepGoto = 1;
+  static AXIS_INLINE bool gotoMode() { return false; }
+  static AXIS_INLINE bool gotoRate() { return false; }
+  static AXIS_INLINE void setGotoMode(bool g) { (void)g; }
 #endif
+};
 
-  if (slowAxis2Rep > 1) { slowAxis2Cnt++; if (slowAxis2Cnt%slowAxis2Rep != 0) goto done; }
+template <class A> struct axisStepper {
+  static AXIS_INLINE void isr() {
+    if (A::slowRep() > 1) { A::slowCnt()++; if (A::slowCnt()%A::slowRep() != 0) return; }
 
 #if STEP_WAVE_FORM != DEDGE
-  StepPinAxis2_LOW;
+    A::stepLow();
 #endif
 
 #if STEP_WAVE_FORM == SQUARE
-  if (clearAxis2) {
-    takeStepAxis2=false;
+    if (A::clear()) {
+      A::takeStep()=false;
 #endif
 
-#if defined(AXIS2_DRIVER_MICROSTEP_CODE) && defined(AXIS2_DRIVER_MICROSTEP_CODE_GOTO) && MODE_SWITCH_BEFORE_SLEW == OFF
-  // switch micro-step mode
-  if (gotoModeAxis2 != gotoRateAxis2) {
-    // only when at an allowed position
-    if ((gotoModeAxis2) || ((posAxis2+blAxis2)%AXIS2_DRIVER_STEP_GOTO == 0)) {
-      // switch mode
-      if (gotoModeAxis2) { stepAxis2=1; AXIS2_DRIVER_MICROSTEP_CODE_NEXT=AXIS2_DRIVER_MICROSTEP_CODE; gotoModeAxis2=false; } else { stepAxis2=AXIS2_DRIVER_STEP_GOTO; AXIS2_DRIVER_MICROSTEP_CODE_NEXT=AXIS2_DRIVER_MICROSTEP_CODE_GOTO; gotoModeAxis2=true; }
-      digitalWrite(Axis2_M0,(AXIS2_DRIVER_MICROSTEP_CODE_NEXT & 1));
-      digitalWrite(Axis2_M1,(AXIS2_DRIVER_MICROSTEP_CODE_NEXT>>1 & 1));
-      #ifndef AXIS2_DRIVER_DISABLE_M2
-        digitalWrite(Axis2_M2,(AXIS2_DRIVER_MICROSTEP_CODE_NEXT>>2 & 1));
-      #endif
+    // switch micro-step mode, only when at an allowed position
+    if (A::modeSwitch && (A::gotoMode() != A::gotoRate())) {
+      if ((A::gotoMode()) || ((A::pos()+A::bl())%A::stepGoto == 0)) A::setGotoMode(!A::gotoMode());
     }
-  }
-#endif
 
 #if STEP_WAVE_FORM != SQUARE
-  QuickSetIntervalAxis2(nextAxis2Rate*stepAxis2);
+    A::quickSetInterval(A::nextRate()*A::step());
 #endif
 
-  if ((trackingState != TrackingMoveTo) && (!inbacklashAxis2)) targetAxis2.part.m+=timerDirAxis2*stepAxis2;
+    if ((trackingState != TrackingMoveTo) && (!A::inBacklash())) A::target().part.m+=A::timerDir()*A::step();
 
-  // move the Dec/Alt stepper to the target
-  if (axis2Powered && ((posAxis2 != (long)targetAxis2.part.m) || inbacklashAxis2)) {
-    
-    // set direction
-    if (posAxis2 < (long)targetAxis2.part.m) dirAxis2=1; else dirAxis2=0;
-    #if AXIS2_DRIVER_REVERSE == ON
-      if (defaultDirAxis2 == dirAxis2) DirPinAxis2_LOW; else DirPinAxis2_HIGH;
-    #else
-      if (defaultDirAxis2 == dirAxis2) DirPinAxis2_HIGH; else DirPinAxis2_LOW;
-    #endif
-   
-    // telescope moving toward celestial pole in the sky, blAxis2 is the amount of opposite backlash
-    if (dirAxis2 == 1) {
-      if (blAxis2 < backlashAxis2) { blAxis2+=stepAxis2; inbacklashAxis2=true; } else { inbacklashAxis2=false; posAxis2+=stepAxis2; }
-    } else {
-      if (blAxis2 > 0)             { blAxis2-=stepAxis2; inbacklashAxis2=true; } else { inbacklashAxis2=false; posAxis2-=stepAxis2; }
-    }
+    // move the stepper to the target
+    if (A::powered() && ((A::pos() != (long)A::target().part.m) || A::inBacklash())) {
+
+      // set direction
+      if (A::pos() < (long)A::target().part.m) A::dir()=1; else A::dir()=0;
+      if ((A::defaultDir() == A::dir()) != A::reverse) A::dirHigh(); else A::dirLow();
+
+      // bl is the amount of backlash taken up in the + direction
+      if (A::dir() == 1) {
+        if (A::bl() < A::backlash()) { A::bl()+=A::step(); A::inBacklash()=true; } else { A::inBacklash()=false; A::pos()+=A::step(); }
+      } else {
+        if (A::bl() > 0)             { A::bl()-=A::step(); A::inBacklash()=true; } else { A::inBacklash()=false; A::pos()-=A::step(); }
+      }
 
 #if STEP_WAVE_FORM == SQUARE
-      takeStepAxis2=true;
-    }
-    clearAxis2=false;
-  } else { 
-    if (takeStepAxis2) StepPinAxis2_HIGH;
-    clearAxis2=true;
+        A::takeStep()=true;
+      }
+      A::clear()=false;
+    } else {
+      if (A::takeStep()) A::stepHigh();
+      A::clear()=true;
 
-    QuickSetIntervalAxis2(nextAxis2Rate*stepAxis2);
-  }
+      A::quickSetInterval(A::nextRate()*A::step());
+    }
 #else
 #if STEP_WAVE_FORM == DEDGE
-    toggleStateAxis2++;
-    if (toggleStateAxis2%2 == 0) StepPinAxis2_LOW; else StepPinAxis2_HIGH;
+      A::toggleState()++;
+      if (A::toggleState()%2 == 0) A::stepLow(); else A::stepHigh();
 #else
-    StepPinAxis2_HIGH;
+      A::stepHigh();
+#endif
+    }
 #endif
   }
+};
+
+// RA/Azm, the telescope moves WEST with the sky and blAxis1 is the amount of EAST backlash
+IRAM_ATTR ISR(TIMER3_COMPA_vect)
+{
+#ifdef HAL_TIMER3_PREFIX
+  HAL_TIMER3_PREFIX;
 #endif
+  PROFILE_START(PROFILE_TIMER3);
+  axisStepper<axis1Traits>::isr();
+  PROFILE_END(PROFILE_TIMER3);
+#ifdef HAL_TIMER3_SUFFIX
+  HAL_TIMER3_SUFFIX;
+#endif
+}
 
-done: {}
+// Dec/Alt, moving toward the celestial pole and blAxis2 is the amount of opposite backlash
+IRAM_ATTR ISR(TIMER4_COMPA_vect)
+{
+#ifdef HAL_TIMER4_PREFIX
+  HAL_TIMER4_PREFIX;
+#endif
+  PROFILE_START(PROFILE_TIMER4);
+  axisStepper<axis2Traits>::isr();
+  PROFILE_END(PROFILE_TIMER4);
 #ifdef HAL_TIMER4_SUFFIX
   HAL_TIMER4_SUFFIX;
 #endif
 }
 
+#if defined(AUX_AXIS_TIMER_ON) && (ROTATOR == ON || FOCUSER1 == ON || FOCUSER2 == ON)
+// Rotator/focusers, each steps toward its target at up to AXISn_STEP_RATE_MAX
+IRAM_ATTR ISR(TIMER_AUX_vect)
+{
+#ifdef HAL_TIMER_AUX_PREFIX
+  HAL_TIMER_AUX_PREFIX;
+#endif
+#if ROTATOR == ON
+  rot.poll();
+#endif
+#if FOCUSER1 == ON
+  foc1.poll();
+#endif
+#if FOCUSER2 == ON
+  foc2.poll();
+#endif
+#ifdef HAL_TIMER_AUX_SUFFIX
+  HAL_TIMER_AUX_SUFFIX;
+#endif
+}
+#endif
+
 double getFrequencyHzAxis1() {
   if (trackingState == TrackingMoveTo) {
     if (posAxis1 == (long)targetAxis1.part.m) {
@@ -0,0 +1,124 @@
+// -----------------------------------------------------------------------------------
+// Minimal Arduino core API for host builds of OnStep, and main()
+
+// usage: OnStep [--seconds N] [--send T:CMD ...]
+//   the real-time build runs until stopped, clients connect on the /tmp/OnStep-Serial[A|B|C] ptys
+//   the simulator build runs N seconds of virtual time (default 10,) CMD is sent to SerialA at T seconds
+//   and SerialA's replies go to stdout, the step trace goes to OnStep.trace
+
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "Wire.h"
+
+#include <time.h>
+#include <unistd.h>
+
+TwoWire Wire;
+EEPROMClass EEPROM;
+
+int hostPinState[NUM_PINS];
+int hostPinMode[NUM_PINS];
+int hostAnalogValue[NUM_PINS];
+
+#ifdef HAL_LINUX_SIMULATOR
+  // from the Linux HAL's simulator (HAL_Sim.h, HAL_Serial.h)
+  unsigned long simMicros();
+  unsigned long simMillis();
+  void simRun(uint64_t ticks);
+  void simSerialInject(const char *s);
+
+  unsigned long millis() { return simMillis(); }
+  unsigned long micros() { return simMicros(); }
+  void delay(unsigned long ms) { simRun((uint64_t)ms*16000ULL); }
+  void delayMicroseconds(unsigned int us) { simRun((uint64_t)us*16ULL); }
+#else
+  static uint64_t hostNanos() {
+    struct timespec t; clock_gettime(CLOCK_MONOTONIC,&t);
+    return (uint64_t)t.tv_sec*1000000000ULL+t.tv_nsec;
+  }
+  static uint64_t hostStart=hostNanos();
+
+  unsigned long millis() { return (unsigned long)((hostNanos()-hostStart)/1000000ULL); }
+  unsigned long micros() { return (unsigned long)((hostNanos()-hostStart)/1000ULL); }
+  void delay(unsigned long ms) { usleep(ms*1000UL); }
+  void delayMicroseconds(unsigned int us) {
+    uint64_t until=hostNanos()+us*1000ULL;
+    while (hostNanos() < until) { }
+  }
+#endif
+void yield() { }
+
+static bool validPin(int pin) { return (pin >= 0) && (pin < NUM_PINS); }
+
+void pinMode(int pin, int mode) {
+  if (!validPin(pin)) return;
+  hostPinMode[pin]=mode;
+  if (mode == INPUT_PULLUP) hostPinState[pin]=HIGH;
+  if (mode == INPUT_PULLDOWN) hostPinState[pin]=LOW;
+}
+void digitalWrite(int pin, int value) { if (validPin(pin)) hostPinState[pin]=value?HIGH:LOW; }
+int digitalRead(int pin) { return validPin(pin)?hostPinState[pin]:LOW; }
+int analogRead(int pin) { return validPin(pin)?hostAnalogValue[pin]:0; }
+void analogWrite(int pin, int value) { if (validPin(pin)) hostAnalogValue[pin]=value; }
+void tone(int pin, unsigned int frequency, unsigned long duration) { (void)pin; (void)frequency; (void)duration; }
+void noTone(int pin) { (void)pin; }
+void hostPinInput(int pin, int value) { if (validPin(pin)) hostPinState[pin]=value; }
+
+// the same sequence every run, so simulator runs repeat exactly
+static unsigned long hostSeed=1;
+void randomSeed(unsigned long seed) { hostSeed=seed?seed:1; }
+long random(long howbig) {
+  if (howbig <= 0) return 0;
+  hostSeed=hostSeed*1103515245UL+12345UL;
+  return (long)((hostSeed>>16)%(unsigned long)howbig);
+}
+long random(long howsmall, long howbig) { if (howsmall >= howbig) return howsmall; return howsmall+random(howbig-howsmall); }
+
+char *dtostrf(double val, signed char width, unsigned char prec, char *s) { sprintf(s,"%*.*f",width,prec,val); return s; }
+
+char *ultoa(unsigned long val, char *s, int radix) {
+  char t[33]; int n=0;
+  do { int d=val%radix; t[n++]=d < 10?'0'+d:'a'+d-10; val/=radix; } while (val);
+  for (int i=0; i < n; i++) s[i]=t[n-1-i];
+  s[n]=0;
+  return s;
+}
+char *ltoa(long val, char *s, int radix) {
+  if ((val < 0) && (radix == 10)) { s[0]='-'; ultoa(-(unsigned long)val,&s[1],radix); return s; }
+  return ultoa((unsigned long)val,s,radix);
+}
+char *itoa(int val, char *s, int radix) {
+  if (radix != 10) return ultoa((unsigned int)val,s,radix);
+  return ltoa(val,s,radix);
+}
+
+#ifndef HOST_NO_MAIN
+int main(int argc, char **argv) {
+#ifdef HAL_LINUX_SIMULATOR
+  double seconds=10.0;
+  int sends=0; double sendAt[64]; const char *sendCmd[64];
+  for (int i=1; i < argc; i++) {
+    if ((strcmp(argv[i],"--seconds") == 0) && (i+1 < argc)) seconds=atof(argv[++i]); else
+    if ((strcmp(argv[i],"--send") == 0) && (i+1 < argc) && (sends < 64)) {
+      const char *s=argv[++i]; const char *c=strchr(s,':');
+      if (c == NULL) { fprintf(stderr,"--send needs T:CMD\n"); return 1; }
+      sendAt[sends]=atof(s); sendCmd[sends]=c+1; sends++;
+    } else { fprintf(stderr,"usage: %s [--seconds N] [--send T:CMD ...]\n",argv[0]); return 1; }
+  }
+
+  setup();
+  int next=0;
+  while (simMillis() < seconds*1000.0) {
+    while ((next < sends) && (simMillis() >= sendAt[next]*1000.0)) simSerialInject(sendCmd[next++]);
+    loop();
+    // a pass through the main loop takes about 50us on a Teensy3.2
+    simRun(50*16);
+  }
+  return 0;
+#else
+  (void)argc; (void)argv;
+  setup();
+  for (;;) loop();
+#endif
+}
+#endif
@@ -0,0 +1,118 @@
+// -----------------------------------------------------------------------------------
+// Minimal Arduino core API for host builds of OnStep (see ../CMakeLists.txt)
+
+// Just what the sketch and its libraries use: timing, pins (kept in a table so host tests can look at
+// or drive them), a few AVR-isms, and the usual macros.  With HAL_LINUX_SIMULATOR time is the
+// simulator's virtual clock and delay() advances it, otherwise it's CLOCK_MONOTONIC.
+
+#pragma once
+
+#include <ctype.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define INPUT_PULLDOWN 3
+
+#define DEC 10
+#define HEX 16
+
+#define PI 3.1415926535897932384626433832795
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+#define A6 20
+#define A7 21
+#define A8 22
+#define A9 23
+#define NUM_PINS 64
+
+#ifndef min
+  #define min(a,b) ((a)<(b)?(a):(b))
+#endif
+#ifndef max
+  #define max(a,b) ((a)>(b)?(a):(b))
+#endif
+#define constrain(x,l,h) ((x)<(l)?(l):((x)>(h)?(h):(x)))
+#define sq(x) ((x)*(x))
+#define radians(d) ((d)*DEG_TO_RAD)
+#define degrees(r) ((r)*RAD_TO_DEG)
+
+#define _BV(b) (1UL << (b))
+#define bitRead(v,b) (((v) >> (b)) & 0x01)
+#define bitSet(v,b) ((v) |= (1UL << (b)))
+#define bitClear(v,b) ((v) &= ~(1UL << (b)))
+#define bitWrite(v,b,x) ((x) ? bitSet(v,b) : bitClear(v,b))
+#define lowByte(w) ((uint8_t)((w) & 0xff))
+#define highByte(w) ((uint8_t)((w) >> 8))
+
+#define PROGMEM
+#define F(s) (s)
+#define pgm_read_byte(a) (*(const uint8_t*)(a))
+#define pgm_read_word(a) (*(const uint16_t*)(a))
+#define pgm_read_dword(a) (*(const uint32_t*)(a))
+#define pgm_read_float(a) (*(const float*)(a))
+#define strcpy_P strcpy
+#define strcat_P strcat
+#define strlen_P strlen
+#define sprintf_P sprintf
+
+// replaced by the Linux HAL with its ISR mutex
+#define cli()
+#define sei()
+#define noInterrupts() cli()
+#define interrupts() sei()
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int value);
+int digitalRead(int pin);
+int analogRead(int pin);
+void analogWrite(int pin, int value);
+void tone(int pin, unsigned int frequency, unsigned long duration=0);
+void noTone(int pin);
+
+// pins as seen by the host, a test can drive inputs with hostPinInput() and look at outputs with hostPinState[]
+extern int hostPinState[NUM_PINS];
+extern int hostPinMode[NUM_PINS];
+extern int hostAnalogValue[NUM_PINS];
+void hostPinInput(int pin, int value);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+char *dtostrf(double val, signed char width, unsigned char prec, char *s);
+char *itoa(int val, char *s, int radix);
+char *ltoa(long val, char *s, int radix);
+char *ultoa(unsigned long val, char *s, int radix);
+
+#include "Stream.h"
+
+// the sketch
+void setup();
+void loop();
@@ -0,0 +1,23 @@
+// -----------------------------------------------------------------------------------
+// EEPROM for host builds, a RAM image that reads as erased at startup (the Linux HAL's nv uses NV_FILE.h instead)
+
+#pragma once
+
+#include "Arduino.h"
+
+#define HOST_EEPROM_SIZE 4096
+
+class EEPROMClass {
+  public:
+    EEPROMClass() { memset(image,0xff,HOST_EEPROM_SIZE); }
+    uint8_t read(int i) { return ((i >= 0) && (i < HOST_EEPROM_SIZE))?image[i]:0; }
+    void write(int i, uint8_t v) { if ((i >= 0) && (i < HOST_EEPROM_SIZE)) image[i]=v; }
+    void update(int i, uint8_t v) { write(i,v); }
+    uint16_t length() { return HOST_EEPROM_SIZE; }
+    uint8_t& operator[](int i) { return image[i]; }
+
+  private:
+    uint8_t image[HOST_EEPROM_SIZE];
+};
+
+extern EEPROMClass EEPROM;
@@ -0,0 +1,41 @@
+// -----------------------------------------------------------------------------------
+// Print for host builds, a subset of the Arduino core's
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+class Print {
+  public:
+    virtual ~Print() { }
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size) { size_t n=0; while (size--) n+=write(*buffer++); return n; }
+    size_t write(const char *s) { return (s == NULL)?0:write((const uint8_t*)s,strlen(s)); }
+    size_t write(const char *buffer, size_t size) { return write((const uint8_t*)buffer,size); }
+    virtual void flush() { }
+
+    size_t print(const char s[]) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char n, int base=10) { return print((unsigned long)n,base); }
+    size_t print(int n, int base=10) { return print((long)n,base); }
+    size_t print(unsigned int n, int base=10) { return print((unsigned long)n,base); }
+    size_t print(long n, int base=10) {
+      char s[40];
+      if (base == 10) sprintf(s,"%ld",n); else return print((unsigned long)n,base);
+      return write(s);
+    }
+    size_t print(unsigned long n, int base=10) {
+      char s[40];
+      if (base == 16) sprintf(s,"%lX",n); else if (base == 8) sprintf(s,"%lo",n); else if (base == 2) {
+        int i=0; char t[33]; do { t[i++]='0'+(n&1); n>>=1; } while (n); for (int j=0; j < i; j++) s[j]=t[i-1-j]; s[i]=0;
+      } else sprintf(s,"%lu",n);
+      return write(s);
+    }
+    size_t print(double n, int digits=2) { char s[64]; sprintf(s,"%.*f",digits,n); return write(s); }
+
+    size_t println() { return write("\r\n"); }
+    template<typename T> size_t println(T v) { size_t n=print(v); return n+println(); }
+    template<typename T> size_t println(T v, int f) { size_t n=print(v,f); return n+println(); }
+};
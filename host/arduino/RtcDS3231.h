@@ -0,0 +1,22 @@
+// -----------------------------------------------------------------------------------
+// The RtcDS3231 library for host builds, it only sets the clock up (the time registers go through the I2C queue)
+
+#pragma once
+
+#include "Wire.h"
+
+enum DS3231SquareWavePinMode { DS3231SquareWavePin_ModeNone, DS3231SquareWavePin_ModeBatteryBackup, DS3231SquareWavePin_ModeClock, DS3231SquareWavePin_ModeAlarmOne, DS3231SquareWavePin_ModeAlarmTwo, DS3231SquareWavePin_ModeAlarmBoth };
+enum DS3231SquareWaveClock { DS3231SquareWaveClock_1Hz, DS3231SquareWaveClock_1kHz, DS3231SquareWaveClock_4kHz, DS3231SquareWaveClock_8kHz };
+
+template<class T_WIRE_METHOD> class RtcDS3231 {
+  public:
+    RtcDS3231(T_WIRE_METHOD& wire) { (void)wire; }
+    void Begin() { }
+    bool GetIsRunning() { return _running; }
+    void SetIsRunning(bool running) { _running=running; }
+    void SetSquareWavePin(DS3231SquareWavePinMode mode) { (void)mode; }
+    void SetSquareWavePinClockFrequency(DS3231SquareWaveClock freq) { (void)freq; }
+
+  private:
+    bool _running=false;
+};
@@ -0,0 +1,17 @@
+// -----------------------------------------------------------------------------------
+// Stream for host builds, a subset of the Arduino core's
+
+#pragma once
+
+#include "Print.h"
+
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    void setTimeout(unsigned long timeout) { _timeout=timeout; }
+
+  protected:
+    unsigned long _timeout=1000;
+};
@@ -0,0 +1,22 @@
+// -----------------------------------------------------------------------------------
+// I2C for host builds, there's nothing on this bus (the Linux HAL's I2C devices are modeled in HAL_I2C_Mock.h)
+
+#pragma once
+
+#include "Arduino.h"
+
+class TwoWire {
+  public:
+    void begin() { }
+    void end() { }
+    void setClock(unsigned long clock) { (void)clock; }
+    void beginTransmission(uint8_t address) { (void)address; }
+    size_t write(uint8_t data) { (void)data; return 1; }
+    size_t write(const uint8_t *data, size_t count) { (void)data; return count; }
+    uint8_t endTransmission(bool stop=true) { (void)stop; return 2; }
+    uint8_t requestFrom(uint8_t address, uint8_t count, bool stop=true) { (void)address; (void)count; (void)stop; return 0; }
+    int available() { return 0; }
+    int read() { return -1; }
+};
+
+extern TwoWire Wire;
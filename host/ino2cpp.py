@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+# -----------------------------------------------------------------------------------
+# Turns the sketch into one C++ translation unit the way the Arduino builder does, for host builds
+
+# The .ino files are joined (OnStep.ino first then the rest in alphabetical order) and prototypes for the
+# functions they define are inserted ahead of the first function, so calls can come before definitions.
+# Like the Arduino builder the sketch is preprocessed first (with the same compiler and flags) so only
+# functions that are actually compiled get prototypes.  A function's default arguments go on its prototype.
+#
+# Config.h is copied next to the output with "--set NAME=VALUE" applied to its #defines, the sketch's
+# #include "Config.h" finds that copy first.
+#
+# usage: ino2cpp.py SKETCH_DIR OUT_CPP [--set NAME=VALUE ...] -- COMPILER FLAGS...
+
+import os
+import re
+import subprocess
+import sys
+
+def main():
+    args=sys.argv[1:]
+    if '--' not in args or len(args) < 3: sys.exit(__doc__ or 'usage: ino2cpp.py SKETCH_DIR OUT_CPP [--set NAME=VALUE ...] -- COMPILER FLAGS...')
+    split=args.index('--')
+    sketch, out=os.path.abspath(args[0]), os.path.abspath(args[1])
+    sets=[]
+    i=2
+    while i < split:
+        if args[i] == '--set': sets.append(args[i+1].split('=',1)); i+=2
+        else: sys.exit('unknown option '+args[i])
+    cc=args[split+1:]
+
+    outDir=os.path.dirname(out)
+    os.makedirs(outDir,exist_ok=True)
+    writeConfig(os.path.join(sketch,'Config.h'),os.path.join(outDir,'Config.h'),sets)
+
+    names=sorted(n for n in os.listdir(sketch) if n.endswith('.ino') and n != 'OnStep.ino')
+    files=[os.path.join(sketch,n) for n in ['OnStep.ino']+names]
+
+    # the sketch without prototypes, preprocessed to find the functions that are compiled
+    body=join(files)
+    tmp=out+'.pre.cpp'
+    with open(tmp,'w') as f: f.write(body)
+    pre=subprocess.run(cc+['-E','-x','c++',tmp],stdout=subprocess.PIPE,universal_newlines=True,check=True).stdout
+    os.remove(tmp)
+    protos,defaults,first=findFunctions(pre,set(files))
+
+    lines=body.split('\n')
+    at=findLine(lines,first)
+    text='\n'.join(stripDefaults(l,defaults) for l in lines[:at])
+    rest='\n'.join(stripDefaults(l,defaults) for l in lines[at:])
+    with open(out,'w') as f:
+        f.write('// generated by host/ino2cpp.py, do not edit\n')
+        f.write(text+'\n')
+        f.write('// prototypes\n'+''.join(p+';\n' for p in protos))
+        f.write('#line %d "%s"\n' % (first[1],first[0]))
+        f.write(rest+'\n')
+
+def writeConfig(src, dst, sets):
+    text=open(src).read()
+    for name,value in sets:
+        text,n=re.subn(r'^(#define\s+'+re.escape(name)+r'\s+)\S+',lambda m: m.group(1)+value,text,flags=re.M)
+        if n == 0: sys.exit('Config.h has no #define '+name)
+    old=open(dst).read() if os.path.exists(dst) else None
+    if text != old:
+        with open(dst,'w') as f: f.write(text)
+
+def join(files):
+    s='#include <Arduino.h>\n'
+    for f in files:
+        s+='#line 1 "%s"\n' % f
+        s+=open(f).read()
+        if not s.endswith('\n'): s+='\n'
+    return s
+
+# top level statements that come from the sketch, with the file and line each starts on
+def statements(pre, files):
+    fname, line = None, 0
+    depth, paren = 0, 0
+    text, start = '', None
+    for raw in pre.split('\n'):
+        m=re.match(r'#\s*(?:line\s+)?(\d+)\s+"([^"]*)"',raw)
+        if m:
+            line, fname = int(m.group(1)), m.group(2)
+            continue
+        ours=fname in files
+        i=0
+        while i < len(raw):
+            c=raw[i]
+            if c in '"\'':
+                j=i+1
+                while j < len(raw) and raw[j] != c: j+=2 if raw[j] == '\\' else 1
+                if depth == 0 and ours: text+=raw[i:j+1]
+                i=j+1; continue
+            if depth == 0:
+                if c == '{':
+                    if ours and text.strip(): yield text.strip(), start, True
+                    text=''; start=None; depth=1
+                elif c == ';' and paren == 0:
+                    text=''; start=None
+                else:
+                    if c == '(': paren+=1
+                    if c == ')': paren-=1
+                    if ours:
+                        if start is None and not c.isspace(): start=(fname,line)
+                        text+=c
+            else:
+                if c == '{': depth+=1
+                elif c == '}':
+                    depth-=1
+                    if depth == 0: text=''; start=None
+            i+=1
+        if depth == 0 and ours: text+=' '
+        line+=1
+
+def findFunctions(pre, files):
+    protos, defaults, first, seen = [], {}, None, set()
+    for text, start, brace in statements(pre,files):
+        t=re.sub(r'\s+',' ',text)
+        if re.match(r'^(class|struct|union|enum|namespace|typedef|extern "C")\b',t) or '=' in t.split('(')[0]: continue
+        m=re.match(r'^((?:[A-Za-z_][\w:<>,\*& ]*?[\s\*&]))([A-Za-z_]\w*)\s*\((.*)\)\s*(const)?$',t)
+        if m is None or m.group(2) in ('if','while','for','switch') or '::' in m.group(2): continue
+        if first is None: first=start
+        if m.group(1).strip().startswith('static'): continue
+        p=t.replace('IRAM_ATTR ','')
+        if p in seen: continue
+        seen.add(p); protos.append(p)
+        if '=' in m.group(3): defaults[m.group(2)]=True
+    if first is None: sys.exit('no functions found in the sketch')
+    return protos, defaults, first
+
+# the line in the joined sketch a (file, line) from the preprocessor output is at
+def findLine(lines, where):
+    fname, line = where
+    cur, n = None, 0
+    for i,l in enumerate(lines):
+        m=re.match(r'#line (\d+) "([^"]*)"',l)
+        if m: cur=m.group(2); n=int(m.group(1)); continue
+        if cur == fname and n == line: return i
+        n+=1
+    sys.exit('can\'t find %s:%d' % where)
+
+# a definition can't repeat the default arguments its prototype has
+def stripDefaults(l, defaults):
+    for name in defaults:
+        m=re.match(r'^([A-Za-z_][\w\*& ]*\b'+name+r'\s*\()([^)]*)(\).*)$',l)
+        if m: l=m.group(1)+re.sub(r'\s*=\s*[^,]+','',m.group(2))+m.group(3)
+    return l
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,70 @@
+// -----------------------------------------------------------------------------------
+// The pointing model fit, least squares (the default) or the grid search (ALIGN_GRID_SEARCH_ON)
+
+// Stars are made up from models with up to 3 degrees of polar misalignment, cone and Dec axis errors, flexure and index
+// offsets, with 10" of noise, at a mid-northern latitude on both sides of the pier.  autoModel() fits them and the rms
+// of what's left is reported along with how long the fit took.  The least squares fit has to get down to about the noise
+// and take well under a millisecond, the grid search is only timed (it calls loop2() as it goes, which is counted too.)
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#define private public
+#include "OnStep.cpp"
+
+static int failures=0;
+#define CHECK(c,...) if (!(c)) { printf(__VA_ARGS__); printf("\n"); failures++; }
+
+static double rnd() { return 2.0*rand()/RAND_MAX-1.0; }
+static double seconds() { timespec t; clock_gettime(CLOCK_MONOTONIC,&t); return t.tv_sec+t.tv_nsec*1E-9; }
+
+// n stars that fit the terms p[] (Do,Pd,Pz,Pe,Tf,Ff,Df,Od,Oh in arc-seconds) to within noise arc-seconds
+static void makeStars(int n, double *p, double noise) {
+  double sf1=1.0/(3600.0*Rad), x[9]; for (int i=0; i < 9; i++) x[i]=p[i]*sf1;
+  Align.clearNormal();
+  for (int l=0; l < n; l++) {
+    align_coord2_t m, a;
+    m.ha=(rnd()*80.0)/Rad; m.dec=(rnd()*70.0+10.0)/Rad; m.side=(m.ha < 0)?-1:1; a.side=m.side;
+    // the actual position where the residual is zero, the second pass for the cos(Dec) the HA residual is scaled by
+    double rh, rd;
+    a.ha=0.0; a.dec=0.0; Align.solve_residual(&m,&a,x,&rh,&rd,NULL);
+    a.ha=-rh; a.dec=-rd;
+    Align.solve_residual(&m,&a,x,&rh,&rd,NULL); a.ha-=rh/cos(a.dec);
+    a.ha+=noise*rnd()*sf1; a.dec+=noise*rnd()*sf1;
+    Align.addNormal(&m,&a);
+    Align.mount[l]=m; Align.actual[l]=a;
+  }
+}
+
+int main() {
+  latitude=40.0;
+  srand(2);
+  printf("stars  fit        rms\n");
+  const int stars[]={3,6,9};
+  for (int n : stars) {
+    double t=0.0, rms=0.0; int trials=10;
+    for (int k=0; k < trials; k++) {
+      double p[9]={ (n > 2?rnd()*1800.0:0.0), (n > 4?rnd()*600.0:0.0), rnd()*3600.0*3.0, rnd()*3600.0*3.0,
+                    (n > 4?rnd()*300.0:0.0), 0.0, (n > 4?rnd()*300.0:0.0), rnd()*1200.0, rnd()*3600.0 };
+      makeStars(n,p,10.0);
+      double t0=seconds();
+      Align.autoModel(n);
+      t+=seconds()-t0;
+      double sf1=1.0/(3600.0*Rad);
+      double x[9]={Align.best_deo*sf1,Align.best_pd*sf1,Align.best_pz*sf1,Align.best_pe*sf1,Align.best_tf*sf1,
+                   Align.best_ff*sf1,Align.best_df*sf1,Align.best_ode*sf1,Align.best_ohe*sf1};
+      rms+=sqrt(Align.solve_sum(x)/n)/sf1;
+    }
+    t/=trials; rms/=trials;
+    printf("%-6d %7.3fms  %5.1f\"\n",n,t*1000.0,rms);
+#ifndef ALIGN_GRID_SEARCH_ON
+    CHECK(rms < 10.0,"%d stars fit to %.1f\" rms, the noise is 10\"",n,rms);
+    CHECK(t < 0.001,"%d stars took %.3fms to fit",n,t*1000.0);
+#endif
+  }
+
+  printf("%s\n",failures?"FAIL":"OK");
+  return failures?1:0;
+}
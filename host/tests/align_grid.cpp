@@ -0,0 +1,59 @@
+// -----------------------------------------------------------------------------------
+// ALIGN_CORRECTION_GRID: the pointing model's correction from the tables is within ALIGN_GRID_MAX_ERROR of the model
+
+// Models with polar misalignment up to a couple of degrees and the other terms up to a few tenths are set up at
+// latitudes from the equator to the poles, then the correction at random positions on both sides of the pier from the
+// tables is compared against the model evaluated in full.  The error on the sky (HA scaled by cos(Dec)) must stay within
+// ALIGN_GRID_MAX_ERROR everywhere the tables are used, and how close to the poles that is gets reported.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#define private public
+#include "OnStep.cpp"
+
+static int failures=0;
+#define CHECK(c,...) if (!(c)) { printf(__VA_ARGS__); printf("\n"); failures++; }
+
+static double rnd(double r) { return r*(2.0*rand()/RAND_MAX-1.0); }
+
+int main() {
+  srand(1);
+  const double lats[]={0.0,10.0,35.0,-35.0,52.0,70.0,89.0,-89.0};
+  double worst=0.0, lowest=90.0, highest=0.0; long served=0, total=0;
+
+  for (int m=0; m < 200; m++) {
+    double lat=lats[m%8];
+    Align.init();
+    Align.cosLat=cos(lat/Rad); Align.sinLat=sin(lat/Rad);
+    double scale=(m < 8)?0.0:((m%3 == 0)?0.02:0.3);
+    Align.azmCor=rnd(7.0*scale); Align.altCor=rnd(7.0*scale);
+    Align.doCor=rnd(scale); Align.pdCor=rnd(scale);
+    Align.dfCor=rnd(scale); Align.tfCor=rnd(scale);
+
+    Align.grid_update();
+    CHECK(Align.grid_current(),"tables not ready for the model");
+    if (Align.grid_dec_limit < lowest) lowest=Align.grid_dec_limit;
+    if (Align.grid_dec_limit > highest) highest=Align.grid_dec_limit;
+
+    for (int k=0; k < 20000; k++) {
+      double HA=rnd(200.0), Dec=rnd(Align.grid_dec_limit+1.0), p=(k%2)?1.0:-1.0;
+      double dHA, dDec, mHA, mDec, mHAp;
+      total++;
+      if (!Align.grid_correction(HA,Dec,p,&dHA,&dDec)) { CHECK(fabs(Dec) >= Align.grid_dec_limit,"tables not used at Dec %f",Dec); continue; }
+      served++;
+      Align.model_correction(HA,Dec,&mHA,&mDec,&mHAp); mHA+=mHAp*p;
+      double e=(fabs(dHA-mHA)*cos(Dec/Rad)+fabs(dDec-mDec))*3600.0;
+      if (e > worst) worst=e;
+      if (e > ALIGN_GRID_MAX_ERROR) { CHECK(false,"%.3f\" error at HA %f Dec %f, lat %.0f, model %d",e,HA,Dec,lat,m); if (failures > 5) return 1; }
+    }
+  }
+
+  // with no model the tables go all the way to ALIGN_GRID_DEC_LIMIT
+  CHECK(highest == ALIGN_GRID_DEC_LIMIT,"no model, tables only used up to Dec %.2f",highest);
+  printf("%ld of %ld corrections from the tables, %.4f\" worst error, used to Dec %.2f to %.2f degrees\n",served,total,worst,lowest,highest);
+
+  printf("%s\n",failures?"FAIL":"OK");
+  return failures?1:0;
+}
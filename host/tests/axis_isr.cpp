@@ -0,0 +1,106 @@
+// -----------------------------------------------------------------------------------
+// The Axis1/Axis2 motor timer ISRs from the axisStepper<> template against the hand written ones they replaced
+
+// Random changes to the tracking state, targets, timer direction, slow rep counts, goto rate and Axis2 power are made
+// between calls and each ISR is run twice from the same state: the real one, then the reference (axis_isr_ref.h.)  The
+// positions, backlash, direction, waveform and goto mode state, the step/dir/mode pins and the timer period they leave
+// have to be the same every time.  Then each is timed over a million calls while tracking.  It's built for the PULSE,
+// SQUARE and DEDGE wave forms and with goto micro-step mode switching.
+
+#include "OnStep.cpp"
+#include "axis_isr_ref.h"
+#include <time.h>
+
+static int failures=0;
+#define CHECK(c,...) if (!(c)) { printf(__VA_ARGS__); printf("\n"); failures++; }
+
+// the state the ISRs change
+typedef struct { volatile void *p; size_t n; } isrVar_t;
+#define VAR(x) { (volatile void*)&(x), sizeof(x) }
+static const isrVar_t isrState[]={
+  VAR(posAxis1), VAR(targetAxis1), VAR(dirAxis1), VAR(blAxis1), VAR(inbacklashAxis1), VAR(slowAxis1Cnt),
+  VAR(posAxis2), VAR(targetAxis2), VAR(dirAxis2), VAR(blAxis2), VAR(inbacklashAxis2), VAR(slowAxis2Cnt),
+  VAR(itimer3.period), VAR(itimer4.period),
+#if STEP_WAVE_FORM == SQUARE
+  VAR(clearAxis1), VAR(takeStepAxis1), VAR(clearAxis2), VAR(takeStepAxis2),
+#elif STEP_WAVE_FORM == DEDGE
+  VAR(toggleStateAxis1), VAR(toggleStateAxis2),
+#endif
+#if defined(AXIS1_DRIVER_MICROSTEP_CODE) && defined(AXIS1_DRIVER_MICROSTEP_CODE_GOTO)
+  VAR(stepAxis1), VAR(gotoModeAxis1), VAR(AXIS1_DRIVER_MICROSTEP_CODE_NEXT),
+#endif
+#if defined(AXIS2_DRIVER_MICROSTEP_CODE) && defined(AXIS2_DRIVER_MICROSTEP_CODE_GOTO)
+  VAR(stepAxis2), VAR(gotoModeAxis2), VAR(AXIS2_DRIVER_MICROSTEP_CODE_NEXT),
+#endif
+};
+static const int isrPins[]={ Axis1StepPin, Axis1DirPin, Axis2StepPin, Axis2DirPin,
+#if defined(AXIS1_DRIVER_MICROSTEP_CODE) && defined(AXIS1_DRIVER_MICROSTEP_CODE_GOTO)
+  Axis1_M0, Axis1_M1, Axis1_M2, Axis2_M0, Axis2_M1, Axis2_M2,
+#endif
+};
+
+typedef struct { byte b[256]; int n; } snapshot_t;
+static void save(snapshot_t *s) {
+  s->n=0;
+  for (const isrVar_t &v : isrState) { memcpy(&s->b[s->n],(void*)v.p,v.n); s->n+=v.n; }
+  for (int p : isrPins) s->b[s->n++]=digitalRead(p);
+}
+static void restore(snapshot_t *s) {
+  int n=0;
+  for (const isrVar_t &v : isrState) { memcpy((void*)v.p,&s->b[n],v.n); n+=v.n; }
+  for (int p : isrPins) digitalWrite(p,s->b[n++]);
+}
+
+static double seconds() { timespec t; clock_gettime(CLOCK_MONOTONIC,&t); return t.tv_sec+t.tv_nsec*1E-9; }
+
+int main() {
+  srand(1);
+  targetAxis1.fixed=0; targetAxis2.fixed=0;
+  backlashAxis1=3; backlashAxis2=5;
+  long differ=0;
+  for (int i=0; i < 20000; i++) {
+    int r=rand()%100;
+    if (r < 3) trackingState=rand()%3;
+    if ((r >= 3) && (r < 6)) targetAxis1.part.m+=rand()%21-10;
+    if ((r >= 6) && (r < 9)) targetAxis2.part.m+=rand()%21-10;
+    if (r == 9) timerDirAxis1=rand()%3-1;
+    if (r == 10) timerDirAxis2=rand()%3-1;
+    if (r == 11) slowAxis1Rep=rand()%3+1;
+    if (r == 12) slowAxis2Rep=rand()%3+1;
+    if (r == 13) gotoRateAxis1=!gotoRateAxis1;
+    if (r == 14) gotoRateAxis2=!gotoRateAxis2;
+    if (r == 15) axis2Powered=!axis2Powered;
+    if (r == 16) nextAxis1Rate=rand()%1000;
+    if (r == 17) nextAxis2Rate=rand()%1000;
+
+    snapshot_t before, real, ref;
+    save(&before);
+    TIMER3_COMPA_vect(); TIMER4_COMPA_vect(); save(&real);
+    restore(&before);
+    refTimer3(); refTimer4(); save(&ref);
+    if ((real.n != ref.n) || memcmp(real.b,ref.b,real.n)) { if (differ < 5) printf("call %d differs from the reference\n",i); differ++; }
+    restore(&real);
+  }
+  CHECK(differ == 0,"%ld of 20000 calls differ",differ);
+
+  // tracking, a step every other call
+  trackingState=TrackingSidereal; timerDirAxis1=1; timerDirAxis2=0; slowAxis1Rep=1; slowAxis2Rep=1; axis2Powered=true;
+  gotoRateAxis1=false; gotoRateAxis2=false;
+  const long calls=1000000;
+  double t0=seconds();
+  for (long k=0; k < calls; k++) { TIMER3_COMPA_vect(); TIMER4_COMPA_vect(); }
+  double t1=seconds();
+  for (long k=0; k < calls; k++) { refTimer3(); refTimer4(); }
+  double t2=seconds();
+#if STEP_WAVE_FORM == SQUARE
+  const char *wave="SQUARE";
+#elif STEP_WAVE_FORM == DEDGE
+  const char *wave="DEDGE";
+#else
+  const char *wave="PULSE";
+#endif
+  printf("%s, both axes per call: axisStepper<> %.1fns, by hand %.1fns\n",wave,(t1-t0)*1E9/calls,(t2-t1)*1E9/calls);
+
+  printf("%s\n",failures?"FAIL":"OK");
+  return failures?1:0;
+}
@@ -0,0 +1,156 @@
+// -----------------------------------------------------------------------------------
+// The Axis1/Axis2 motor timer ISRs as they were written out by hand before the axisStepper<> template (Timer.ino,)
+// the reference host/tests/axis_isr.cpp checks the template against
+
+void refTimer3()
+{
+  if (slowAxis1Rep > 1) { slowAxis1Cnt++; if (slowAxis1Cnt%slowAxis1Rep != 0) goto done; }
+
+#if STEP_WAVE_FORM != DEDGE
+  StepPinAxis1_LOW;
+#endif
+
+#if STEP_WAVE_FORM == SQUARE
+  if (clearAxis1) {
+    takeStepAxis1=false;
+#endif
+
+#if defined(AXIS1_DRIVER_MICROSTEP_CODE) && defined(AXIS1_DRIVER_MICROSTEP_CODE_GOTO) && MODE_SWITCH_BEFORE_SLEW == OFF
+  // switch micro-step mode
+  if (gotoModeAxis1 != gotoRateAxis1) {
+    // only when at an allowed position
+    if ((gotoModeAxis1) || ((posAxis1+blAxis1)%AXIS1_DRIVER_STEP_GOTO == 0)) {
+      // switch mode
+      if (gotoModeAxis1) { stepAxis1=1; AXIS1_DRIVER_MICROSTEP_CODE_NEXT=AXIS1_DRIVER_MICROSTEP_CODE; gotoModeAxis1=false; } else { stepAxis1=AXIS1_DRIVER_STEP_GOTO; AXIS1_DRIVER_MICROSTEP_CODE_NEXT=AXIS1_DRIVER_MICROSTEP_CODE_GOTO; gotoModeAxis1=true; }
+      digitalWrite(Axis1_M0,(AXIS1_DRIVER_MICROSTEP_CODE_NEXT & 1));
+      digitalWrite(Axis1_M1,(AXIS1_DRIVER_MICROSTEP_CODE_NEXT>>1 & 1));
+      #ifndef AXIS1_DRIVER_DISABLE_M2
+        digitalWrite(Axis1_M2,(AXIS1_DRIVER_MICROSTEP_CODE_NEXT>>2 & 1));
+      #endif
+    }
+  }
+#endif
+
+#if STEP_WAVE_FORM != SQUARE
+  QuickSetIntervalAxis1(nextAxis1Rate*stepAxis1);
+#endif
+
+  if ((trackingState != TrackingMoveTo) && (!inbacklashAxis1)) targetAxis1.part.m+=timerDirAxis1*stepAxis1;
+
+  // move the RA/Azm stepper to the target
+  if ((posAxis1 != (long)targetAxis1.part.m) || inbacklashAxis1) {
+
+    // set direction
+    if (posAxis1 < (long)targetAxis1.part.m) dirAxis1=1; else dirAxis1=0;
+    #if AXIS1_DRIVER_REVERSE == ON
+      if (defaultDirAxis1 == dirAxis1) DirPinAxis1_LOW; else DirPinAxis1_HIGH;
+    #else
+      if (defaultDirAxis1 == dirAxis1) DirPinAxis1_HIGH; else DirPinAxis1_LOW;
+    #endif
+  
+    // telescope moves WEST with the sky, blAxis1 is the amount of EAST backlash
+    if (dirAxis1 == 1) {
+      if (blAxis1 < backlashAxis1) { blAxis1+=stepAxis1; inbacklashAxis1=true; } else { inbacklashAxis1=false; posAxis1+=stepAxis1; }
+    } else {
+      if (blAxis1 > 0)             { blAxis1-=stepAxis1; inbacklashAxis1=true; } else { inbacklashAxis1=false; posAxis1-=stepAxis1; }
+    }
+
+#if STEP_WAVE_FORM == SQUARE
+      takeStepAxis1=true;
+    }
+    clearAxis1=false;
+  } else { 
+    if (takeStepAxis1) StepPinAxis1_HIGH;
+    clearAxis1=true;
+
+    QuickSetIntervalAxis1(nextAxis1Rate*stepAxis1);
+  }
+#else
+#if STEP_WAVE_FORM == DEDGE
+    toggleStateAxis1++;
+    if (toggleStateAxis1%2 == 0) StepPinAxis1_LOW; else StepPinAxis1_HIGH;
+#else
+    StepPinAxis1_HIGH;
+#endif
+  }
+#endif
+
+done: {}
+}
+
+void refTimer4()
+{
+  if (slowAxis2Rep > 1) { slowAxis2Cnt++; if (slowAxis2Cnt%slowAxis2Rep != 0) goto done; }
+
+#if STEP_WAVE_FORM != DEDGE
+  StepPinAxis2_LOW;
+#endif
+
+#if STEP_WAVE_FORM == SQUARE
+  if (clearAxis2) {
+    takeStepAxis2=false;
+#endif
+
+#if defined(AXIS2_DRIVER_MICROSTEP_CODE) && defined(AXIS2_DRIVER_MICROSTEP_CODE_GOTO) && MODE_SWITCH_BEFORE_SLEW == OFF
+  // switch micro-step mode
+  if (gotoModeAxis2 != gotoRateAxis2) {
+    // only when at an allowed position
+    if ((gotoModeAxis2) || ((posAxis2+blAxis2)%AXIS2_DRIVER_STEP_GOTO == 0)) {
+      // switch mode
+      if (gotoModeAxis2) { stepAxis2=1; AXIS2_DRIVER_MICROSTEP_CODE_NEXT=AXIS2_DRIVER_MICROSTEP_CODE; gotoModeAxis2=false; } else { stepAxis2=AXIS2_DRIVER_STEP_GOTO; AXIS2_DRIVER_MICROSTEP_CODE_NEXT=AXIS2_DRIVER_MICROSTEP_CODE_GOTO; gotoModeAxis2=true; }
+      digitalWrite(Axis2_M0,(AXIS2_DRIVER_MICROSTEP_CODE_NEXT & 1));
+      digitalWrite(Axis2_M1,(AXIS2_DRIVER_MICROSTEP_CODE_NEXT>>1 & 1));
+      #ifndef AXIS2_DRIVER_DISABLE_M2
+        digitalWrite(Axis2_M2,(AXIS2_DRIVER_MICROSTEP_CODE_NEXT>>2 & 1));
+      #endif
+    }
+  }
+#endif
+
+#if STEP_WAVE_FORM != SQUARE
+  QuickSetIntervalAxis2(nextAxis2Rate*stepAxis2);
+#endif
+
+  if ((trackingState != TrackingMoveTo) && (!inbacklashAxis2)) targetAxis2.part.m+=timerDirAxis2*stepAxis2;
+
+  // move the Dec/Alt stepper to the target
+  if (axis2Powered && ((posAxis2 != (long)targetAxis2.part.m) || inbacklashAxis2)) {
+    
+    // set direction
+    if (posAxis2 < (long)targetAxis2.part.m) dirAxis2=1; else dirAxis2=0;
+    #if AXIS2_DRIVER_REVERSE == ON
+      if (defaultDirAxis2 == dirAxis2) DirPinAxis2_LOW; else DirPinAxis2_HIGH;
+    #else
+      if (defaultDirAxis2 == dirAxis2) DirPinAxis2_HIGH; else DirPinAxis2_LOW;
+    #endif
+   
+    // telescope moving toward celestial pole in the sky, blAxis2 is the amount of opposite backlash
+    if (dirAxis2 == 1) {
+      if (blAxis2 < backlashAxis2) { blAxis2+=stepAxis2; inbacklashAxis2=true; } else { inbacklashAxis2=false; posAxis2+=stepAxis2; }
+    } else {
+      if (blAxis2 > 0)             { blAxis2-=stepAxis2; inbacklashAxis2=true; } else { inbacklashAxis2=false; posAxis2-=stepAxis2; }
+    }
+
+#if STEP_WAVE_FORM == SQUARE
+      takeStepAxis2=true;
+    }
+    clearAxis2=false;
+  } else { 
+    if (takeStepAxis2) StepPinAxis2_HIGH;
+    clearAxis2=true;
+
+    QuickSetIntervalAxis2(nextAxis2Rate*stepAxis2);
+  }
+#else
+#if STEP_WAVE_FORM == DEDGE
+    toggleStateAxis2++;
+    if (toggleStateAxis2%2 == 0) StepPinAxis2_LOW; else StepPinAxis2_HIGH;
+#else
+    StepPinAxis2_HIGH;
+#endif
+  }
+#endif
+
+done: {}
+}
+
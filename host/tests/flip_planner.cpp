@@ -0,0 +1,104 @@
+// -----------------------------------------------------------------------------------
+// The meridian flip path planner (src/lib/FlipPlanner.h) over a grid of latitudes, starts and targets
+
+// For flips from the west side of the pier to the east, with both axis movement models, each planned path is walked in
+// 0.2 degree steps.  Nowhere may it go below the horizon or past the under the pole or Axis2 limits by more than its start or
+// end does, the planner's coarser sampling has to be covered by its altitude margin.  The plan must never be slower than the
+// classic waypoints when they're safe, and takes at most FLIP_PLAN_MAX_SAMPLES samples.  How often a direct slew or a single
+// stop at the pole is picked, the time saved and the longest a plan took are reported.
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "../../src/lib/FlipPlanner.h"
+
+#define MIN_ALT          0.0
+#define UNDER_POLE_LIMIT 180.0
+#define AXIS2_MIN        -91.0
+#define AXIS2_MAX        91.0
+
+static int failures=0;
+#define CHECK(c,...) if (!(c)) { if (failures < 5) { printf(__VA_ARGS__); printf("\n"); } failures++; }
+
+static double seconds() { timespec t; clock_gettime(CLOCK_MONOTONIC,&t); return t.tv_sec+t.tv_nsec*1E-9; }
+
+// how far a mechanical position is below the horizon (plus margin) or past the limits
+static double beyond(flipPlanner &f, flipPoint_t m, double margin) {
+  double ha=m.axis1, dec=m.axis2;
+  if ((dec < -90.0) || (dec > 90.0)) { ha=ha+180.0-360.0; dec=180.0-dec; }
+  if (dec > 180.0) dec-=360.0;
+  if (dec < -180.0) dec+=360.0;
+  double v=MIN_ALT+margin-f.altitude(m);
+  v=fmax(v,fabs(ha)-UNDER_POLE_LIMIT);
+  v=fmax(v,AXIS2_MIN-dec);
+  v=fmax(v,dec-AXIS2_MAX);
+  return fmax(v,0.0);
+}
+
+// walks a segment as the mount would move, returns how much further past the limits it gets than its ends
+static double walk(flipPlanner &f, flipPoint_t a, flipPoint_t b, bool coordinated, double margin) {
+  double d1=b.axis1-a.axis1, d2=b.axis2-a.axis2, len=fmax(fabs(d1),fabs(d2));
+  double ends=fmax(beyond(f,a,margin),beyond(f,b,margin)), worst=0.0;
+  for (double s=0.2; s < len; s+=0.2) {
+    flipPoint_t p;
+    if (coordinated) { p.axis1=a.axis1+d1*(s/len); p.axis2=a.axis2+d2*(s/len); } else {
+      p.axis1=a.axis1+(d1 >= 0 ? fmin(s,d1) : fmax(-s,d1));
+      p.axis2=a.axis2+(d2 >= 0 ? fmin(s,d2) : fmax(-s,d2));
+    }
+    worst=fmax(worst,beyond(f,p,margin)-ends);
+  }
+  return worst;
+}
+
+static double cost(flipPlanner &f, flipPoint_t s, const flipPoint_t *w, int n, flipPoint_t t) {
+  double c=0.0; flipPoint_t a=s;
+  for (int i=0; i < n; i++) { c+=f.segmentCost(a,w[i]); a=w[i]; }
+  return c+f.segmentCost(a,t);
+}
+
+int main() {
+  long plans=0, direct=0, pole=0, classicUsed=0, cut=0; int mostSamples=0;
+  double saved=0.0, total=0.0, longest=0.0, planning=0.0;
+  for (int coordinated=0; coordinated < 2; coordinated++)
+  for (double lat=-60.0; lat <= 60.0; lat+=10.0) {
+    if (fabs(lat) < 1.0) continue;
+    double home2=(lat < 0)?-90.0:90.0;
+    for (double sha=0.0; sha <= 30.0; sha+=5.0) for (double sdec=-80.0; sdec <= 85.0; sdec+=15.0)
+    for (double tha=0.0; tha <= 10.0; tha+=5.0) for (double tdec=-80.0; tdec <= 85.0; tdec+=15.0) {
+      flipPlanner f; f.init(lat,MIN_ALT,UNDER_POLE_LIMIT,AXIS2_MIN,AXIS2_MAX,home2,5.0,coordinated);
+      // from the west side of the pier (HA < 0) to the east side (HA > 0)
+      flipPoint_t s=f.toMech(-sha,sdec,true), t=f.toMech(tha,tdec,false);
+      if ((f.altitude(s) < MIN_ALT) || (f.altitude(t) < MIN_ALT)) continue;
+      flipPoint_t classic[2]={ f.toMech(-90.0,home2,true), f.toMech(-90.0,home2,true) };
+      // safe as the planner sees it, with the margin
+      bool classicSafe=(walk(f,s,classic[0],coordinated,FLIP_PLAN_ALT_MARGIN) <= 0.0) && (walk(f,classic[1],t,coordinated,FLIP_PLAN_ALT_MARGIN) <= 0.0);
+
+      double t0=seconds();
+      int n=f.plan(s,t,classic,2,false);
+      double t1=seconds();
+      planning+=t1-t0;
+      if (f.samples >= FLIP_PLAN_MAX_SAMPLES) cut++;
+      if (f.samples > mostSamples) { mostSamples=f.samples; longest=t1-t0; }
+      if (f.samples > mostSamples) mostSamples=f.samples;
+      plans++;
+      if (n == 0) direct++; else if (n == 1) pole++; else classicUsed++;
+
+      flipPoint_t w[FLIP_PLAN_MAX_WAYPOINTS]; int k=0; while (f.next(&w[k])) k++;
+      if (n < 2) {
+        flipPoint_t a=s; double worst=0.0;
+        for (int i=0; i <= k; i++) { flipPoint_t b=(i < k)?w[i]:t; worst=fmax(worst,walk(f,a,b,coordinated,0.0)); a=b; }
+        CHECK(worst <= 0.0,"lat %.0f from HA %.0f Dec %.0f to HA %.0f Dec %.0f with %d waypoints goes %.2f degrees past the limits",lat,-sha,sdec,tha,tdec,n,worst);
+      }
+      double c=cost(f,s,w,k,t), cc=cost(f,s,classic,2,t);
+      if (classicSafe) CHECK(c <= cc+1E-9,"lat %.0f plan slower than the classic waypoints",lat);
+      saved+=cc-c; total+=cc;
+    }
+  }
+  CHECK(mostSamples <= FLIP_PLAN_MAX_SAMPLES,"%d samples in a plan",mostSamples);
+  printf("%ld plans: %ld direct, %ld one stop at the pole, %ld classic, %.1f%% of the slew time saved\n",plans,direct,pole,classicUsed,100.0*saved/total);
+  printf("%.3fms a plan on average, at most %d samples (%.3fms,) %ld plans ran out of samples\n",planning*1000.0/plans,mostSamples,longest*1000.0,cut);
+
+  printf("%s\n",failures?"FAIL":"OK");
+  return failures?1:0;
+}
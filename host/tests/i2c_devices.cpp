@@ -0,0 +1,81 @@
+// -----------------------------------------------------------------------------------
+// The BME280 and DS3231 on the I2C bus model (WEATHER BME280, RTC DS3231)
+
+// The BME280's compensation and the DS3231's BCD registers are done in OnStep (the libraries only set the devices up.)
+// The BME280 gets the datasheet's example calibration and readings, which should come out as 25.08C and 100653.27Pa.
+// The DS3231 is set and read back either side of the century, its registers are checked as the datasheet lays them
+// out (with the day of the week, 1 for Sunday) and a set() with the queue full has to wait its turn rather than be lost.
+
+#include "OnStep.cpp"
+
+static int failures=0;
+#define CHECK(c,...) if (!(c)) { printf(__VA_ARGS__); printf("\n"); failures++; }
+
+// the main loop polling the bus until it's done
+static void settle() { while (!i2cBus.idle()) { delayMicroseconds(50); i2cBus.poll(); } }
+
+static void putWord(byte *m, int r, int v) { m[r]=v&0xFF; m[r+1]=(v>>8)&0xFF; }
+
+static void bme280() {
+  i2cMock.add(0x77,256,1,0,0);
+  byte *m=i2cMock.memory(0x77);
+
+  // calibration and readings from the datasheet's compensation example, the humidity calibration from a typical part
+  const int cal[12]={27504,26435,-1000,36477,-10685,3024,2855,140,-7,15500,-14600,6000};
+  for (int i=0; i < 12; i++) putWord(m,0x88+i*2,cal[i]);
+  m[0xA1]=75; putWord(m,0xE1,362); m[0xE3]=0; m[0xE4]=0x13; m[0xE5]=0x03; m[0xE6]=0; m[0xE7]=30;
+  long adcP=415148, adcT=519888, adcH=30000;
+  byte r[8]={ (byte)(adcP>>12), (byte)(adcP>>4), (byte)(adcP<<4), (byte)(adcT>>12), (byte)(adcT>>4), (byte)(adcT<<4), (byte)(adcH>>8), (byte)adcH };
+  memcpy(&m[0xF7],r,8);
+
+  ambient.init();
+  for (int i=0; i < 11; i++) ambient.poll();
+  settle();
+  CHECK(fabs(ambient.getTemperature()-25.08) < 0.005,"BME280 temperature %.4fC, should be 25.08C",ambient.getTemperature());
+  CHECK(fabs(ambient.getPressure()*100.0-100653.27) < 0.05,"BME280 pressure %.2fPa, should be 100653.27Pa",ambient.getPressure()*100.0);
+  CHECK((ambient.getHumidity() > 0.0) && (ambient.getHumidity() < 100.0),"BME280 humidity %.1f%%",ambient.getHumidity());
+  printf("BME280 %.2fC %.2fPa %.1f%%\n",ambient.getTemperature(),ambient.getPressure()*100.0,ambient.getHumidity());
+}
+
+// sets the DS3231 then checks its registers and reads it back
+static void ds3231(int y, int mo, int d, int h, int mi, int s, int dow) {
+  byte *m=i2cMock.memory(0x68);
+  double JD=julian(y,mo,d), LMT=h+mi/60.0+s/3600.0;
+  urtc.set(JD,LMT);
+  settle();
+
+  int yy=y%100;
+  byte r[7]={ (byte)(((s/10)<<4)|(s%10)), (byte)(((mi/10)<<4)|(mi%10)), (byte)(((h/10)<<4)|(h%10)), (byte)dow,
+              (byte)(((d/10)<<4)|(d%10)), (byte)(((mo/10)<<4)|(mo%10)|(y >= 2100?0x80:0)), (byte)(((yy/10)<<4)|(yy%10)) };
+  CHECK(memcmp(m,r,7) == 0,"DS3231 %04d-%02d-%02d %02d:%02d:%02d registers %02X %02X %02X %02X %02X %02X %02X",y,mo,d,h,mi,s,m[0],m[1],m[2],m[3],m[4],m[5],m[6]);
+
+  double JD1=0, LMT1=-1;
+  urtc.get(JD1,LMT1);
+  CHECK((JD1 == JD) && (fabs(LMT1-LMT)*3600.0 < 0.5),"DS3231 %04d-%02d-%02d read back as JD %.1f LMT %.5f",y,mo,d,JD1,LMT1);
+}
+
+static void rtc() {
+  i2cMock.add(0x68,19,1,0,0);
+  urtc.init();
+  ds3231(2024,6,15,21,5,9,7);
+  ds3231(2099,12,31,23,59,30,5);
+  ds3231(2100,3,1,0,0,1,2);
+
+  // a set() with the queue full falls back to waiting for a place, it mustn't be dropped
+  byte a=0;
+  int queued=0; while (i2cBus.queue(0x68,&a,1,7,NULL,NULL)) queued++;
+  CHECK(queued == I2C_QUEUE_SIZE-1,"%d transactions fit in the queue",queued);
+  urtc.set(julian(2030,1,2),3.5);
+  CHECK(i2cMock.memory(0x68)[6] == 0x30,"set() with the queue full was lost");
+  settle();
+  double JD=0, LMT=0; urtc.get(JD,LMT);
+  CHECK((JD == julian(2030,1,2)) && (fabs(LMT-3.5) < 0.001),"set() with the queue full read back as JD %.1f LMT %.5f",JD,LMT);
+}
+
+int main() {
+  bme280();
+  rtc();
+
+  printf("%s\n",failures?"FAIL":"OK");
+  return failures?1:0;
+}
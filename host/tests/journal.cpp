@@ -0,0 +1,84 @@
+// -----------------------------------------------------------------------------------
+// The NV journal (src/lib/Journal.h) with the power lost after every byte written
+
+// A fixed workload of changes to three values is run once to count the NV writes it makes, then again from the
+// start for each of those writes with the power going just before it.  After each "power loss" a fresh journal
+// must read every value as either the one being written or the one before it.
+
+#include <map>
+#include <Arduino.h>
+
+#define E2END 4095
+#include "../../Constants.h"
+#define Rad 57.29577951
+#include "../../src/lib/Misc.h"
+
+static unsigned long ms=0;
+unsigned long millis() { return ms; }
+
+struct powerLoss {};
+static long budget=-1;            // writes left before the power goes, -1 for no limit
+static long writes=0;
+static byte image[E2END+1];
+
+class nvs {
+  public:
+    byte read(int i) { return image[i]; }
+    void write(int i, byte b) { if (budget == 0) throw powerLoss(); if (budget > 0) budget--; writes++; image[i]=b; }
+    long readLong(int i) { long l=0; memcpy(&l,&image[i],4); return l; }
+    void readBytes(int i, byte *v, int n) { memcpy(v,&image[i],n); }
+} nv;
+
+#include "../../src/lib/Journal.h"
+
+static const int address[3]={9,72,92};
+#define CHANGES 400
+
+// the workload, last[] and prev[] follow the value being written and the one before it
+static std::map<int,long> last, prev;
+static void workload() {
+  srand(1);
+  nvj.init();
+  for (int a : address) last[a]=prev[a]=1000+a;
+  for (int c=0; c < CHANGES; c++) {
+    int a=address[rand()%3]; long v=rand();
+    prev[a]=last[a]; last[a]=v;
+    nvj.writeLong(a,v);
+    for (int p=0; p < 30; p++) { ms+=NV_JOURNAL_WRITE_MS; nvj.poll(); }
+  }
+}
+
+int main() {
+  // values from before the journal at their own addresses, and an erased ring
+  memset(image,0xff,sizeof(image));
+  for (int a : address) { long v=1000+a; memcpy(&image[a],&v,4); }
+  static byte start[E2END+1]; memcpy(start,image,sizeof(image));
+
+  nvj=nvJournal(); budget=-1; writes=0; ms=0;
+  workload();
+  long total=writes;
+
+  int failures=0;
+  for (long cut=0; cut <= total; cut++) {
+    memcpy(image,start,sizeof(image)); ms=0;
+    nvj=nvJournal(); budget=cut;
+    try { workload(); } catch (powerLoss&) { }
+    budget=-1;
+
+    nvj=nvJournal(); nvj.init();
+    for (int a : address) {
+      long v=nvj.readLong(a);
+      if ((v != last[a]) && (v != prev[a])) {
+        if (failures < 5) printf("power lost before write %ld: value at %d is %ld, should be %ld or %ld\n",cut,a,v,last[a],prev[a]);
+        failures++;
+      }
+    }
+  }
+
+  // an erased ring has no records
+  nvj.clear();
+  for (int a : address) if (nvj.readLong(a) != 1000+a) { printf("value at %d still journaled after clear()\n",a); failures++; }
+
+  printf("%ld power losses, %s\n",total+1,failures?"FAIL":"OK");
+  return failures?1:0;
+}
@@ -0,0 +1,104 @@
+// -----------------------------------------------------------------------------------
+// The Mega2560 HAL's interrupt driven serial transmit (src/HAL/HAL_Mega2560/HAL_Serial.h) on a simulated UART
+
+// The UART takes a few register reads to shift each byte out, then sets UDRE and, if UDRIE is set and interrupts are
+// on, runs the UDRE ISR.  Replies longer than the buffer are written with interrupts on, where write() waits on the ISR,
+// and with them off (from an ISR or a cli() section,) where it has to send them itself rather than hang.  Whatever
+// the case every byte has to come out on the wire in order, binary zeros included.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+#define F_CPU 16000000UL
+#define _BV(b) (1<<(b))
+#define SREG_I 7
+#define ISR(v) void v()
+enum { RXEN0=4, TXEN0=3, RXCIE0=7, UDRIE0=5, UCSZ01=2, UCSZ00=1, USBS0=3, UPM01=5, UPM00=4, UMSEL01=7, UMSEL00=6, UDRE0=5 };
+
+struct hang {};
+void USART0_UDRE_vect();
+
+// the UART, each read of a status register is a little time passing
+static struct uart {
+  std::string wire;
+  int shifting=0;                 // reads until the byte being sent is out
+  int udr=-1;                     // the byte waiting in the data register
+  long reads=0;
+  void clock();
+} uart0;
+
+static unsigned char sreg=_BV(SREG_I), ucsr0b=0;
+struct statusReg {
+  unsigned char v=0;
+  operator unsigned char() { uart0.clock(); return v; }
+  statusReg& operator=(int x) { v=x; return *this; }
+};
+struct dataReg {
+  dataReg& operator=(unsigned char c) { uart0.udr=c; return *this; }
+  operator unsigned char() { return 0; }
+};
+struct sregReg {
+  operator unsigned char() { uart0.clock(); return sreg; }
+};
+static statusReg UCSR0A;
+static dataReg UDR0;
+static sregReg SREG;
+static unsigned char UBRR0H, UBRR0L, UCSR0C;
+#define UCSR0B ucsr0b
+static void cli() { sreg&=~_BV(SREG_I); }
+static void sei() { sreg|=_BV(SREG_I); }
+
+void uart::clock() {
+  if (++reads > 10000000L) throw hang();
+  if (shifting > 0) shifting--;
+  if ((shifting == 0) && (udr >= 0)) { wire+=(char)udr; udr=-1; shifting=10; }
+  if (udr < 0) UCSR0A.v|=_BV(UDRE0); else UCSR0A.v&=~_BV(UDRE0);
+  if ((udr < 0) && (sreg & _BV(SREG_I)) && (ucsr0b & _BV(UDRIE0))) { cli(); USART0_UDRE_vect(); sei(); }
+}
+
+#include "../../src/HAL/HAL_Mega2560/HAL_Serial.h"
+
+static int failures=0;
+#define CHECK(c,...) if (!(c)) { printf(__VA_ARGS__); printf("\n"); failures++; }
+
+// sends the replies with interrupts on or off and drains the UART, true if they all came out
+static bool send(bool interrupts, const std::string &expect, int chunk) {
+  uart0.wire.clear(); uart0.reads=0;
+  try {
+    if (!interrupts) cli();
+    for (size_t i=0; i < expect.size(); i+=chunk) SerialA.write((const uint8_t*)expect.data()+i,std::min((size_t)chunk,expect.size()-i));
+    if (!interrupts) SerialA.flush();
+    sei();
+    while (SerialA.transmit() || (uart0.udr >= 0) || (uart0.shifting > 0)) (void)(unsigned char)UCSR0A;
+  } catch (hang&) { sei(); printf("write() hung with interrupts %s\n",interrupts?"on":"off"); return false; }
+  return uart0.wire == expect;
+}
+
+// a wait that never reads a register doesn't let the UART run at all
+static void watchdog(int) { printf("write() hung spinning on the buffer\nFAIL\n"); exit(1); }
+
+int main() {
+  signal(SIGALRM,watchdog); alarm(10);
+  SerialA.begin(9600);
+
+  std::string replies;
+  for (int r=0; r < 100; r++) { char s[100]; snprintf(s,sizeof(s),"reply %d:%s#",r,std::string(r%70,'x').c_str()); replies+=s; }
+  std::string binary;
+  for (int i=0; i < 600; i++) binary+=(char)(i%7?(i&0xff):0);
+
+  CHECK(send(true,replies,37),"replies with interrupts on didn't come out right");
+  CHECK(send(false,replies,37),"replies with interrupts off didn't come out right");
+  CHECK(send(true,binary,300),"binary with interrupts on didn't come out right");
+  CHECK(send(false,binary,300),"binary with interrupts off didn't come out right");
+  CHECK(!(ucsr0b & _BV(UDRIE0)),"UDRE interrupt left on with nothing to send");
+
+  printf("%s\n",failures?"FAIL":"OK");
+  return failures?1:0;
+}
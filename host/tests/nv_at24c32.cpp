@@ -0,0 +1,44 @@
+// -----------------------------------------------------------------------------------
+// The AT24C32 NV driver on the I2C bus model (HAL_LINUX_NV_AT24C32)
+
+// Saving the PEC table in the background mustn't hold up the 1/100 second loop: each pecSavePoll() should only queue
+// a page write, never wait out the EEPROM's write cycle.
+
+#include "OnStep.cpp"
+
+static int failures=0;
+#define CHECK(c,...) if (!(c)) { printf(__VA_ARGS__); printf("\n"); failures++; }
+
+// the main loop between 1/100 second ticks, polling the bus
+static void loopFor(unsigned long us) { for (unsigned long t=0; t < us; t+=50) { delayMicroseconds(50); i2cBus.poll(); } }
+
+static void pecSaveInBackground() {
+  byte *mem=i2cMock.memory(I2C_EEPROM_ADDRESS);
+  for (int i=0; i < pecBufferSize; i++) pecSet(i,(i*7)%41-20);
+  long cycles=i2cMock.writeCycles;
+  pecSave();
+  unsigned long longest=0; int ticks=0;
+  while ((pecAutoRecord > 0) && (ticks < 10000)) {
+    unsigned long t0=micros(); pecSavePoll(); unsigned long t=micros()-t0;
+    if (t > longest) longest=t;
+    loopFor(10000); ticks++;
+  }
+  loopFor(50000);
+  CHECK(memcmp(&mem[EE_pecTable],pecShadow,pecBufferSize) == 0,"PEC table not saved");
+  CHECK(longest < 500,"pecSavePoll() took %luus",longest);
+  long pages=(pecBufferSize+EE_pecTable%I2C_EEPROM_PAGE+I2C_EEPROM_PAGE-1)/I2C_EEPROM_PAGE;
+  CHECK(i2cMock.writeCycles-cycles == pages,"%ld write cycles for %ld pages",i2cMock.writeCycles-cycles,pages);
+  printf("PEC table %d bytes in %d ticks, %ld write cycles, pecSavePoll() %luus at most\n",pecBufferSize,ticks,i2cMock.writeCycles-cycles,longest);
+}
+
+int main() {
+  i2cMock.add(I2C_EEPROM_ADDRESS,E2END+1,2,I2C_EEPROM_PAGE,10);
+  nv.init();
+  createPecBuffer();
+  if (pecShadow == NULL) { printf("no PEC buffer\n"); return 1; }
+
+  pecSaveInBackground();
+
+  printf("%s\n",failures?"FAIL":"OK");
+  return failures?1:0;
+}
@@ -0,0 +1,50 @@
+// -----------------------------------------------------------------------------------
+// The AT24C32 NV drivers (HAL_LINUX_NV_AT24C32 and its caching version HAL_LINUX_NV_AT24C32_C) against a plain array
+
+// A random workload of byte, int, long and block writes and reads all over the EEPROM, runs of them crossing page
+// boundaries, with the bus polled in between as the main loop does.  Every read has to return what the array holds
+// and once the writes are out the EEPROM has to hold the same as the array.  It should also take fewer write cycles
+// than writing a byte at a time.
+
+#include "OnStep.cpp"
+
+static int failures=0;
+#define CHECK(c,...) if (!(c)) { printf(__VA_ARGS__); printf("\n"); failures++; }
+
+// the main loop between 1/100 second ticks, polling the bus and NV
+static void loopFor(unsigned long us) { for (unsigned long t=0; t < us; t+=50) { delayMicroseconds(50); i2cBus.poll(); nv.poll(); } }
+
+static byte ref[E2END+1];
+
+int main() {
+  i2cMock.add(I2C_EEPROM_ADDRESS,E2END+1,2,I2C_EEPROM_PAGE,10);
+  byte *mem=i2cMock.memory(I2C_EEPROM_ADDRESS);
+  srand(1);
+  for (int i=0; i <= E2END; i++) ref[i]=mem[i]=rand();
+  nv.init();
+
+  long bytes=0, wrong=0;
+  for (int n=0; n < 3000; n++) {
+    int a=rand()%(E2END+1-64);
+    switch (rand()%6) {
+      case 0: { byte b=rand(); nv.update(a,b); ref[a]=b; bytes++; } break;
+      case 1: { int v=rand(); nv.writeInt(a,v); memcpy(&ref[a],&v,2); bytes+=2; } break;
+      case 2: { long v=rand(); nv.writeLong(a,v); memcpy(&ref[a],&v,4); bytes+=4; } break;
+      case 3: { byte v[60]; int c=1+rand()%60; for (int k=0; k < c; k++) v[k]=rand(); nv.writeBytes(a,v,c); memcpy(&ref[a],v,c); bytes+=c; } break;
+      case 4: { uint32_t v=nv.readLong(a), r; memcpy(&r,&ref[a],4); if (v != r) wrong++; } break;   // NV longs are 4 bytes
+      case 5: { byte v[64]; int c=1+rand()%64; nv.readBytes(a,v,c); if (memcmp(v,&ref[a],c)) wrong++; } break;
+    }
+    if (nv.read(a) != ref[a]) wrong++;
+    if (rand()%4 == 0) loopFor(1000);
+  }
+  loopFor(20000000);
+
+  int differ=0; for (int i=0; i <= E2END; i++) if (mem[i] != ref[i]) differ++;
+  CHECK(wrong == 0,"%ld reads didn't match",wrong);
+  CHECK(differ == 0,"%d bytes in the EEPROM differ",differ);
+  CHECK(i2cMock.writeCycles < bytes,"%ld write cycles for %ld bytes",i2cMock.writeCycles,bytes);
+  printf("%ld bytes written in %ld write cycles, %ld transactions\n",bytes,i2cMock.writeCycles,i2cMock.transactions);
+
+  printf("%s\n",failures?"FAIL":"OK");
+  return failures?1:0;
+}
@@ -0,0 +1,92 @@
+// -----------------------------------------------------------------------------------
+// Moving library catalogs saved with another NV layout (initNvLayout, Library::relocate)
+
+#include "OnStep.cpp"
+
+static int failures=0;
+#define CHECK(c,...) if (!(c)) { printf(__VA_ARGS__); printf("\n"); failures++; }
+
+#define CUR_FIRST (EE_pecTable+pecTableBytes)
+#define CUR_LAST  (EE_journal-1)
+#define CUR_RECS  ((CUR_LAST-CUR_FIRST+1)/rec_size)
+
+static void erase() { for (int i=0; i <= E2END; i++) nv.write(i,0xff); nv.writeLong(EE_autoInitKey,initKey); }
+
+static void putRec(int l, int n, bool used) {
+  libRec_t r; memset(&r,0,sizeof(r));
+  sprintf(r.libRec.name,"R%d",n);
+  r.libRec.code=used?((n%3)<<4)|(n%14):15<<4;
+  r.libRec.RA=n; r.libRec.Dec=~n;
+  for (int m=0; m < rec_size; m++) nv.write(l+m,r.libRecBytes[m]);
+}
+
+// record l of the current catalog is the n'th one saved
+static bool isRec(int l, int n) {
+  libRec_t r; nv.readBytes(CUR_FIRST+l*rec_size,r.libRecBytes,rec_size);
+  char name[11]; sprintf(name,"R%d",n);
+  return (strcmp(r.libRec.name,name) == 0) && (r.libRec.code == (((n%3)<<4)|(n%14))) && (r.libRec.RA == n);
+}
+
+static int countRecs() {
+  int c=0;
+  for (int l=0; l < CUR_RECS; l++) { if ((nv.read(CUR_FIRST+l*rec_size+11)>>4) != 15) c++; }
+  return c;
+}
+
+// saves every other record of a catalog at first..last, the n'th used record is named R<n>, returns how many
+static int saveCatalog(int first, int last, bool gaps) {
+  int recs=(last-first+1)/rec_size, n=0;
+  for (int l=0; l < recs; l++) { bool used=!gaps || (l%2 == 0); putRec(first+l*rec_size,n,used); if (used) n++; }
+  return n;
+}
+
+static void layoutFromBeforeTheJournal() {
+  erase();
+  nv.write(EE_parkStatus,Parked); nv.write(EE_pecRecorded,true);
+  int first=EE_pecTable+(int)PEC_BUFFER_SIZE, last=E2END-100;
+  int n=saveCatalog(first,last,true);
+  CHECK(n < CUR_RECS,"test needs the records to fit");
+  nvj.init();
+  initNvLayout();
+
+  for (int l=0; l < n; l++) CHECK(isRec(l,l),"legacy: record %d is wrong",l);
+  CHECK(countRecs() == n,"legacy: %d records, expected %d",countRecs(),n);
+  bool erased=true; for (int i=EE_journal; i < EE_journal+NV_JOURNAL_SIZE; i++) if (nv.read(i) != 0xff) erased=false;
+  CHECK(erased,"legacy: catalog records left in the journal");
+  CHECK(nvj.read(EE_parkStatus) == Parked,"legacy: park status lost");
+  CHECK(nvj.read(EE_pecRecorded) == true,"legacy: PEC table dropped although its size didn't change");
+  int f, l; CHECK(Lib.savedRange(&f,&l) && f == CUR_FIRST && l == CUR_LAST,"legacy: range not saved");
+
+  // the next start leaves it alone
+  nv.write(EE_journal,0x12);
+  initNvLayout();
+  CHECK(nv.read(EE_journal) == 0x12,"legacy: moved again");
+}
+
+static void pecTableResized(int delta, bool full) {
+  erase();
+  int first=CUR_FIRST+delta, last=CUR_LAST;
+  int n=saveCatalog(first,last,!full);
+  nv.writeInt(EE_libLayout,first); nv.writeInt(EE_libLayout+2,last); nv.writeInt(EE_libLayout+4,first^last^0x5aa5);
+  nvj.init();
+  nvj.write(EE_pecRecorded,true);
+  initNvLayout();
+
+  int kept=n < CUR_RECS?n:CUR_RECS;
+  for (int l=0; l < kept; l++) CHECK(isRec(l,l),"moved %d: record %d is wrong",delta,l);
+  CHECK(countRecs() == kept,"moved %d: %d records, expected %d",delta,countRecs(),kept);
+  CHECK(nvj.read(EE_pecRecorded) == false,"moved %d: the PEC table wasn't dropped",delta);
+  printf("catalog moved %+d bytes: %d of %d records kept\n",delta,kept,n);
+}
+
+int main() {
+  nv.init();
+  layoutFromBeforeTheJournal();
+  pecTableResized(-160,false);
+  pecTableResized(160,false);
+  pecTableResized(-160,true);
+  pecTableResized(48,true);
+
+  printf("%s\n",failures?"FAIL":"OK");
+  return failures?1:0;
+}
@@ -0,0 +1,71 @@
+// -----------------------------------------------------------------------------------
+// PEC_HIRES_ON table encoding: any table fits in pecTableBytes, smooth tables come back exactly
+// and a table that doesn't (more than one bin in eight needs a full value) isn't saved as if it did
+
+#include "OnStep.cpp"
+
+static int failures=0;
+#define CHECK(c,...) if (!(c)) { fprintf(stderr,__VA_ARGS__); fprintf(stderr,"\n"); failures++; }
+
+static int16_t *saved;
+
+// the reply to a command (replies go to stdout, a file here)
+static void command(const char *s, char *r, int size) {
+  fflush(stdout); long before=ftell(stdout);
+  simSerialInject(s); processCommands();
+  fflush(stdout); long n=ftell(stdout)-before; if (n > size-1) n=size-1;
+  fseek(stdout,before,SEEK_SET); n=fread(r,1,n,stdout); fseek(stdout,0,SEEK_END);
+  r[n]=0;
+}
+
+static void roundTrip(const char *name, bool exact) {
+  long N=PecBinsPerWormRotationAxis1;
+  for (long i=0; i < N; i++) saved[i]=pecGet(i);
+  bool ok=pecSave(); pecAutoRecord=0;
+  int n=pecSaveSize;
+  CHECK(n > 0 && n <= pecTableBytes,"%s: encoded to %d bytes, %d set aside",name,n,pecTableBytes);
+  CHECK(ok == exact,"%s: pecSave() %s",name,ok?"succeeded with bins slewed":"failed");
+  CHECK(pecSaveSlewed == !exact,"%s: pecSaveSlewed %s",name,pecSaveSlewed?"set":"not set");
+  for (long i=0; i < N; i++) pecSet(i,0);
+  CHECK(pecDecode(pecShadow),"%s: doesn't decode",name);
+  long differ=0;
+  for (long i=0; i < N; i++) if (pecGet(i) != saved[i]) differ++;
+  CHECK(differ == pecEncodeSlewed,"%s: %ld bins differ, %ld counted as slewed",name,differ,pecEncodeSlewed);
+  if (exact) { CHECK(differ == 0,"%s: %ld bins differ",name,differ); } else { CHECK(differ > 0,"%s: no bins slewed",name); }
+  fprintf(stderr,"%s: %ld bins in %d of %d bytes, %ld bins slewed\n",name,N,n,pecTableBytes,differ);
+}
+
+int main() {
+  if (freopen("pec_hires.out","w+",stdout) == NULL) { fprintf(stderr,"can't open pec_hires.out\n"); return 1; }
+  createPecBuffer();
+  if (pecShadow == NULL) { fprintf(stderr,"no PEC buffer\n"); return 1; }
+  long N=PecBinsPerWormRotationAxis1;
+  saved=(int16_t*)malloc(N*sizeof(int16_t));
+
+  // a worm's periodic error, the usual case
+  for (long i=0; i < N; i++) pecSet(i,lround(40.0*sin(2.0*PI*i/N)+6.0*sin(8.0*PI*i/N)));
+  roundTrip("smooth",true);
+
+  // changes of more than +/-7 in a bin are kept as full values, up to one bin in eight
+  for (long i=0; i < N; i++) pecSet(i,(i/16)%2?500:-500);
+  roundTrip("square",true);
+
+  // the worst case, every bin a full value
+  srand(1);
+  for (long i=0; i < N; i++) pecSet(i,(rand()%(2*PEC_MAX+1))-PEC_MAX);
+  roundTrip("random",false);
+
+  // :$QZ? says so until the next save that fits
+  char r[16];
+  command(":$QZ?#",r,sizeof(r));
+  CHECK(strcmp(r,"I!#") == 0,":$QZ? returned %s after a save that slewed bins",r);
+
+  // all zero
+  for (long i=0; i < N; i++) pecSet(i,0);
+  roundTrip("zero",true);
+  command(":$QZ?#",r,sizeof(r));
+  CHECK(strcmp(r,"I#") == 0,":$QZ? returned %s after a save that fit",r);
+
+  fprintf(stderr,"%s\n",failures?"FAIL":"OK");
+  return failures?1:0;
+}
@@ -0,0 +1,69 @@
+// -----------------------------------------------------------------------------------
+// TIMER_RATE_TABLE: rate compensation doesn't keep rebuilding the table, and what it holds stays right
+
+// An hour of refraction rate compensation, the tracking rate changes every second like setDeltaTrackingRate() does,
+// with rateTablePoll() run after each change.  Each second the ISR's lookup has to find the table and every entry has
+// to step at the rate it should to within 1/SiderealRate x sidereal (a timer count at the sidereal rate,) close to a stop
+// the intervals get very long and a count doesn't mean much, and at a stop the ISR does the calculation itself.  Then a sync, where the table isn't used.
+
+#include "OnStep.cpp"
+
+static int failures=0;
+#define CHECK(c,...) if (!(c)) { printf(__VA_ARGS__); printf("\n"); failures++; }
+
+// the number of entries that step too far from round(SiderealRate/rate) for the current rates
+static long wrongEntries() {
+  long wrong=0;
+  for (int g=0; g < 3; g++) {
+    double guideA=0.0; if (g == 1) guideA=rateTableGuideRate; else if (g == 2) guideA=-rateTableGuideRate;
+    for (int p=-RATE_TABLE_PEC_STEPS; p <= RATE_TABLE_PEC_STEPS; p++) {
+      double rate=guideA+((double)p/StepsPerSecondAxis1)+trackingTimerRateAxis1;
+      if (fabs(rate) <= 0.00001) continue;
+      long iv=round((double)SiderealRate/fabs(rate)); if (rate < 0) iv=-iv;
+      long e=rateTableAxis1[g][p+RATE_TABLE_PEC_STEPS].interval;
+      if (e == 0) { if (fabs(rate) > 0.0001) wrong++; continue; }   // not in the table, the ISR works it out
+      if ((e < 0) != (iv < 0)) { wrong++; continue; }
+      if ((labs(e-iv) > 1) && (fabs((double)SiderealRate/e-(double)SiderealRate/iv)*SiderealRate > 1.0)) wrong++;
+    }
+  }
+  return wrong;
+}
+
+int main() {
+  SiderealRate=siderealInterval/StepsPerSecondAxis1;
+  trackingState=TrackingSidereal;
+  enableGuideRate(1);
+
+  // refraction changes the rate by up to a few parts in 10^5 over an hour near the horizon
+  int rebuilds=0, misses=0; long wrong=0;
+  double built=0.0;
+  for (int s=0; s < 3600; s++) {
+    trackingTimerRateAxis1=1.0-0.00005*(s/3600.0)+0.000002*sin(s/60.0);
+    rateTablePoll();
+    if (rateTableBuiltRate != built) { built=rateTableBuiltRate; rebuilds++; }
+    pecStepsAxis1=(s%21)-10;
+    if (rateTableLookupAxis1(s%2?rateTableGuideRate:0.0) == NULL) misses++;
+    wrong+=wrongEntries();
+  }
+  CHECK(rebuilds < 180,"%d rebuilds in an hour",rebuilds);
+  CHECK(misses == 0,"the ISR missed the table %d times",misses);
+  CHECK(wrong == 0,"%ld entries out",wrong);
+  printf("an hour of rate compensation, %d rebuilds (SiderealRate %ld)\n",rebuilds,SiderealRate);
+
+  // a sync moves the rate by up to 5x each second, the ISR does the calculation itself meanwhile
+  trackingSyncSeconds=10; rebuilds=0;
+  for (int s=0; s < 10; s++) {
+    trackingTimerRateAxis1=1.0+0.5*(s+1);
+    rateTablePoll();
+    if (rateTableBuiltRate != built) { built=rateTableBuiltRate; rebuilds++; }
+    CHECK(rateTableLookupAxis1(0.0) == NULL,"table used during a sync");
+  }
+  CHECK(rebuilds == 0,"%d rebuilds during a sync",rebuilds);
+  trackingSyncSeconds=0;
+  trackingTimerRateAxis1=1.0;
+  rateTablePoll();
+  CHECK(rateTableLookupAxis1(0.0) != NULL && wrongEntries() == 0,"table not rebuilt after the sync");
+
+  printf("%s\n",failures?"FAIL":"OK");
+  return failures?1:0;
+}
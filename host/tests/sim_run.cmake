@@ -0,0 +1,23 @@
+# Runs the simulator in a scratch directory then checks its replies and step trace
+#   -DSIM=OnStepSim -DARGS=<simulator args> [-DEXPECT=<regex in the replies>] [-DSIMTRACE=simtrace -DCHECK=<simtrace args>]
+
+string(MD5 tag "${ARGS}${CHECK}")
+set(work ${CMAKE_CURRENT_BINARY_DIR}/sim_${tag})
+file(REMOVE_RECURSE ${work})
+file(MAKE_DIRECTORY ${work})
+
+execute_process(COMMAND ${SIM} ${ARGS} WORKING_DIRECTORY ${work} RESULT_VARIABLE r OUTPUT_VARIABLE replies)
+message("replies: ${replies}")
+if(NOT r EQUAL 0)
+  message(FATAL_ERROR "simulator failed (${r})")
+endif()
+if(DEFINED EXPECT AND NOT replies MATCHES "${EXPECT}")
+  message(FATAL_ERROR "replies don't match ${EXPECT}")
+endif()
+
+if(DEFINED SIMTRACE)
+  execute_process(COMMAND ${SIMTRACE} ${CHECK} ${work}/OnStep.trace RESULT_VARIABLE r)
+  if(NOT r EQUAL 0)
+    message(FATAL_ERROR "simtrace check failed (${r})")
+  endif()
+endif()
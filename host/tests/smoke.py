@@ -0,0 +1,48 @@
+#!/usr/bin/env python3
+# -----------------------------------------------------------------------------------
+# Starts the host build of OnStep in a scratch directory, talks to it on SerialA's pty, and checks a few replies
+
+# usage: smoke.py ONSTEP_BINARY
+
+import os
+import subprocess
+import sys
+import tempfile
+import time
+import tty
+
+PTY='/tmp/OnStep-SerialA'
+
+def command(fd, cmd, wait=0.3):
+    os.write(fd,cmd.encode())
+    time.sleep(wait)
+    try: return os.read(fd,256).decode()
+    except BlockingIOError: return ''
+
+def main():
+    work=tempfile.mkdtemp()
+    p=subprocess.Popen([os.path.abspath(sys.argv[1])],cwd=work,stdout=subprocess.DEVNULL,stderr=subprocess.PIPE)
+    try:
+        # setup() takes 2.5s before it's ready for commands
+        deadline=time.time()+10
+        while not os.path.exists(PTY) and time.time() < deadline: time.sleep(0.1)
+        time.sleep(3)
+        fd=os.open(PTY,os.O_RDWR|os.O_NOCTTY|os.O_NONBLOCK)
+        tty.setraw(fd)
+        checks=[(':GVP#','On-Step#'),(':GVN#','3.7c#'),(':Te#','1'),(':GU#',None)]
+        failed=0
+        for cmd,expect in checks:
+            r=command(fd,cmd)
+            ok=(r == expect) if expect is not None else (r.endswith('#') and 'n' not in r[:2])
+            print('%-8s %-12s %s' % (cmd,r,'ok' if ok else 'FAILED'))
+            if not ok: failed+=1
+        # and tracking should have turned on
+        r=command(fd,':GU#')
+        if 'n' in r: print('not tracking after :Te#'); failed+=1
+        os.close(fd)
+        return 1 if failed else 0
+    finally:
+        p.terminate(); p.wait()
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,111 @@
+// -----------------------------------------------------------------------------------
+// Pushed binary telemetry (:GXB0#, :SXB2,n#) stops when its client goes away
+
+// A client enables binary telemetry and subscribes to a frame every 1/10 second, then keeps the channel alive with a
+// :GXB1# every 30 seconds for five minutes.  The frames keep coming all that time.  Once it goes quiet the stream and
+// binary telemetry have to be dropped BINARY_TIMEOUT_MS later, and a new :SXB2# is refused until :GXB0# is sent again.
+// First a :GXB1# frame is taken apart, with the mount away from home, and checked against :GRa#, :GDe# and :Gu#.
+
+#include "OnStep.cpp"
+
+static int failures=0;
+#define CHECK(c,...) if (!(c)) { fprintf(stderr,__VA_ARGS__); fprintf(stderr,"\n"); failures++; }
+
+// the frames and replies go to stdout, counts the bytes written
+static long written() { fflush(stdout); return ftell(stdout); }
+
+static void command(const char *s) { simSerialInject(s); processCommands(); }
+
+// the reply to a command
+static int reply(const char *s, char *r, int size) {
+  long before=written();
+  command(s);
+  long n=written()-before; if (n > size-1) n=size-1;
+  fseek(stdout,before,SEEK_SET); n=fread(r,1,n,stdout); fseek(stdout,0,SEEK_END);
+  r[n]=0;
+  return n;
+}
+
+static long getLong(const char *s) { long v=0; for (int i=3; i >= 0; i--) v=(v<<8)|(byte)s[i]; return (int32_t)v; }
+
+// CRC-16/CCITT-FALSE, bit by bit
+static uint16_t crcCcitt(const byte *b, int n) {
+  uint16_t crc=0xFFFF;
+  for (int i=0; i < n*8; i++) {
+    bool bit=((b[i/8]>>(7-i%8))&1) != ((crc>>15)&1);
+    crc<<=1; if (bit) crc^=0x1021;
+  }
+  return crc;
+}
+
+static void frame() {
+  cli(); posAxis1=123456; posAxis2=-65432; lst=4012345L; isrTimerRateAxis1=64000; timerDirAxis1=1; isrTimerRateAxis2=16000; timerDirAxis2=-1; sei();
+  trackingState=TrackingSidereal; atHome=false;
+  simClock+=16000000ULL;
+
+  char f[64], r[32], u[32];
+  int n=reply(":GXB1#",f,sizeof(f));
+  CHECK(n == 42,"frame %d bytes, should be 42",n);
+  CHECK(f[0] == 0x02,"STX %02X",(byte)f[0]);
+  CHECK(f[1] == 37,"payload length %d, should be 37",f[1]);
+  CHECK(f[2] == 1,"frame type %d, should be 1",f[2]);
+  uint16_t crc=(byte)f[40]|((byte)f[41]<<8);
+  CHECK(crc == crcCcitt((byte*)&f[1],39),"CRC %04X, should be %04X",crc,crcCcitt((byte*)&f[1],39));
+
+  CHECK(getLong(&f[3]) == posAxis1+indexAxis1Steps,"Axis1 %ld steps, should be %ld",getLong(&f[3]),posAxis1+indexAxis1Steps);
+  CHECK(getLong(&f[7]) == posAxis2+indexAxis2Steps,"Axis2 %ld steps, should be %ld",getLong(&f[7]),posAxis2+indexAxis2Steps);
+  CHECK(getLong(&f[11]) == lst,"lst %ld, should be %ld",getLong(&f[11]),lst);
+
+  int h,m; double sec;
+  reply(":GRa#",r,sizeof(r));
+  double ra=(sscanf(r,"%d:%d:%lf",&h,&m,&sec) == 3)?((h+m/60.0+sec/3600.0)*15.0):-1;
+  CHECK(fabs(getLong(&f[15])/360000.0-ra)*3600.0 < 0.01,"RA %.4f\" from the frame, :GRa# %s",getLong(&f[15])/100.0,r);
+  reply(":GDe#",r,sizeof(r));
+  char sign; double dec=(sscanf(r,"%c%d*%d:%lf",&sign,&h,&m,&sec) == 4)?(h+m/60.0+sec/3600.0)*(sign == '-'?-1:1):-999;
+  CHECK(fabs(getLong(&f[19])/360000.0-dec)*3600.0 < 0.01,"Dec %.2f\" from the frame, :GDe# %s",getLong(&f[19])/100.0,r);
+
+  CHECK(getLong(&f[23]) == 250000,"Axis1 rate %ldmHz, should be 250000",getLong(&f[23]));
+  CHECK(getLong(&f[27]) == -1000000,"Axis2 rate %ldmHz, should be -1000000",getLong(&f[27]));
+  statusBits(u);
+  CHECK(memcmp(&f[31],u,9) == 0,"status bits differ");
+  fprintf(stderr,"frame RA %.2f\" Dec %.2f\", :GRa# and :GDe# %s\n",getLong(&f[15])/100.0,getLong(&f[19])/100.0,r);
+}
+
+// the 1/100 second ticks in loop2()
+static void runFor(unsigned long ms) { for (unsigned long t=0; t < ms; t+=10) { simClock+=160000ULL; telemetryPoll(); } }
+
+int main() {
+  if (freopen("telemetry.out","w+",stdout) == NULL) { fprintf(stderr,"can't open telemetry.out\n"); return 1; }
+
+  command(":GXB0#");
+  frame();
+  command(":SXB2,10#");
+  CHECK(telemetryChannel == COMMAND_SERIAL_A,"not subscribed");
+
+  // five minutes with a command every 30 seconds, 10 frames a second
+  long before=written();
+  for (int i=0; i < 10; i++) { runFor(30000); command(":GXB1#"); }
+  long frames=(written()-before)/42-10;
+  CHECK(telemetryChannel == COMMAND_SERIAL_A,"dropped while the client was still sending commands");
+  CHECK(abs(frames-3000) <= 1,"%ld frames in five minutes, should be 3000",frames);
+
+  // then nothing
+  runFor(BINARY_TIMEOUT_MS-10);
+  CHECK(telemetryChannel == COMMAND_SERIAL_A,"dropped early");
+  runFor(20);
+  CHECK(telemetryChannel == COMMAND_NONE,"still pushing frames %lums after the last command",BINARY_TIMEOUT_MS+10);
+  CHECK(!bitRead(binaryChannels,COMMAND_SERIAL_A),"binary telemetry still enabled");
+  before=written();
+  runFor(10000);
+  CHECK(written() == before,"frames sent after the stream was dropped");
+
+  // it has to be negotiated again
+  command(":SXB2,10#");
+  CHECK(telemetryChannel == COMMAND_NONE,"subscribed without :GXB0#");
+  command(":GXB0#");
+  command(":SXB2,10#");
+  CHECK(telemetryChannel == COMMAND_SERIAL_A,"not subscribed again");
+
+  fprintf(stderr,"%s\n",failures?"FAIL":"OK");
+  return failures?1:0;
+}
@@ -0,0 +1,70 @@
+// -----------------------------------------------------------------------------------
+// TIMER_FIXED_POINT: a night of tracking gives the same steps as the double calculation
+
+// Ten hours of timerSupervisor() passes with the tracking rates changing every second (as rate compensation does,)
+// PEC playback corrections and 0.5x guide pulses on both axes.  The intervals the fixed point path comes up with are
+// compared against round(SiderealRate/rate) in doubles and the steps they'd give are added up for the night.  They can
+// round the other way (one count) and since the rates are good to 2^-24 (Q8.24) very slow ones can be a few counts out.
+
+#include "OnStep.cpp"
+
+static int failures=0;
+#define CHECK(c,...) if (!(c)) { printf(__VA_ARGS__); printf("\n"); failures++; }
+
+#define NIGHT_CS (10L*3600L*100L)
+
+// within a count, or stepping within 2^-24 x sidereal of it
+static bool close(long iv, long ref) {
+  return (labs(iv-ref) <= 1) || (fabs((double)SiderealRate/iv-(double)SiderealRate/ref) < 1.0/16777216.0);
+}
+
+int main() {
+  SiderealRate=siderealInterval/StepsPerSecondAxis1;
+  trackingState=TrackingSidereal;
+  parkStatus=NotParked;
+  axis1Enabled=true; axis2Enabled=true;
+
+  srand(1);
+  double steps1=0, steps1Ref=0, steps2=0, steps2Ref=0;
+  long differ=0, wrong=0;
+  for (long cs=0; cs < NIGHT_CS; cs++) {
+    if (cs%100 == 0) {
+      // rate compensation, PEC playback and guiding change once a second
+      double h=cs/360000.0;
+      cli();
+      trackingTimerRateAxis1=1.0+0.0004*sin(h/3.0)+0.00003*h;
+      trackingTimerRateAxis2=0.0003*cos(h/2.0);
+      TIMER_RATE_Q(trackingTimerRateAxis1Q=toQ24(trackingTimerRateAxis1); trackingTimerRateAxis2Q=toQ24(trackingTimerRateAxis2));
+      sei();
+      int l=lround(10.0*sin(2.0*PI*cs/48000.0)); setPecRate((double)l/StepsPerSecondAxis1,l);
+      switch (rand()%8) {
+        case 0: startGuideAxis1(rand()%2?'e':'w',1,0); break;
+        case 1: stopGuideAxis1(); break;
+        case 2: startGuideAxis2(rand()%2?'n':'s',1,0); break;
+        case 3: stopGuideAxis2(); break;
+      }
+    }
+    timerSupervisor(true);
+    double g1=guideDirAxis1?guideTimerRateAxis1:0.0, g2=guideDirAxis2?guideTimerRateAxis2:0.0;
+
+    long ref1=lround((double)SiderealRate/fabs(g1+pecTimerRateAxis1+trackingTimerRateAxis1));
+    if (runTimerRateAxis1 != ref1) { differ++; if (!close(runTimerRateAxis1,ref1)) wrong++; }
+    steps1+=160000.0/runTimerRateAxis1; steps1Ref+=160000.0/ref1;
+
+    double r2=fabs(g2+trackingTimerRateAxis2);
+    if (r2 > 0.00011) {
+      long ref2=lround((double)SiderealRate/r2);
+      if (runTimerRateAxis2 != ref2) { differ++; if (!close(runTimerRateAxis2,ref2)) wrong++; }
+      steps2+=160000.0/runTimerRateAxis2; steps2Ref+=160000.0/ref2;
+    }
+  }
+
+  CHECK(wrong == 0,"%ld intervals more than a count out",wrong);
+  CHECK(fabs(steps1-steps1Ref) < 1.0,"Axis1 %.2f steps, %.2f with doubles",steps1,steps1Ref);
+  CHECK(fabs(steps2-steps2Ref) < 1.0,"Axis2 %.2f steps, %.2f with doubles",steps2,steps2Ref);
+  printf("Axis1 %.1f steps (%+.3f), Axis2 %.1f steps (%+.3f), %ld of %ld intervals differ\n",
+    steps1,steps1-steps1Ref,steps2,steps2-steps2Ref,differ,NIGHT_CS*2);
+
+  printf("%s\n",failures?"FAIL":"OK");
+  return failures?1:0;
+}
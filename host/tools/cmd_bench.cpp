@@ -0,0 +1,165 @@
+// -----------------------------------------------------------------------------------
+// Times the command hand off and first level dispatch in processCommands(), before and after they were reworked
+
+// usage: cmd_bench [N]
+//
+// Each command is add()ed to a command buffer a char at a time then handed to a dispatch on command[0] shaped like
+// processCommands(): the if/else chain over the command groups in their order there and the strcpy()s out of a buffer
+// that copies (the way it was,) against the switch and the command and parameter in place from src/lib/Command.h.
+// Both have to hand over the same command and parameter, the exit code is 1 if they don't.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+typedef unsigned char byte;
+#define ALTAZM 3
+#define MOUNT_TYPE 1
+#include "../../src/lib/Command.h"
+
+// the command buffer as it was, copying the command and parameter out
+namespace before {
+  class cbCopy {
+    public:
+      bool checksum = false;
+      bool add(char c) {
+        // (chr)6 is a special status command for the LX200 protocol
+        if ((c == (char)6) && (cbp == 0)) {
+          #if MOUNT_TYPE == ALTAZM
+            cb[0]=':'; cb[1]=(char)6; cb[2]='A'; cb[3]=0; cbp=3; c='#';
+          #else
+            cb[0]=':'; cb[1]=(char)6; cb[2]='P'; cb[3]=0; cbp=3; c='#';
+          #endif
+        }
+
+        // ignore spaces/lf/cr
+        if ((c != (char)32) && (c != (char)10) && (c != (char)13) && (c != (char)6)) {
+          if (cbp > bufferSize-2) cbp=bufferSize-2;
+          cb[cbp]=c; cbp++; cb[cbp]=(char)0;
+        }
+
+        if (c == '#') {
+          // validate the command frame, normal command
+          if (!(cbp > 1) && ((cb[0] == ':') || (cb[0] == ';')) && (cb[cbp-1] == '#')) { flush(); return false; }
+          if (((cb[0] == ':') || (cb[0] == ';')) && (cb[1] == '#') && (cb[2] == 0)) { flush(); return false; }
+
+          checksum=(cb[0] == ';');
+          if (checksum) {
+            byte len=strlen(cb)-1;
+
+            // Minimum length for a valid command is 5 ';CCS#'
+            if (len < 5) {
+              flush(); cb[0]=':'; cb[1]=(char)6; cb[2]='0'; cb[3]='#'; cb[4]=0; cbp=4; 
+              return true; 
+            }
+          
+            // checksum the data, for example ";111111CCS#".  I don't include the command frame in the checksum.  The error response is a checksumed string "CK_FAILS#" to request re-transmit.
+            byte cks=0; for (int cksCount0=1; cksCount0 < len-3; cksCount0++) {  cks+=cb[cksCount0]; }
+            char chkSum[3]; sprintf(chkSum,"%02X",cks);
+            seq=cb[len-1];
+            if (!((chkSum[0] == cb[len-3]) && (chkSum[1] == cb[len-2]))) { 
+              flush(); cb[0]=':'; cb[1]=(char)6; cb[2]='0'; cb[3]='#'; cb[4]=0; cbp=4; 
+              return true;
+            }
+
+            // remove the sequence char and checksum from string
+            --len; --len; cb[--len]=0;
+          }
+
+          return true;
+        } else {
+          return false;
+        }
+      }
+      char* getCmd() {
+        // the command is either one or two chars in length
+        cmd[0]=0;
+        memmove(cmd,(char *)&cb[1],2); cmd[2]=0;
+        if ((cmd[1] == '#') && (cmd[2] == 0)) cmd[1]=0;
+        return cmd;
+      }
+      char* getParameter() {
+        // the remaining parameter
+        pb[0]=0;
+        if (cbp > 4) memmove(pb,(char *)&cb[3],cbp-4); pb[cbp-4]=0;
+        return pb;
+      }
+      char* getSeq() {
+        static char s[2]=" ";
+        s[0]=seq;
+        return s;
+      }
+      bool ready() {
+        if (!cbp) return false;
+        if ((cb[cbp-1] == '#') && (cbp == 1)) flush();
+        return (cb[cbp-1] == '#');
+      }
+      bool flush() {
+        cbp=0;
+        cb[0]=(char)0;
+        return true;
+      }
+    private:
+      const static int bufferSize=30;
+      char cmd[4]="";
+      char pb[bufferSize]="";
+      char cb[bufferSize]="";
+      int cbp=0;
+      char seq=0;
+  };
+}
+
+static const char *commands[]={":GR#",":GD#",":Sr12:34:56#",":Sd+45*30:15#",":Q#",":W1#",":VR0123#",":GU#"};
+
+// the command groups in the order processCommands() tested them
+static const char groups[]={6,'A','$','%','B','C','D','E','F','G','h','L','M','Q','R','r','S','T','U','V','W'};
+__attribute__((noinline)) int chain(const char *c) {
+  for (unsigned i=0; i < sizeof(groups); i++) if (c[0] == groups[i]) return i;
+  return -1;
+}
+__attribute__((noinline)) int jump(const char *c) {
+  switch (c[0]) {
+    case 6: return 0; case 'A': return 1; case '$': return 2; case '%': return 3; case 'B': return 4; case 'C': return 5;
+    case 'D': return 6; case 'E': return 7; case 'F': return 8; case 'G': return 9; case 'h': return 10; case 'L': return 11;
+    case 'M': return 12; case 'Q': return 13; case 'R': return 14; case 'r': return 15; case 'S': return 16; case 'T': return 17;
+    case 'U': return 18; case 'V': return 19; case 'W': return 20;
+  }
+  return -1;
+}
+
+volatile int sink;
+static double ns(std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b, long n) {
+  return std::chrono::duration<double,std::nano>(b-a).count()/n;
+}
+
+int main(int argc, char **argv) {
+  long n=2000000; if (argc > 1) n=atol(argv[1]);
+  int failures=0;
+
+  printf("%-16s %26s %26s\n","","add() and dispatch (ns)","dispatch only (ns)");
+  for (const char *s : commands) {
+    static char command[3], parameter[25];
+
+    // the same command and parameter both ways
+    before::cbCopy o; for (const char *p=s; *p; p++) o.add(*p);
+    cb c; for (const char *p=s; *p; p++) c.add(*p);
+    strcpy(command,o.getCmd()); strcpy(parameter,o.getParameter());
+    char *cmd=c.getCmd(), *par=c.getParameter();
+    if ((chain(command) != jump(cmd)) || (command[0] != cmd[0]) || (command[1] != cmd[1]) || strcmp(parameter,par)) {
+      printf("%s handed over as %s %s, was %s %s\n",s,cmd,par,command,parameter); failures++;
+    }
+
+    auto t0=std::chrono::steady_clock::now();
+    for (long k=0; k < n; k++) { before::cbCopy a; for (const char *p=s; *p; p++) a.add(*p); strcpy(command,a.getCmd()); strcpy(parameter,a.getParameter()); a.flush(); sink+=chain(command)+parameter[0]; }
+    auto t1=std::chrono::steady_clock::now();
+    for (long k=0; k < n; k++) { cb a; for (const char *p=s; *p; p++) a.add(*p); char *c=a.getCmd(); char *p=a.getParameter(); a.flush(); sink+=jump(c)+p[0]; }
+    auto t2=std::chrono::steady_clock::now();
+    for (long k=0; k < n; k++) { strcpy(command,o.getCmd()); strcpy(parameter,o.getParameter()); sink+=chain(command)+parameter[0]; }
+    auto t3=std::chrono::steady_clock::now();
+    for (long k=0; k < n; k++) { char *c0=c.getCmd(); char *p0=c.getParameter(); sink+=jump(c0)+p0[0]; }
+    auto t4=std::chrono::steady_clock::now();
+    printf("%-16s before %6.1f after %6.1f   before %6.1f after %6.1f\n",s,ns(t0,t1,n),ns(t1,t2,n),ns(t2,t3,n),ns(t3,t4,n));
+  }
+  return failures?1:0;
+}
@@ -0,0 +1,132 @@
+// -----------------------------------------------------------------------------------
+// Reads the simulator's step trace (see src/HAL/HAL_Linux/HAL_Sim.h) and reports step timing for each axis
+
+// usage: simtrace [--dedge] [--from S] [--to S] [--max-missed N] [--max-jitter US] [--max-rate-step PCT]
+//                [--arrival-rate N] [--max-arrival-gap S] [OnStep.trace]
+//
+// Step intervals are compared with the interval PresetTimerInterval() was asked for.  Intervals that span a
+// rate change or a direction change aren't counted.  Jitter is the RMS and largest difference from the
+// asked for interval, and a step is missed when an interval is 1.5x (or more) the one asked for.
+// The rate step is the largest change from one asked for rate to the next, as a percentage of the fastest.  An axis arrives
+// with its last step asked for faster than --arrival-rate (steps a second, default 500,) a goto's end as tracking steps are slower.
+// --dedge counts both step edges (STEP_WAVE_FORM DEDGE,) otherwise a step is a rising edge.
+// With --max-missed, --max-jitter, --max-rate-step or --max-arrival-gap the exit status is 1 when either axis goes over, for tests.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_STEP_LOW  0
+#define SIM_STEP_HIGH 1
+#define SIM_DIR_LOW   2
+#define SIM_DIR_HIGH  3
+#define SIM_PRESET    4
+
+typedef struct {
+  long steps, dirChanges, presets;
+  uint64_t lastStep;        // 0 if there's no step to measure the next interval from
+  uint32_t interval;        // asked for, in ticks
+  long measured, missed;
+  double sumSq, maxDev;     // in ticks
+  double rate, maxRate, maxRateStep; // asked for, in steps a second
+  uint64_t arrival;         // the last step asked for faster than the arrival rate
+} axis_t;
+
+static double tps=16000000.0;
+static double arrivalRate=500.0;
+
+// a rate change or direction change starts a new segment, intervals across it aren't counted
+static void endSegment(axis_t *a) { a->lastStep=0; }
+
+static void step(axis_t *a, uint64_t t) {
+  a->steps++;
+  if (a->lastStep != 0 && a->interval > 0) {
+    double dt=(double)(t-a->lastStep), dev=dt-a->interval;
+    a->measured++; a->sumSq+=dev*dev;
+    if (fabs(dev) > a->maxDev) a->maxDev=fabs(dev);
+    if (dt >= 1.5*a->interval) a->missed+=(long)floor(dt/a->interval+0.5)-1;
+  }
+  if (a->interval > 0 && tps/a->interval > arrivalRate) a->arrival=t;
+  a->lastStep=t;
+}
+
+int main(int argc, char **argv) {
+  const char *name="OnStep.trace";
+  bool dedge=false; double from=0, to=1e30; long maxMissed=-1; double maxJitter=-1, maxRateStep=-1, maxArrivalGap=-1;
+  for (int i=1; i < argc; i++) {
+    if (strcmp(argv[i],"--dedge") == 0) dedge=true; else
+    if (strcmp(argv[i],"--from") == 0 && i+1 < argc) from=atof(argv[++i]); else
+    if (strcmp(argv[i],"--to") == 0 && i+1 < argc) to=atof(argv[++i]); else
+    if (strcmp(argv[i],"--max-missed") == 0 && i+1 < argc) maxMissed=atol(argv[++i]); else
+    if (strcmp(argv[i],"--max-jitter") == 0 && i+1 < argc) maxJitter=atof(argv[++i]); else
+    if (strcmp(argv[i],"--max-rate-step") == 0 && i+1 < argc) maxRateStep=atof(argv[++i]); else
+    if (strcmp(argv[i],"--arrival-rate") == 0 && i+1 < argc) arrivalRate=atof(argv[++i]); else
+    if (strcmp(argv[i],"--max-arrival-gap") == 0 && i+1 < argc) maxArrivalGap=atof(argv[++i]); else
+    if (argv[i][0] != '-') name=argv[i]; else { fprintf(stderr,"usage: %s [--dedge] [--from S] [--to S] [--max-missed N] [--max-jitter US] [--max-rate-step PCT] [--arrival-rate N] [--max-arrival-gap S] [trace]\n",argv[0]); return 2; }
+  }
+
+  FILE *f=fopen(name,"rb");
+  if (f == NULL) { fprintf(stderr,"can't open %s\n",name); return 2; }
+  char magic[4]; uint8_t version; uint32_t ticks;
+  if (fread(magic,1,4,f) != 4 || memcmp(magic,"OSTR",4) != 0 || fread(&version,1,1,f) != 1 || fread(&ticks,4,1,f) != 1) { fprintf(stderr,"%s isn't a trace\n",name); return 2; }
+  if (version != 2) { fprintf(stderr,"trace version %d, this reads version 2\n",version); return 2; }
+  tps=ticks;
+
+  axis_t axis[3]; memset(axis,0,sizeof(axis));
+  uint64_t t=0; long records=0;
+  uint64_t t0=(uint64_t)(from*tps), t1=(to*tps > 1.8e19)?UINT64_MAX:(uint64_t)(to*tps);
+  for (;;) {
+    uint8_t code; if (fread(&code,1,1,f) != 1) break;
+    uint64_t dt=0; int size=(code>>6) == 3?8:((code&0x80)?4:2);
+    if (fread(&dt,size,1,f) != 1) { fprintf(stderr,"trace ends part way through a record\n"); break; }
+    t+=dt; records++;
+    int event=(code>>2)&7, n=code&3;
+    if (n < 1 || n > 2) { fprintf(stderr,"bad axis in record %ld\n",records); return 2; }
+    axis_t *a=&axis[n];
+    bool inside=(t >= t0) && (t <= t1);
+    if (event == SIM_PRESET) {
+      uint32_t nextRate, interval; uint16_t nextRep;
+      if (fread(&nextRate,4,1,f) != 1 || fread(&nextRep,2,1,f) != 1 || fread(&interval,4,1,f) != 1) break;
+      endSegment(a);
+      a->interval=interval;
+      if (inside) {
+        a->presets++;
+        if (interval > 0) {
+          double rate=tps/interval;
+          if (a->rate > 0 && fabs(rate-a->rate) > a->maxRateStep) a->maxRateStep=fabs(rate-a->rate);
+          if (rate > a->maxRate) a->maxRate=rate;
+          a->rate=rate;
+        }
+      }
+    } else
+    if (event == SIM_DIR_LOW || event == SIM_DIR_HIGH) {
+      endSegment(a); if (inside) a->dirChanges++;
+    } else
+    if (event == SIM_STEP_HIGH || (dedge && event == SIM_STEP_LOW)) {
+      if (inside) step(a,t); else a->lastStep=0;
+    }
+    if (t > t1) break;
+  }
+  fclose(f);
+
+  int result=0;
+  printf("%.3f seconds, %ld records\n",t/tps,records);
+  for (int n=1; n <= 2; n++) {
+    axis_t *a=&axis[n];
+    double us=1000000.0/tps;
+    double rms=a->measured?sqrt(a->sumSq/a->measured)*us:0;
+    printf("Axis%d: %ld steps, %ld direction changes, %ld rate changes\n",n,a->steps,a->dirChanges,a->presets);
+    double rateStep=a->maxRate > 0?a->maxRateStep/a->maxRate*100.0:0;
+    printf("  jitter %.3f us RMS, %.3f us max over %ld intervals, %ld missed steps\n",rms,a->maxDev*us,a->measured,a->missed);
+    printf("  fastest %.1f steps/s, largest rate step %.2f%%, arrives at %.3f seconds\n",a->maxRate,rateStep,a->arrival/tps);
+    if (maxMissed >= 0 && a->missed > maxMissed) result=1;
+    if (maxJitter >= 0 && a->maxDev*us > maxJitter) result=1;
+    if (maxRateStep >= 0 && rateStep > maxRateStep) result=1;
+  }
+  double gap=fabs((double)axis[1].arrival-(double)axis[2].arrival)/tps;
+  printf("arrivals %.3f seconds apart\n",gap);
+  if (maxArrivalGap >= 0 && gap > maxArrivalGap) result=1;
+  return result;
+}
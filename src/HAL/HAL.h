@@ -63,8 +63,26 @@
   // ESP32
   #include "HAL_ESP32/HAL_ESP32.h"
 
+#elif defined(__linux__)
+  // Linux host, OnStep runs as a process w/pty serial ports, POSIX timers, and a file backed NV image
+  #include "HAL_Linux/HAL_Linux.h"
+
 #else
   #error "Unsupported Platform! If this is a new platform, it needs the appropriate entries in the HAL directory."
 #endif
 
+// Queued I2C transactions, shared by the NV, RTC and weather drivers, the I2C NV drivers include it themselves
+#if RTC == DS3231 || WEATHER == BME280 || WEATHER == BME280_0x76
+  #include "drivers/I2C_Async.h"
+#endif
+#ifndef HAL_I2C_ASYNC
+// nothing on the bus, the main loop's poll() and the PEC save's idle() check cost nothing and the queue takes no RAM
+class i2cEngine {
+  public:
+    bool idle() { return true; }
+    void poll() { }
+};
+i2cEngine i2cBus;
+#endif
+
 #endif // _HAL_H
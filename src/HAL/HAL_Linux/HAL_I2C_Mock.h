@@ -0,0 +1,82 @@
+// -----------------------------------------------------------------------------------
+// I2C bus model for the queued I2C transactions (see ../drivers/I2C_Async.h)
+
+// Devices are modeled as register files with an address pointer, which covers the AT24C32, FRAM, DS3231 and BME280:
+//   i2cMock.add(0x57,4096,2,32,10);  // AT24C32, 2 address bytes, 32 byte pages, 10ms write cycle
+//   i2cMock.add(0x68,19,1,0,0);      // DS3231 registers
+// The host harness adds the devices it wants and can look at or preload their contents with i2cMock.memory().
+// Writes wrap within a page as the real EEPROM does, and a device NAKs its address until its write cycle is over.
+
+#include <stdlib.h>
+#include <string.h>
+
+#define I2C_MOCK_DEVICES 4
+
+typedef struct {
+  byte address;
+  byte *mem;
+  int size;
+  byte addressBytes;
+  byte page;                      // 0 if writes don't wrap
+  byte writeMs;                   // write cycle, 0 if none
+  int ptr;
+  unsigned long busyUntilMs;
+} i2cMockDevice_t;
+
+class i2cMockBus {
+  public:
+    unsigned long clock=400000;
+    long transactions=0;
+    long writeCycles=0;
+
+    bool add(byte address, int size, byte addressBytes, byte page, byte writeMs) {
+      if (devices >= I2C_MOCK_DEVICES) return false;
+      i2cMockDevice_t *d=&device[devices];
+      d->mem=(byte*)malloc(size); if (d->mem == NULL) return false;
+      memset(d->mem,0xFF,size);
+      d->address=address; d->size=size; d->addressBytes=addressBytes; d->page=page; d->writeMs=writeMs;
+      d->ptr=0; d->busyUntilMs=0;
+      devices++;
+      return true;
+    }
+
+    byte *memory(byte address) {
+      i2cMockDevice_t *d=find(address);
+      if (d == NULL) return NULL; else return d->mem;
+    }
+
+    // does the transaction, returns 0 or 2 (address NAK) as Wire's endTransmission() would and how long it takes on the bus
+    byte transfer(byte address, byte *data, byte txCount, byte rxCount, unsigned long *us) {
+      transactions++;
+      *us=(9UL*(1+txCount+(rxCount > 0?1+rxCount:0))*1000000UL)/clock;
+      i2cMockDevice_t *d=find(address);
+      if ((d == NULL) || ((long)(millis()-d->busyUntilMs) < 0)) { *us=(9UL*1000000UL)/clock; return 2; }
+
+      int n=0;
+      if (txCount >= d->addressBytes) {
+        d->ptr=0; for (; n < d->addressBytes; n++) d->ptr=(d->ptr<<8)|data[n];
+        d->ptr%=d->size;
+      }
+      if (n < txCount) {
+        int base=d->page?d->ptr-(d->ptr%d->page):0;
+        for (int i=0; n < txCount; n++, i++) {
+          int a=d->page?base+((d->ptr-base+i)%d->page):(d->ptr+i)%d->size;
+          d->mem[a]=data[n];
+        }
+        if (d->writeMs) { d->busyUntilMs=millis()+d->writeMs; writeCycles++; }
+      }
+      for (int i=0; i < rxCount; i++) { data[i]=d->mem[d->ptr]; d->ptr=(d->ptr+1)%d->size; }
+      return 0;
+    }
+
+  private:
+    i2cMockDevice_t device[I2C_MOCK_DEVICES];
+    int devices=0;
+
+    i2cMockDevice_t *find(byte address) {
+      for (int i=0; i < devices; i++) if (device[i].address == address) return &device[i];
+      return NULL;
+    }
+};
+
+i2cMockBus i2cMock;
@@ -0,0 +1,263 @@
+// Platform setup ------------------------------------------------------------------------------------
+
+// Host-native build, OnStep runs as a normal Linux process.  The Arduino core API (millis(), micros(),
+// digitalWrite(), etc.) is supplied by the host build's Arduino shim in host/arduino, see host/CMakeLists.txt.
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
+
+// We define a more generic symbol, in case more Linux based hosts are supported
+#define __HAL_LINUX__
+
+// This is for fast processors with hardware FP
+#define HAL_FAST_PROCESSOR
+
+// Lower limit (fastest) step rate in uS for this platform (in SQW mode)
+#define HAL_MAXRATE_LOWER_LIMIT 16
+
+// Width of step pulse
+#define HAL_PULSE_WIDTH 500
+
+// New symbols for the Serial ports so they can be remapped if necessary -----------------------------
+// SerialA is always enabled, SerialB and SerialC are optional, all are pseudo-terminals (see HAL_Serial.h)
+#define HAL_SERIAL_B_ENABLED
+#if SERIAL_C_BAUD_DEFAULT != OFF
+  #define HAL_SERIAL_C_ENABLED
+#endif
+
+// Use pty serial
+#include "HAL_Serial.h"
+
+// New symbol for the default I2C port -------------------------------------------------------------
+#define HAL_Wire Wire
+
+// I2C devices are modeled on the host, for the queued I2C transactions
+#include "HAL_I2C_Mock.h"
+
+// Non-volatile storage ------------------------------------------------------------------------------
+#if defined(HAL_LINUX_NV_AT24C32)
+  // the AT24C32 driver on the bus model, the harness adds the EEPROM with i2cMock.add(0x57,4096,2,32,10)
+  #include "../drivers/NV_I2C_EEPROM_AT24C32.h"
+#elif defined(HAL_LINUX_NV_AT24C32_C)
+  // or its caching version
+  #include "../drivers/NV_I2C_EEPROM_AT24C32_C.h"
+#else
+  #include "../drivers/NV_FILE.h"
+#endif
+
+//--------------------------------------------------------------------------------------------------
+// Interrupts
+
+#define ISR(f) void f (void)
+void TIMER1_COMPA_vect(void);  // Sidereal timer
+void TIMER3_COMPA_vect(void);  // Axis1 RA/Azm timer
+void TIMER4_COMPA_vect(void);  // Axis2 DEC/Alt timer
+void TIMER_AUX_vect(void);     // Rotator/focusers timer
+
+#ifdef HAL_LINUX_SIMULATOR
+  // everything runs on one thread in virtual time, the ISR's are called from simRun() only
+  #include "HAL_Sim.h"
+
+  #undef cli
+  void cli() { }
+  #undef sei
+  void sei() { }
+#else
+  // the timer "ISR's" run on their own threads, this (recursive) mutex gives them and cli()/sei() the
+  // same mutual exclusion a single core MCU has
+  pthread_mutex_t isrMutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+  #define HAL_TIMER1_PREFIX pthread_mutex_lock(&isrMutex)
+  #define HAL_TIMER3_PREFIX pthread_mutex_lock(&isrMutex)
+  #define HAL_TIMER4_PREFIX pthread_mutex_lock(&isrMutex)
+  #define HAL_TIMER_AUX_PREFIX pthread_mutex_lock(&isrMutex)
+  #define HAL_TIMER1_SUFFIX pthread_mutex_unlock(&isrMutex)
+  #define HAL_TIMER3_SUFFIX pthread_mutex_unlock(&isrMutex)
+  #define HAL_TIMER4_SUFFIX pthread_mutex_unlock(&isrMutex)
+  #define HAL_TIMER_AUX_SUFFIX pthread_mutex_unlock(&isrMutex)
+
+  // Override cli/sei and use for the mutex
+  #undef cli
+  void cli() { pthread_mutex_lock(&isrMutex); }
+  #undef sei
+  void sei() { pthread_mutex_unlock(&isrMutex); }
+#endif
+
+//--------------------------------------------------------------------------------------------------
+// General purpose initialize for HAL
+void HAL_Init(void) {
+#ifdef HAL_LINUX_SIMULATOR
+  simTraceOpen();
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+// Internal MCU temperature (in degrees C)
+float HAL_MCU_Temperature(void) {
+  FILE *f=fopen("/sys/class/thermal/thermal_zone0/temp","r");
+  if (f == NULL) return -999;
+  long t=0; if (fscanf(f,"%ld",&t) != 1) t=-999000;
+  fclose(f);
+  return t/1000.0;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Initialize timers
+
+// frequency compensation (F_COMP/1000000.0) for adjusting microseconds to timer counts
+#define F_COMP 16000000.0
+
+// a POSIX interval timer, one thread per timer sleeps to an absolute CLOCK_MONOTONIC deadline then calls the ISR
+typedef struct {
+  void (*isr)(void);
+  volatile uint32_t period;  // in F_COMP counts
+  int priority;
+  pthread_t thread;
+  bool enabled;
+  uint64_t next;             // simulator only, virtual time of the next call
+} linuxTimer_t;
+
+linuxTimer_t itimer1 = { TIMER1_COMPA_vect, 160000, 1, 0, false, 0 };
+linuxTimer_t itimer3 = { TIMER3_COMPA_vect, 128, 2, 0, false, 0 };
+linuxTimer_t itimer4 = { TIMER4_COMPA_vect, 128, 2, 0, false, 0 };
+linuxTimer_t itimerAux = { NULL, 1600, 0, 0, false, 0 };  // the ISR is only there with AUX_AXIS_TIMER_ON
+
+#ifdef HAL_LINUX_SIMULATOR
+void linuxTimerBegin(linuxTimer_t *t) {
+  if (t->enabled) return;
+  t->enabled=true; t->next=simClock+t->period;
+}
+
+// advance virtual time by ticks (1/16 microseconds,) calling the ISR's as their deadlines come due
+// when deadlines coincide the motor timers go first as they would with their higher priority, the aux timer goes last
+void simRun(uint64_t ticks) {
+  uint64_t until=simClock+ticks;
+  for (;;) {
+    linuxTimer_t *t=NULL;
+    if (itimer3.enabled && itimer3.next <= until) t=&itimer3;
+    if (itimer4.enabled && itimer4.next <= until && (t == NULL || itimer4.next < t->next)) t=&itimer4;
+    if (itimer1.enabled && itimer1.next <= until && (t == NULL || itimer1.next < t->next)) t=&itimer1;
+    if (itimerAux.enabled && itimerAux.next <= until && (t == NULL || itimerAux.next < t->next)) t=&itimerAux;
+    if (t == NULL) break;
+    simClock=t->next;
+    t->isr();
+    t->next=simClock+t->period;
+  }
+  simClock=until;
+}
+#else
+void *linuxTimerThread(void *arg) {
+  linuxTimer_t *t=(linuxTimer_t*)arg;
+  struct timespec next, now;
+  clock_gettime(CLOCK_MONOTONIC,&next);
+  for (;;) {
+    next.tv_nsec+=((uint64_t)t->period*1000ULL)/16ULL;
+    while (next.tv_nsec >= 1000000000L) { next.tv_nsec-=1000000000L; next.tv_sec++; }
+    clock_nanosleep(CLOCK_MONOTONIC,TIMER_ABSTIME,&next,NULL);
+    t->isr();
+
+    // if we fall more than 10ms behind (host busy, debugger, etc.) start over rather than burst to catch up
+    clock_gettime(CLOCK_MONOTONIC,&now);
+    if ((now.tv_sec-next.tv_sec)*1000000000L+(now.tv_nsec-next.tv_nsec) > 10000000L) next=now;
+  }
+  return NULL;
+}
+
+void linuxTimerBegin(linuxTimer_t *t) {
+  if (t->thread) return;
+  pthread_create(&t->thread,NULL,linuxTimerThread,t);
+  // use real-time scheduling when permitted (root or CAP_SYS_NICE,) otherwise just run at normal priority
+  struct sched_param sp; sp.sched_priority=sched_get_priority_max(SCHED_FIFO)-2+t->priority;
+  pthread_setschedparam(t->thread,SCHED_FIFO,&sp);
+}
+#endif
+
+extern long int siderealInterval;
+extern void SiderealClockSetInterval (long int);
+
+// Init sidereal clock timer
+void HAL_Init_Timer_Sidereal() {
+  SiderealClockSetInterval(siderealInterval);
+  linuxTimerBegin(&itimer1);
+}
+
+// Init Axis1 and Axis2 motor timers and set their priorities
+void HAL_Init_Timers_Motor() {
+  // the motor timers run at the highest priority with the sidereal clock timer below
+  linuxTimerBegin(&itimer3);
+  linuxTimerBegin(&itimer4);
+}
+
+// Init the aux timer to interval (in microseconds*16), for stepping the rotator/focusers
+#define HAL_AUX_TIMER
+void HAL_Init_Timer_Aux(long iv) {
+  itimerAux.isr=TIMER_AUX_vect;
+  itimerAux.period=iv;
+  linuxTimerBegin(&itimerAux);
+}
+
+//--------------------------------------------------------------------------------------------------
+// Set timer1 to interval (in microseconds*16), for the 1/100 second sidereal timer
+
+void Timer1SetInterval(long iv, double rateRatio) {
+  iv=round(((double)iv)/rateRatio);
+  itimer1.period=iv;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Re-program interval for the motor timers
+
+#ifdef HAL_LINUX_SIMULATOR
+extern volatile uint32_t nextAxis1Rate;
+#endif
+
+// prepare to set Axis1/2 hw timers to interval (in microseconds*16), maximum time is about 134 seconds
+void PresetTimerInterval(long iv, float TPSM, volatile uint32_t *nextRate, volatile uint16_t *nextRep) {
+  // 0.262 * 512 = 134.21s
+  uint32_t i=iv; uint16_t t=1; while (iv>65536L*64L) { t++; iv=i/t; if (t==512) { iv=65535L*64L; break; } }
+  cli(); *nextRate=((F_COMP/1000000.0) * (iv*0.0625) * TPSM - 1.0); *nextRep=t; sei();
+#ifdef HAL_LINUX_SIMULATOR
+  simPreset(nextRate == &nextAxis1Rate ? 1 : 2,*nextRate,*nextRep,i);
+#endif
+}
+
+// Must work from within the motor ISR timers, in microseconds*(F_COMP/1000000.0) units
+void QuickSetIntervalAxis1(uint32_t r) {
+  itimer3.period=r+1;
+}
+void QuickSetIntervalAxis2(uint32_t r) {
+  itimer4.period=r+1;
+}
+
+// --------------------------------------------------------------------------------------------------
+// Fast port writing help
+
+#define CLR(x,y) (x&=(~(1<<y)))
+#define SET(x,y) (x|=(1<<y))
+#define TGL(x,y) (x^=(1<<y))
+
+// Pins are simulated by the host build's Arduino shim (a table of pin states,) digitalWrite() is as fast as it gets
+#ifdef HAL_LINUX_SIMULATOR
+  // and in the simulator step/dir edges are also recorded to the trace
+  #define StepPinAxis1_HIGH (digitalWrite(Axis1StepPin, HIGH), simStepPin(1, HIGH))
+  #define StepPinAxis1_LOW (digitalWrite(Axis1StepPin, LOW), simStepPin(1, LOW))
+  #define DirPinAxis1_HIGH (digitalWrite(Axis1DirPin, HIGH), simDirPin(1, HIGH))
+  #define DirPinAxis1_LOW (digitalWrite(Axis1DirPin, LOW), simDirPin(1, LOW))
+
+  #define StepPinAxis2_HIGH (digitalWrite(Axis2StepPin, HIGH), simStepPin(2, HIGH))
+  #define StepPinAxis2_LOW (digitalWrite(Axis2StepPin, LOW), simStepPin(2, LOW))
+  #define DirPinAxis2_HIGH (digitalWrite(Axis2DirPin, HIGH), simDirPin(2, HIGH))
+  #define DirPinAxis2_LOW (digitalWrite(Axis2DirPin, LOW), simDirPin(2, LOW))
+#else
+  #define StepPinAxis1_HIGH digitalWrite(Axis1StepPin, HIGH)
+  #define StepPinAxis1_LOW digitalWrite(Axis1StepPin, LOW)
+  #define DirPinAxis1_HIGH digitalWrite(Axis1DirPin, HIGH)
+  #define DirPinAxis1_LOW digitalWrite(Axis1DirPin, LOW)
+
+  #define StepPinAxis2_HIGH digitalWrite(Axis2StepPin, HIGH)
+  #define StepPinAxis2_LOW digitalWrite(Axis2StepPin, LOW)
+  #define DirPinAxis2_HIGH digitalWrite(Axis2DirPin, HIGH)
+  #define DirPinAxis2_LOW digitalWrite(Axis2DirPin, LOW)
+#endif
@@ -0,0 +1,153 @@
+// -----------------------------------------------------------------------------------
+// Pseudo-terminal communication routines for SerialA, SerialB, SerialC
+
+// Each port shows up as a pty slave, a symlink is made at HAL_LINUX_PTY_PATH[A|B|C] so clients
+// (the SHC, ASCOM driver, INDI, a terminal program, etc.) have a fixed device to open
+// In the simulator there are no ptys, commands come from simSerialInject() (the host build's --send option)
+// and SerialA's replies go to stdout, so a run always sees the same input at the same virtual time
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#ifndef HAL_LINUX_PTY_PATH
+  #define HAL_LINUX_PTY_PATH "/tmp/OnStep-Serial"
+#endif
+
+#ifdef HAL_LINUX_SIMULATOR
+#define SIM_SERIAL_BUFFER 1024
+
+class pserial {
+  public:
+    pserial(char port) { _port=port; }
+
+    void begin(unsigned long baud) { (void)baud; }
+    void end() { }
+
+    // queues characters to be read
+    void inject(const char *s) {
+      while (*s) { int next=(_tail+1)%SIM_SERIAL_BUFFER; if (next == _head) break; _buffer[_tail]=*s++; _tail=next; }
+    }
+
+    int available() { return (_tail-_head+SIM_SERIAL_BUFFER)%SIM_SERIAL_BUFFER; }
+
+    int read() {
+      if (_head == _tail) return -1;
+      int c=(unsigned char)_buffer[_head]; _head=(_head+1)%SIM_SERIAL_BUFFER;
+      return c;
+    }
+
+    size_t write(uint8_t c) { return write(&c,1); }
+
+    size_t write(const uint8_t *data, size_t len) {
+      if (_port == 'A') { fwrite(data,1,len,stdout); fflush(stdout); }
+      return len;
+    }
+
+    void print(const char data[]) { write((const uint8_t*)data,strlen(data)); }
+
+    void println(const char data[]) { print(data); print("\r\n"); }
+
+    void flush() { }
+
+  private:
+    char _port;
+    char _buffer[SIM_SERIAL_BUFFER];
+    int _head = 0;
+    int _tail = 0;
+};
+#else
+class pserial {
+  public:
+    pserial(char port) { _port=port; }
+
+    // the baud rate doesn't matter for a pty
+    void begin(unsigned long baud) {
+      (void)baud;
+      if (_fd >= 0) return;
+
+      _fd=posix_openpt(O_RDWR|O_NOCTTY|O_NONBLOCK);
+      if (_fd < 0) return;
+      grantpt(_fd); unlockpt(_fd);
+
+      // hold the slave open so the master doesn't see EIO/hang-up between client connections
+      const char *slave=ptsname(_fd);
+      _slave_fd=open(slave,O_RDWR|O_NOCTTY);
+      if (_slave_fd >= 0) {
+        struct termios t;
+        tcgetattr(_slave_fd,&t); cfmakeraw(&t); tcsetattr(_slave_fd,TCSANOW,&t);
+      }
+
+      char link[64]; sprintf(link,"%s%c",HAL_LINUX_PTY_PATH,_port);
+      unlink(link); symlink(slave,link);
+      fprintf(stderr,"Serial%c on %s (%s)\n",_port,link,slave);
+    }
+
+    void end() {
+      if (_fd < 0) return;
+      char link[64]; sprintf(link,"%s%c",HAL_LINUX_PTY_PATH,_port);
+      unlink(link);
+      if (_slave_fd >= 0) close(_slave_fd);
+      close(_fd); _fd=-1; _slave_fd=-1;
+    }
+
+    int available() {
+      int n=0;
+      if (_fd < 0) return 0;
+      if (ioctl(_fd,FIONREAD,&n) < 0) return 0;
+      return n;
+    }
+
+    int read() {
+      unsigned char c;
+      if (_fd < 0) return -1;
+      if (::read(_fd,&c,1) != 1) return -1;
+      return c;
+    }
+
+    size_t write(uint8_t c) {
+      if (_fd < 0) return 0;
+      return (::write(_fd,&c,1) == 1);
+    }
+
+    size_t write(const uint8_t *data, size_t len) {
+      if (_fd < 0) return 0;
+      ssize_t r=::write(_fd,data,len);
+      if (r < 0) return 0;
+      return r;
+    }
+
+    void print(const char data[]) {
+      if (_fd < 0) return;
+      ssize_t r=::write(_fd,data,strlen(data)); (void)r;
+    }
+
+    void println(const char data[]) {
+      print(data); print("\r\n");
+    }
+
+    void flush() {
+    }
+
+  private:
+    char _port;
+    int _fd       = -1;
+    int _slave_fd = -1;
+};
+
+#endif
+
+pserial SerialA('A');
+#ifdef HAL_SERIAL_B_ENABLED
+pserial SerialB('B');
+#endif
+#ifdef HAL_SERIAL_C_ENABLED
+pserial SerialC('C');
+#endif
+
+#ifdef HAL_LINUX_SIMULATOR
+void simSerialInject(const char *s) { SerialA.inject(s); }
+#endif
@@ -0,0 +1,90 @@
+// -----------------------------------------------------------------------------------
+// Deterministic step-ISR simulator, virtual 16MHz time (enable with -DHAL_LINUX_SIMULATOR)
+
+// Nothing here runs on its own: the ISR's for Timer1/3/4 are called from simRun() in deadline order
+// as virtual time advances, so a given firmware and command sequence always produces the same trace.
+// The host build's Arduino shim (host/arduino) uses simMicros()/simMillis() for micros()/millis() and
+// simRun() for delay()/delayMicroseconds(), and its main() calls loop() then simRun(n) as desired.
+// host/tools/simtrace.cpp reads the trace and reports step timing jitter and missed steps.
+//
+// Trace file format (little-endian):
+//   header: "OSTR" (4), version (1) = 2, ticks per second (4) = 16000000
+//   record: code (1), dt (2, 4, or 8) ticks since the previous record, then for SIM_PRESET only: nextRate (4),
+//           nextRep (2), and the step interval asked for (4) in ticks
+//   code:   bits 0..1 axis (1 or 2), bits 2..4 event, bits 6..7 the size of dt: 0 for 2 bytes, 2 for 4 bytes, 3 for 8 bytes
+// The trace is closed (and the last records written) when the process exits.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef HAL_LINUX_SIM_TRACE
+  #define HAL_LINUX_SIM_TRACE "OnStep.trace"
+#endif
+
+#define SIM_STEP_LOW  0
+#define SIM_STEP_HIGH 1
+#define SIM_DIR_LOW   2
+#define SIM_DIR_HIGH  3
+#define SIM_PRESET    4
+
+// virtual time in F_COMP counts (1/16 microseconds)
+uint64_t simClock = 0;
+
+unsigned long simMicros() { return (unsigned long)(simClock/16ULL); }
+unsigned long simMillis() { return (unsigned long)(simClock/16000ULL); }
+
+FILE *simTraceFile = NULL;
+uint64_t simTraceLast = 0;
+byte simStepState[3] = {2,2,2};
+byte simDirState[3] = {2,2,2};
+
+void simTraceClose() {
+  if (simTraceFile == NULL) return;
+  fclose(simTraceFile); simTraceFile=NULL;
+}
+
+void simTraceOpen() {
+  if (simTraceFile != NULL) return;
+  simTraceFile=fopen(HAL_LINUX_SIM_TRACE,"wb");
+  if (simTraceFile == NULL) return;
+  uint8_t version=2; uint32_t tps=16000000UL;
+  fwrite("OSTR",1,4,simTraceFile); fwrite(&version,1,1,simTraceFile); fwrite(&tps,4,1,simTraceFile);
+  simTraceLast=simClock;
+  atexit(simTraceClose);
+}
+
+void simTraceRecord(byte event, byte axis) {
+  if (simTraceFile == NULL) return;
+  uint64_t dt=simClock-simTraceLast; simTraceLast=simClock;
+  uint8_t code=(event<<2)|(axis&3);
+  if (dt > 0xFFFFFFFFULL) {
+    code|=0xC0;
+    fwrite(&code,1,1,simTraceFile); fwrite(&dt,8,1,simTraceFile);
+  } else
+  if (dt > 0xFFFF) {
+    code|=0x80; uint32_t d=dt;
+    fwrite(&code,1,1,simTraceFile); fwrite(&d,4,1,simTraceFile);
+  } else {
+    uint16_t d=dt;
+    fwrite(&code,1,1,simTraceFile); fwrite(&d,2,1,simTraceFile);
+  }
+}
+
+// only level changes are recorded, the ISR's write the step pin LOW on every pass for example
+void simStepPin(byte axis, byte state) {
+  if (simStepState[axis] == state) return;
+  simStepState[axis]=state;
+  simTraceRecord(state?SIM_STEP_HIGH:SIM_STEP_LOW,axis);
+}
+
+void simDirPin(byte axis, byte state) {
+  if (simDirState[axis] == state) return;
+  simDirState[axis]=state;
+  simTraceRecord(state?SIM_DIR_HIGH:SIM_DIR_LOW,axis);
+}
+
+void simPreset(byte axis, uint32_t nextRate, uint16_t nextRep, uint32_t interval) {
+  if (simTraceFile == NULL) return;
+  simTraceRecord(SIM_PRESET,axis);
+  fwrite(&nextRate,4,1,simTraceFile); fwrite(&nextRep,2,1,simTraceFile); fwrite(&interval,4,1,simTraceFile);
+}
@@ -28,9 +28,6 @@
     #define HAL_SERIAL_C_SERIAL2     // Use RX2/TX2 for channel C (defaults to RX3/TX3 otherwise.)
   #endif
 
-  // this tells OnStep that a .transmit() method needs to be called to send data
-  #define HAL_SERIAL_TRANSMIT
-
   // Use low overhead serial
   #include "HAL_Serial.h"
 #else
@@ -1,14 +1,17 @@
 // -----------------------------------------------------------------------------------
 // Low overhead communication routines for Serial0, Serial1
 
+// replies are queued here and sent by the UDRE interrupt, must be a power of 2 up to 128
+#define HAL_SERIAL_TX_BUFFER_SIZE 128
+
 class pserial {
   public:
     // these are more compact and faster than the Arduino provided one's
     void begin(unsigned long baud) {
       unsigned int ubrr=F_CPU/16/baud-1;
     
-      _xmit_index=0;
-      _xmit_buffer[0]=0;
+      _xmit_head=0;
+      _xmit_tail=0;
       _recv_head =0;
       _recv_tail =0;
       _recv_buffer[0]=0;
@@ -47,29 +50,49 @@ class pserial {
 
     void print(const char data[])
     {
-      strcpy(_xmit_buffer,data);
-      _xmit_index=0;
+      write((const uint8_t*)data,strlen(data));
     }
 
-    // Main loop calls this to send characters on their way without interrupts
+    // queues the data for the UDRE interrupt to send, waits only if the buffer is full
+    // binary replies may contain (char)0 so these are sent by length
+    void write(const uint8_t data[], size_t len)
+    {
+      for (size_t i=0; i < len; i++) {
+        byte h=(_xmit_head+1)&(HAL_SERIAL_TX_BUFFER_SIZE-1);
+        while (h == _xmit_tail) xmitPoll();
+        _xmit_buffer[_xmit_head]=data[i];
+        _xmit_head=h;
+        UCSR0B |= (1<<UDRIE0);
+      }
+    }
+
+    // true while there is data waiting to be sent
     boolean transmit()
     {
-      if (_xmit_buffer[_xmit_index]==(char)0) return false;
-      if ( ( UCSR0A & (1<<UDRE0)) ) { UDR0 = _xmit_buffer[_xmit_index]; _xmit_index++; }
-      return true;
+      return _xmit_head != _xmit_tail;
     }
 
     void flush()
     {
-      while (transmit()) {};
+      while (transmit()) xmitPoll();
+    }
+
+    // with interrupts off (in an ISR or a cli() section) the UDRE interrupt can't empty the buffer, send from here instead
+    void xmitPoll()
+    {
+      if (!(SREG & _BV(SREG_I)) && (UCSR0A & (1<<UDRE0))) {
+        UDR0=_xmit_buffer[_xmit_tail];
+        _xmit_tail=(_xmit_tail+1)&(HAL_SERIAL_TX_BUFFER_SIZE-1);
+      }
     }
     
     volatile char _recv_buffer[256]   = "";
     volatile byte _recv_tail = 0;
+    volatile char _xmit_buffer[HAL_SERIAL_TX_BUFFER_SIZE] = "";
+    volatile byte _xmit_head = 0;
+    volatile byte _xmit_tail = 0;
   private:
     byte _recv_head          = 0;
-    char _xmit_buffer[50]    = "";
-    byte _xmit_index         = 0;
 };
 
 pserial SerialA;
@@ -80,14 +103,22 @@ ISR(USART0_RX_vect)  {
   SerialA._recv_tail++; // buffer is 256 bytes so this byte variable wraps automatically
 }
 
+// UART Data Register Empty Interrupt Handler for Serial0
+ISR(USART0_UDRE_vect)  {
+  if (SerialA._xmit_head != SerialA._xmit_tail) {
+    UDR0=SerialA._xmit_buffer[SerialA._xmit_tail];
+    SerialA._xmit_tail=(SerialA._xmit_tail+1)&(HAL_SERIAL_TX_BUFFER_SIZE-1);
+  } else UCSR0B &= ~(1<<UDRIE0); // nothing left to send
+}
+
 #ifdef HAL_SERIAL_B_ENABLED
 class pserial1 {
   public:
     void begin(unsigned long baud) {
       unsigned int ubrr=F_CPU/16/baud-1;
     
-      _xmit_index=0;
-      _xmit_buffer[0]=0;
+      _xmit_head=0;
+      _xmit_tail=0;
       _recv_head =0;
       _recv_tail =0;
       _recv_buffer[0]=0;
@@ -126,28 +157,49 @@ class pserial1 {
 
     void print(const char data[])
     {
-      strcpy(_xmit_buffer,data);
-      _xmit_index=0;
+      write((const uint8_t*)data,strlen(data));
     }
 
+    // queues the data for the UDRE interrupt to send, waits only if the buffer is full
+    // binary replies may contain (char)0 so these are sent by length
+    void write(const uint8_t data[], size_t len)
+    {
+      for (size_t i=0; i < len; i++) {
+        byte h=(_xmit_head+1)&(HAL_SERIAL_TX_BUFFER_SIZE-1);
+        while (h == _xmit_tail) xmitPoll();
+        _xmit_buffer[_xmit_head]=data[i];
+        _xmit_head=h;
+        UCSR1B |= (1<<UDRIE1);
+      }
+    }
+
+    // true while there is data waiting to be sent
     boolean transmit()
     {
-      if (_xmit_buffer[_xmit_index]==(char)0) return false;
-      if ( ( UCSR1A & (1<<UDRE1)) ) { UDR1 = _xmit_buffer[_xmit_index]; _xmit_index++; }
-      return true;
+      return _xmit_head != _xmit_tail;
     }
 
     void flush()
     {
-      while (transmit()) {};
+      while (transmit()) xmitPoll();
+    }
+
+    // with interrupts off (in an ISR or a cli() section) the UDRE interrupt can't empty the buffer, send from here instead
+    void xmitPoll()
+    {
+      if (!(SREG & _BV(SREG_I)) && (UCSR1A & (1<<UDRE1))) {
+        UDR1=_xmit_buffer[_xmit_tail];
+        _xmit_tail=(_xmit_tail+1)&(HAL_SERIAL_TX_BUFFER_SIZE-1);
+      }
     }
 
     volatile char _recv_buffer[256]   = "";
     volatile byte _recv_tail = 0;
+    volatile char _xmit_buffer[HAL_SERIAL_TX_BUFFER_SIZE] = "";
+    volatile byte _xmit_head = 0;
+    volatile byte _xmit_tail = 0;
   private:
     byte _recv_head          = 0;
-    char _xmit_buffer[50]    = "";
-    byte _xmit_index         = 0;
 };
 
 pserial1 SerialB;
@@ -157,6 +209,14 @@ ISR(USART1_RX_vect)  {
   SerialB._recv_buffer[SerialB._recv_tail]=UDR1; 
   SerialB._recv_tail++; // buffer is 256 bytes so this byte variable wraps automatically
 }
+
+// UART Data Register Empty Interrupt Handler for Serial1
+ISR(USART1_UDRE_vect)  {
+  if (SerialB._xmit_head != SerialB._xmit_tail) {
+    UDR1=SerialB._xmit_buffer[SerialB._xmit_tail];
+    SerialB._xmit_tail=(SerialB._xmit_tail+1)&(HAL_SERIAL_TX_BUFFER_SIZE-1);
+  } else UCSR1B &= ~(1<<UDRIE1); // nothing left to send
+}
 #endif
 
 #ifdef HAL_SERIAL_C_ENABLED
@@ -166,8 +226,8 @@ class pserial2 {
     void begin(unsigned long baud) {
       unsigned int ubrr=F_CPU/16/baud-1;
     
-      _xmit_index=0;
-      _xmit_buffer[0]=0;
+      _xmit_head=0;
+      _xmit_tail=0;
       _recv_head =0;
       _recv_tail =0;
       _recv_buffer[0]=0;
@@ -206,28 +266,49 @@ class pserial2 {
 
     void print(const char data[])
     {
-      strcpy(_xmit_buffer,data);
-      _xmit_index=0;
+      write((const uint8_t*)data,strlen(data));
     }
 
+    // queues the data for the UDRE interrupt to send, waits only if the buffer is full
+    // binary replies may contain (char)0 so these are sent by length
+    void write(const uint8_t data[], size_t len)
+    {
+      for (size_t i=0; i < len; i++) {
+        byte h=(_xmit_head+1)&(HAL_SERIAL_TX_BUFFER_SIZE-1);
+        while (h == _xmit_tail) xmitPoll();
+        _xmit_buffer[_xmit_head]=data[i];
+        _xmit_head=h;
+        UCSR2B |= (1<<UDRIE2);
+      }
+    }
+
+    // true while there is data waiting to be sent
     boolean transmit()
     {
-      if (_xmit_buffer[_xmit_index]==(char)0) return false;
-      if ( ( UCSR2A & (1<<UDRE2)) ) { UDR2 = _xmit_buffer[_xmit_index]; _xmit_index++; }
-      return true;
+      return _xmit_head != _xmit_tail;
     }
 
     void flush()
     {
-      while (transmit()) {};
+      while (transmit()) xmitPoll();
+    }
+
+    // with interrupts off (in an ISR or a cli() section) the UDRE interrupt can't empty the buffer, send from here instead
+    void xmitPoll()
+    {
+      if (!(SREG & _BV(SREG_I)) && (UCSR2A & (1<<UDRE2))) {
+        UDR2=_xmit_buffer[_xmit_tail];
+        _xmit_tail=(_xmit_tail+1)&(HAL_SERIAL_TX_BUFFER_SIZE-1);
+      }
     }
 
     volatile char _recv_buffer[256]   = "";
     volatile byte _recv_tail = 0;
+    volatile char _xmit_buffer[HAL_SERIAL_TX_BUFFER_SIZE] = "";
+    volatile byte _xmit_head = 0;
+    volatile byte _xmit_tail = 0;
   private:
     byte _recv_head          = 0;
-    char _xmit_buffer[50]    = "";
-    byte _xmit_index         = 0;
 };
 
 pserial2 SerialC;
@@ -238,6 +319,14 @@ ISR(USART2_RX_vect)  {
   SerialC._recv_tail++; // buffer is 256 bytes so this byte variable wraps automatically
 }
 
+// UART Data Register Empty Interrupt Handler for Serial2
+ISR(USART2_UDRE_vect)  {
+  if (SerialC._xmit_head != SerialC._xmit_tail) {
+    UDR2=SerialC._xmit_buffer[SerialC._xmit_tail];
+    SerialC._xmit_tail=(SerialC._xmit_tail+1)&(HAL_SERIAL_TX_BUFFER_SIZE-1);
+  } else UCSR2B &= ~(1<<UDRIE2); // nothing left to send
+}
+
 #else
 
 class pserial3 {
@@ -245,8 +334,8 @@ class pserial3 {
     void begin(unsigned long baud) {
       unsigned int ubrr=F_CPU/16/baud-1;
     
-      _xmit_index=0;
-      _xmit_buffer[0]=0;
+      _xmit_head=0;
+      _xmit_tail=0;
       _recv_head =0;
       _recv_tail =0;
       _recv_buffer[0]=0;
@@ -285,28 +374,49 @@ class pserial3 {
 
     void print(const char data[])
     {
-      strcpy(_xmit_buffer,data);
-      _xmit_index=0;
+      write((const uint8_t*)data,strlen(data));
     }
 
+    // queues the data for the UDRE interrupt to send, waits only if the buffer is full
+    // binary replies may contain (char)0 so these are sent by length
+    void write(const uint8_t data[], size_t len)
+    {
+      for (size_t i=0; i < len; i++) {
+        byte h=(_xmit_head+1)&(HAL_SERIAL_TX_BUFFER_SIZE-1);
+        while (h == _xmit_tail) xmitPoll();
+        _xmit_buffer[_xmit_head]=data[i];
+        _xmit_head=h;
+        UCSR3B |= (1<<UDRIE3);
+      }
+    }
+
+    // true while there is data waiting to be sent
     boolean transmit()
     {
-      if (_xmit_buffer[_xmit_index]==(char)0) return false;
-      if ( ( UCSR3A & (1<<UDRE3)) ) { UDR3 = _xmit_buffer[_xmit_index]; _xmit_index++; }
-      return true;
+      return _xmit_head != _xmit_tail;
     }
 
     void flush()
     {
-      while (transmit()) {};
+      while (transmit()) xmitPoll();
+    }
+
+    // with interrupts off (in an ISR or a cli() section) the UDRE interrupt can't empty the buffer, send from here instead
+    void xmitPoll()
+    {
+      if (!(SREG & _BV(SREG_I)) && (UCSR3A & (1<<UDRE3))) {
+        UDR3=_xmit_buffer[_xmit_tail];
+        _xmit_tail=(_xmit_tail+1)&(HAL_SERIAL_TX_BUFFER_SIZE-1);
+      }
     }
 
     volatile char _recv_buffer[256]   = "";
     volatile byte _recv_tail = 0;
+    volatile char _xmit_buffer[HAL_SERIAL_TX_BUFFER_SIZE] = "";
+    volatile byte _xmit_head = 0;
+    volatile byte _xmit_tail = 0;
   private:
     byte _recv_head          = 0;
-    char _xmit_buffer[50]    = "";
-    byte _xmit_index         = 0;
 };
 
 pserial3 SerialC;
@@ -316,6 +426,14 @@ ISR(USART3_RX_vect)  {
   SerialC._recv_buffer[SerialC._recv_tail]=UDR3; 
   SerialC._recv_tail++; // buffer is 256 bytes so this byte variable wraps automatically
 }
+
+// UART Data Register Empty Interrupt Handler for Serial3
+ISR(USART3_UDRE_vect)  {
+  if (SerialC._xmit_head != SerialC._xmit_tail) {
+    UDR3=SerialC._xmit_buffer[SerialC._xmit_tail];
+    SerialC._xmit_tail=(SerialC._xmit_tail+1)&(HAL_SERIAL_TX_BUFFER_SIZE-1);
+  } else UCSR3B &= ~(1<<UDRIE3); // nothing left to send
+}
 #endif
 #endif
 
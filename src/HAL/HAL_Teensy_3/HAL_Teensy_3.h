@@ -118,6 +118,19 @@ void HAL_Init_Timers_Motor() {
   NVIC_SET_PRIORITY(IRQ_PIT_CH2, 0);
 }
 
+// Init the aux timer (the last PIT channel) to interval (in microseconds*16), for stepping the rotator/focusers
+// tone() needs a PIT channel too so there's none left for the buzzer
+#define HAL_AUX_TIMER
+#define HAL_AUX_TIMER_PIT
+IntervalTimer itimerAux;
+void TIMER_AUX_vect(void);
+
+void HAL_Init_Timer_Aux(long iv) {
+  itimerAux.begin(TIMER_AUX_vect, (float)iv * 0.0625);
+  // below the sidereal clock timer
+  itimerAux.priority(64);
+}
+
 //--------------------------------------------------------------------------------------------------
 // Set timer1 to interval (in microseconds*16), for the 1/100 second sidereal timer
 
@@ -77,6 +77,20 @@ void HAL_Init_Timers_Motor() {
   itimer4.priority(0);
 }
 
+// Init the aux timer (the last PIT channel) to interval (in microseconds*16), for stepping the rotator/focusers
+// tone() needs a PIT channel too so there's none left for the buzzer
+#define HAL_AUX_TIMER
+#define HAL_AUX_TIMER_PIT
+static IntervalTimer itimerAux;
+void TIMER_AUX_vect(void);
+
+void HAL_Init_Timer_Aux(long iv) {
+  if (!itimerAux.begin(TIMER_AUX_vect, (float)iv * 0.0625)) Serial.println("Error assigning aux timer");
+  // all four PIT channels share IRQ_PIT and it runs at the highest priority asked for (0, the motor timers,) so the
+  // rotator/focuser steps run in the same handler as the motor timers and add a little jitter to them
+  itimerAux.priority(64);
+}
+
 //--------------------------------------------------------------------------------------------------
 // Set timer1 to interval (in microseconds*16), for the 1/100 second sidereal timer
 
@@ -0,0 +1,191 @@
+// -----------------------------------------------------------------------------------
+// Queued I2C transactions, shared by the NV, RTC and weather drivers
+
+// A transaction writes up to I2C_BUFFER_SIZE bytes then optionally reads (after a repeated start) into the same buffer.
+// They're queued and run one at a time in the background, poll() moves the bus along and calls each one's callback (from
+// the main loop, never an ISR) when it's done.  A device that NAKs its address is retried for up to I2C_RETRY_MS, that's
+// how an EEPROM's write cycle gets waited out without holding anything up.
+//
+// Mega2560: the TWI hardware is stepped one bus event per poll(), Wire keeps TWI_vect for the libraries that use it in setup()
+// Linux:    transactions go to the bus model in HAL_I2C_Mock.h
+// others:   a transaction is done with HAL_Wire in one poll(), which blocks for as long as it's on the bus (a 34 byte
+//           EEPROM page write is about 3.4ms at 100kHz) so only the EEPROM's write cycle is waited out in the background
+
+#pragma once
+#define HAL_I2C_ASYNC
+
+#if defined(__AVR_ATmega2560__)
+  #include <util/twi.h>
+#elif !defined(__HAL_LINUX__)
+  #include <Wire.h>
+#endif
+
+#define I2C_QUEUE_SIZE   4
+#define I2C_BUFFER_SIZE  34   // a 32 byte EEPROM page and its two address bytes
+#define I2C_RETRY_MS     20   // longer than an EEPROM write cycle
+#define I2C_TIMEOUT_MS   50   // the bus is reset if a transaction takes longer than this
+
+#define I2C_PENDING 0
+#define I2C_OK      1
+#define I2C_NAK     2         // the device didn't answer within I2C_RETRY_MS
+#define I2C_ERROR   3
+
+typedef void (*i2cCallback)(byte status, byte *data, byte count, void *context);
+
+typedef struct {
+  byte address;
+  byte txCount;
+  byte rxCount;
+  byte data[I2C_BUFFER_SIZE];   // bytes to write, then the bytes read
+  byte status;
+  i2cCallback callback;
+  void *context;
+} i2cTransaction_t;
+
+class i2cEngine {
+  public:
+    // queues a transaction, returns false if the queue is full
+    bool queue(byte address, const byte *tx, byte txCount, byte rxCount, i2cCallback callback, void *context) {
+      if ((txCount > I2C_BUFFER_SIZE) || (rxCount > I2C_BUFFER_SIZE)) return false;
+      byte next=(tail+1)%I2C_QUEUE_SIZE; if (next == head) return false;
+      i2cTransaction_t *t=&q[tail];
+      t->address=address; t->txCount=txCount; t->rxCount=rxCount;
+      if (txCount > 0) memcpy(t->data,tx,txCount);
+      t->status=I2C_PENDING; t->callback=callback; t->context=context;
+      tail=next;
+      return true;
+    }
+
+    // true if nothing is queued or in progress
+    bool idle() { return head == tail; }
+
+    // waits for the queue to empty then does a transaction, only for setup() and reads the caller can't continue without
+    byte transfer(byte address, const byte *tx, byte txCount, byte *rx, byte rxCount) {
+      while (!queue(address,tx,txCount,rxCount,NULL,NULL)) { poll(); wait(); }
+      byte s=(tail+I2C_QUEUE_SIZE-1)%I2C_QUEUE_SIZE;
+      while (head != s) { poll(); wait(); }
+      while (q[s].status == I2C_PENDING) { step(&q[s]); wait(); }
+      byte status=q[s].status;
+      if ((status == I2C_OK) && (rxCount > 0)) memcpy(rx,q[s].data,rxCount);
+      next();
+      return status;
+    }
+
+    void poll() {
+      if (head == tail) return;
+      i2cTransaction_t *t=&q[head];
+      if (t->status == I2C_PENDING) { step(t); if (t->status == I2C_PENDING) return; }
+      if (t->callback != NULL) t->callback(t->status,t->data,t->rxCount,t->context);
+      next();
+    }
+
+  private:
+    i2cTransaction_t q[I2C_QUEUE_SIZE];
+    byte head=0, tail=0;
+    bool active=false;                  // the transaction at the head has been started
+    unsigned long startMs=0;
+
+    void next() { active=false; head=(head+1)%I2C_QUEUE_SIZE; }
+
+    // the device NAK'd its address, try again later unless it's been too long
+    void retry(i2cTransaction_t *t) {
+      if ((long)(millis()-startMs) >= I2C_RETRY_MS) t->status=I2C_NAK;
+    }
+
+#if defined(__AVR_ATmega2560__)
+    bool reading=false;
+    bool started=false;                 // a START is out on the bus
+    byte pos=0;
+
+    void wait() { }
+
+    void stop(i2cTransaction_t *t, byte status) {
+      TWCR=_BV(TWINT)|_BV(TWEN)|_BV(TWSTO);
+      started=false;
+      if (status == I2C_NAK) retry(t); else t->status=status;
+    }
+
+    void ack(bool more) { TWCR=_BV(TWINT)|_BV(TWEN)|(more?_BV(TWEA):0); }
+
+    // handles at most one bus event, the TWI interrupt stays disabled
+    void step(i2cTransaction_t *t) {
+      if (!active) { active=true; startMs=millis(); }
+      if (!started) {
+        if (TWCR & _BV(TWSTO)) return;  // the last STOP is still going out
+        pos=0; started=true;
+        TWCR=_BV(TWINT)|_BV(TWSTA)|_BV(TWEN);
+        return;
+      }
+      if (!(TWCR & _BV(TWINT))) {
+        if ((long)(millis()-startMs) > I2C_TIMEOUT_MS) { TWCR=0; TWCR=_BV(TWEN); started=false; t->status=I2C_ERROR; }
+        return;
+      }
+      switch (TW_STATUS) {
+        case TW_START:
+          reading=(t->txCount == 0);
+          // fall through
+        case TW_REP_START:
+          TWDR=(t->address<<1)|(reading?TW_READ:TW_WRITE);
+          TWCR=_BV(TWINT)|_BV(TWEN);
+        break;
+        case TW_MT_SLA_ACK: case TW_MT_DATA_ACK:
+          if (pos < t->txCount) { TWDR=t->data[pos++]; TWCR=_BV(TWINT)|_BV(TWEN); } else
+          if (t->rxCount > 0) { reading=true; pos=0; TWCR=_BV(TWINT)|_BV(TWSTA)|_BV(TWEN); } else stop(t,I2C_OK);
+        break;
+        case TW_MR_SLA_ACK: ack(t->rxCount > 1); break;
+        case TW_MR_DATA_ACK: t->data[pos++]=TWDR; ack(pos < t->rxCount-1); break;
+        case TW_MR_DATA_NACK: t->data[pos++]=TWDR; stop(t,I2C_OK); break;
+        case TW_MT_SLA_NACK: case TW_MR_SLA_NACK: stop(t,I2C_NAK); break;
+        default: stop(t,I2C_ERROR); break; // data NAK'd, arbitration lost, or bus error
+      }
+    }
+
+#elif defined(__HAL_LINUX__)
+    unsigned long doneMicros=0;
+    byte result=0;
+
+    // lets time pass (virtual time too, in the simulator) while transfer() waits
+    void wait() { delayMicroseconds(10); }
+
+    // the bus model does the transaction at once and says how long it would have taken
+    void step(i2cTransaction_t *t) {
+      if (!active) { active=true; startMs=millis(); doneMicros=0; }
+      if (doneMicros == 0) {
+        unsigned long us;
+        result=i2cMock.transfer(t->address,t->data,t->txCount,t->rxCount,&us);
+        doneMicros=micros()+us; if (doneMicros == 0) doneMicros=1;
+        return;
+      }
+      if ((long)(micros()-doneMicros) < 0) return;
+      doneMicros=0;
+      if (result == 0) t->status=I2C_OK; else if (result == 2) retry(t); else t->status=I2C_ERROR;
+    }
+
+#else
+    void wait() { }
+
+    // a whole transaction at once, Wire doesn't offer anything finer grained
+    void step(i2cTransaction_t *t) {
+      if (!active) { active=true; startMs=millis(); }
+  #if defined(ESP32) & defined(WIRE_END_SUPPORT)
+      HAL_Wire.begin();
+  #endif
+      byte e=0;
+      if (t->txCount > 0) {
+        HAL_Wire.beginTransmission(t->address);
+        HAL_Wire.write(t->data,t->txCount);
+        e=HAL_Wire.endTransmission();
+      }
+      if ((e == 0) && (t->rxCount > 0)) {
+        byte n=HAL_Wire.requestFrom(t->address,t->rxCount);
+        if (n == 0) e=2; else for (byte j=0; j < t->rxCount; j++) t->data[j]=HAL_Wire.available()?HAL_Wire.read():0;
+      }
+  #if defined(ESP32) & defined(WIRE_END_SUPPORT)
+      HAL_Wire.end();
+  #endif
+      if (e == 0) t->status=I2C_OK; else if (e == 2) retry(t); else t->status=I2C_ERROR;
+    }
+#endif
+};
+
+i2cEngine i2cBus;
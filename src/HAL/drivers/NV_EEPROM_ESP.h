@@ -6,6 +6,9 @@
 #define EEPROM_SIZE 2048
 #define E2END 2048
 
+// writes only go to RAM until the commit, so large blocks are fine
+#define NV_BLOCK_SIZE 64
+
 #include "EEPROM.h"
 #include "Arduino.h"
 
@@ -114,6 +117,11 @@ class nvs {
     void readBytes(uint16_t i, byte *v, uint8_t count) {
       for (int j=0; j < count; j++) { *v = read(i + j); v++; }
     }
+
+    // write count bytes to EEPROM starting at position i
+    void writeBytes(int i, byte *v, byte count) {
+      for (int j=0; j < count; j++) { update(i + j, *v); v++; }
+    }
   private:
     unsigned long _lastWrite;
     bool _dirtyPool=false;
@@ -5,6 +5,9 @@
 
 #include "EEPROM_TIVA.h"
 
+// each byte can take a full EEPROM write cycle, so only one at a time when writing in the background
+#define NV_BLOCK_SIZE 1
+
 class nvs {
   public:
     void init() {
@@ -99,6 +102,11 @@ class nvs {
     void readBytes(int i, byte *v, byte count) {
       for (int j=0; j < count; j++) { *v = read(i + j); v++; }
     }
+
+    // write count bytes to EEPROM starting at position i
+    void writeBytes(int i, byte *v, byte count) {
+      for (int j=0; j < count; j++) { update(i + j, *v); v++; }
+    }
 };
 
 nvs nv;
@@ -0,0 +1,144 @@
+// -----------------------------------------------------------------------------------
+// non-volatile storage (file backed EEPROM image, for host builds)
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+
+// the image is the same size as an AT24C32 so EEPROM addresses/layout match the common NV option
+#define E2END 4095
+
+// writes only go to the RAM image until it's saved, so large blocks are fine
+#define NV_BLOCK_SIZE 64
+
+#ifndef NV_FILE_NAME
+  #define NV_FILE_NAME "OnStep.nv"
+#endif
+
+class nvs {
+  public:
+    // loads the image, a missing or short file reads as erased (0xff) EEPROM
+    void init() {
+      memset(_image,0xff,E2END+1);
+      FILE *f=fopen(NV_FILE_NAME,"rb");
+      if (f != NULL) { size_t r=fread(_image,1,E2END+1,f); (void)r; fclose(f); }
+      _dirty=false;
+    }
+
+    // writes the image back to the file at most once a second
+    void poll() {
+      if (_dirty && ((long)(millis()-_lastWrite) > 1000)) {
+        FILE *f=fopen(NV_FILE_NAME,"wb");
+        if (f != NULL) { fwrite(_image,1,E2END+1,f); fclose(f); _dirty=false; }
+        _lastWrite=millis();
+      }
+    }
+
+    byte read(int i) {
+      if ((i < 0) || (i > E2END)) return 0;
+      return _image[i];
+    }
+
+    void update(int i, byte j) {
+      if ((i < 0) || (i > E2END)) return;
+      if (_image[i] != j) {
+        _image[i]=j;
+        if (!_dirty) _lastWrite=millis();
+        _dirty=true;
+      }
+    }
+
+    void write(int i, byte j) {
+      update(i, j);
+    }
+
+    // write int numbers into EEPROM at position i (2 bytes)
+    void writeInt(int i, int j) {
+      uint8_t *k = (uint8_t*)&j;
+      update(i + 0, *k); k++;
+      update(i + 1, *k);
+    }
+
+    // read int numbers from EEPROM at position i (2 bytes)
+    int readInt(int i) {
+      uint16_t j;
+      uint8_t *k = (uint8_t*)&j;
+      *k = read(i + 0); k++;
+      *k = read(i + 1);
+      return j;
+    }
+
+    // write 4 byte variable into EEPROM at position i (4 bytes)
+    void writeQuad(int i, byte *v) {
+      update(i + 0, *v); v++;
+      update(i + 1, *v); v++;
+      update(i + 2, *v); v++;
+      update(i + 3, *v);
+    }
+
+    // read 4 byte variable from EEPROM at position i (4 bytes)
+    void readQuad(int i, byte *v) {
+      *v = read(i + 0); v++;
+      *v = read(i + 1); v++;
+      *v = read(i + 2); v++;
+      *v = read(i + 3);
+    }
+
+    // write String into EEPROM at position i (16 bytes)
+    void writeString(int i, char l[]) {
+      for (int l1 = 0; l1 < 16; l1++) {
+        update(i + l1, *l); l++;
+      }
+    }
+
+    // read String from EEPROM at position i (16 bytes)
+    void readString(int i, char l[]) {
+      for (int l1 = 0; l1 < 16; l1++) {
+        *l = read(i + l1); l++;
+      }
+    }
+
+    // write 4 byte float into EEPROM at position i (4 bytes)
+    void writeFloat(int i, float f) {
+      writeQuad(i, (byte*)&f);
+    }
+
+    // read 4 byte float from EEPROM at position i (4 bytes)
+    float readFloat(int i) {
+      float f;
+      readQuad(i, (byte*)&f);
+      return f;
+    }
+
+    // write 4 byte long into EEPROM at position i (4 bytes)
+    // long is 8 bytes on a 64 bit host, only the low 4 bytes are stored as on the MCU's
+    void writeLong(int i, long l) {
+      int32_t l32=l;
+      writeQuad(i, (byte*)&l32);
+    }
+
+    // read 4 byte long from EEPROM at position i (4 bytes)
+    long readLong(int i) {
+      int32_t l32;
+      readQuad(i, (byte*)&l32);
+      return l32;
+    }
+
+    // read count bytes from EEPROM starting at position i
+    void readBytes(uint16_t i, byte *v, uint8_t count) {
+      for (int j=0; j < count; j++) { *v = read(i + j); v++; }
+    }
+
+    // write count bytes to EEPROM starting at position i
+    void writeBytes(int i, byte *v, byte count) {
+      for (int j=0; j < count; j++) { update(i + j, *v); v++; }
+    }
+
+  private:
+    byte _image[E2END+1];
+    bool _dirty = false;
+    unsigned long _lastWrite = 0;
+};
+
+nvs nv;
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <Wire.h>
+#include "I2C_Async.h"
 
 // I2C EEPROM Address on DS3231 RTC module
 #define I2C_EEPROM_ADDRESS 0x57
@@ -13,6 +14,24 @@
 #define MSB(i) (i >> 8)
 #define LSB(i) (i & 0xFF)
 
+// the EEPROM writes up to a 32 byte page at once, where transactions go through Wire its buffer also has to hold the
+// two address bytes (the Mega2560 and Linux I2C_Async engines have their own buffer)
+#define I2C_EEPROM_PAGE 32
+#if defined(BUFFER_LENGTH) && BUFFER_LENGTH < I2C_EEPROM_PAGE+2 && !defined(__AVR_ATmega2560__) && !defined(__HAL_LINUX__)
+  #define I2C_EEPROM_WRITE_MAX (BUFFER_LENGTH-2)
+  #define I2C_EEPROM_READ_MAX BUFFER_LENGTH
+#else
+  #define I2C_EEPROM_WRITE_MAX I2C_EEPROM_PAGE
+  #define I2C_EEPROM_READ_MAX I2C_EEPROM_PAGE
+#endif
+
+// background writers (pecSavePoll) write NV_BLOCK_SIZE aligned blocks, a page or half a page so a block is one page write
+#if I2C_EEPROM_WRITE_MAX < I2C_EEPROM_PAGE
+  #define NV_BLOCK_SIZE (I2C_EEPROM_PAGE/2)
+#else
+  #define NV_BLOCK_SIZE I2C_EEPROM_PAGE
+#endif
+
 class nvs {
   public:    
     void init() {
@@ -31,9 +50,7 @@ class nvs {
     }
 
     void update(int i, byte j) {
-      uint8_t k;
-      ee_read(i,&k,1);
-      if (j != k) ee_write(i,j);
+      ee_update(i,&j,1);
     }
 
     void write(int i, byte j) {
@@ -42,9 +59,7 @@ class nvs {
 
     // write int numbers into EEPROM at position i (2 uint8_ts)
     void writeInt(int i, int j) {
-      uint8_t *k = (uint8_t*)&j;
-      update(i+0,*k); k++;
-      update(i+1,*k);
+      ee_update(i,(uint8_t*)&j,2);
     }
     
     // read int numbers from EEPROM at position i (2 uint8_ts)
@@ -80,10 +95,7 @@ class nvs {
 
     // write 4 uint8_t variable into EEPROM at position i (4 uint8_ts)
     void writeQuad(int i, byte *v) {
-      update(i+0,*v); v++;
-      update(i+1,*v); v++;
-      update(i+2,*v); v++;
-      update(i+3,*v);
+      ee_update(i,v,4);
     }
     
     // read 4 uint8_t variable from EEPROM at position i (4 uint8_ts)
@@ -93,10 +105,7 @@ class nvs {
 
     // write String into EEPROM at position i (16 bytes)
     void writeString(int i, char l[]) {
-      int l1;
-      for (l1=0; l1 < 16; l1++) {
-        update(i+l1,*l); l++;
-      }
+      ee_update(i,(byte*)l,16);
     }
     
     // read String from EEPROM at position i (16 bytes)
@@ -109,33 +118,45 @@ class nvs {
       ee_read(i,v,count);
     }
 
+    // write count bytes to EEPROM starting at position i, queued as they are without reading back what's stored so
+    // the caller never waits on a write cycle (it should wait for i2cBus.idle() between blocks)
+    void writeBytes(int i, byte *v, byte count) {
+      while (count > 0) {
+        byte n=I2C_EEPROM_PAGE-(i%I2C_EEPROM_PAGE); if (n > I2C_EEPROM_WRITE_MAX) n=I2C_EEPROM_WRITE_MAX; if (n > count) n=count;
+        ee_write(i,v,n);
+        i+=n; v+=n; count-=n;
+      }
+    }
+
 private:
   // Address of the I2C EEPROM
   uint8_t _eeprom_addr;
-  uint32_t nextOpMs=millis()+10UL;
 
-  void ee_write(int offset, byte data) {
-    while ((int32_t)(millis()-nextOpMs) < 0) {}
+  // writes only the pages (or parts of pages) where the data differs from what's stored
+  void ee_update(int offset, byte *data, byte count) {
+    byte old[I2C_EEPROM_PAGE];
+    while (count > 0) {
+      byte n=I2C_EEPROM_PAGE-(offset%I2C_EEPROM_PAGE); if (n > I2C_EEPROM_WRITE_MAX) n=I2C_EEPROM_WRITE_MAX; if (n > count) n=count;
+      ee_read(offset,old,n);
+      if (memcmp(old,data,n) != 0) ee_write(offset,data,n);
+      offset+=n; data+=n; count-=n;
+    }
+  }
 
-    HAL_Wire.beginTransmission(_eeprom_addr);
-    HAL_Wire.write(MSB(offset));
-    HAL_Wire.write(LSB(offset));
-    HAL_Wire.write(data);
-    HAL_Wire.endTransmission();
-    nextOpMs=millis()+10UL;
+  // count bytes, all within one page, queued so the write cycle happens in the background
+  void ee_write(int offset, byte *data, byte count) {
+    byte b[I2C_BUFFER_SIZE];
+    b[0]=MSB(offset); b[1]=LSB(offset); memcpy(&b[2],data,count);
+    while (!i2cBus.queue(_eeprom_addr,b,count+2,0,NULL,NULL)) i2cBus.poll();
   }
 
+  // sequential reads, in blocks the Wire buffer can hold (after any queued writes)
   void ee_read(int offset, byte *data, byte count) {
-    while ((int32_t)(millis()-nextOpMs) < 0) {}
-
-    HAL_Wire.beginTransmission(_eeprom_addr);
-    HAL_Wire.write(MSB(offset));
-    HAL_Wire.write(LSB(offset));
-    HAL_Wire.endTransmission();
-
-    HAL_Wire.requestFrom(_eeprom_addr, (uint8_t)count);
-    while (HAL_Wire.available()) {
-      *data = HAL_Wire.read(); data++;
+    while (count > 0) {
+      byte n=count; if (n > I2C_EEPROM_READ_MAX) n=I2C_EEPROM_READ_MAX;
+      byte a[2]={(byte)MSB(offset),(byte)LSB(offset)};
+      i2cBus.transfer(_eeprom_addr,a,2,data,n);
+      offset+=n; data+=n; count-=n;
     }
   }
 };
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <Wire.h>
+#include "I2C_Async.h"
 
 // I2C EEPROM Address on DS3231 RTC module
 #define I2C_EEPROM_ADDRESS 0x57
@@ -14,6 +15,19 @@
 #define MSB(i) (i >> 8)
 #define LSB(i) (i & 0xFF)
 
+// the EEPROM writes up to a 32 byte page at once, the Wire buffer also has to hold the two address bytes
+#define I2C_EEPROM_PAGE 32
+#if defined(BUFFER_LENGTH) && BUFFER_LENGTH < I2C_EEPROM_PAGE+2
+  #define I2C_EEPROM_WRITE_MAX (BUFFER_LENGTH-2)
+  #define I2C_EEPROM_READ_MAX BUFFER_LENGTH
+#else
+  #define I2C_EEPROM_WRITE_MAX I2C_EEPROM_PAGE
+  #define I2C_EEPROM_READ_MAX I2C_EEPROM_PAGE
+#endif
+
+// writes only go to the cache, poll() does the page writes
+#define NV_BLOCK_SIZE 64
+
 class nvs {
   public:    
     void init() {
@@ -27,14 +41,13 @@ class nvs {
       for (int i=0; i < 512; i++) cacheWriteState[i]=0;
     }
 
-    // move data to/from the cache
+    // move data to/from the cache, a block at a time, in the background
     void poll() {
       static int i=4095;
-      uint8_t j;
       int dirtyW, dirtyR;
 
-      // just exit if waiting for an EEPROM write to finish
-      if ((int32_t)(millis()-nextOpMs) < 0) return;
+      // just exit if the last block (or another device's transaction) is still on the I2C bus
+      if (!i2cBus.idle()) return;
 
       // check 20 byte chunks of cache for data that needs processing so < about 2s to check the entire cache
       for (int j=0; j < 20; j++) {
@@ -44,33 +57,35 @@ class nvs {
         if (dirtyW || dirtyR) break;
       }
 
-      // write data as required
+      // write data as required, up to the last dirty byte in this page (any clean bytes between are rewritten from the cache)
       if (dirtyW) {
-        j=cache[i];        // get data from cache
-        ee_write(i,j);     // store in EEPROM
-        bitWrite(cacheWriteState[i/8],i%8,0); // clean
+        int last=i;
+        int end=(i/I2C_EEPROM_PAGE+1)*I2C_EEPROM_PAGE; if (end > i+I2C_EEPROM_WRITE_MAX) end=i+I2C_EEPROM_WRITE_MAX;
+        for (int k=i+1; k < end; k++) {
+          if (bitRead(cacheReadState[k/8],k%8)) break;
+          if (bitRead(cacheWriteState[k/8],k%8)) last=k;
+        }
+        byte b[I2C_BUFFER_SIZE];
+        b[0]=MSB(i); b[1]=LSB(i); memcpy(&b[2],&cache[i],last-i+1);
+        if (!i2cBus.queue(_eeprom_addr,b,last-i+3,0,NULL,NULL)) return;
+        for (int k=i; k <= last; k++) bitWrite(cacheWriteState[k/8],k%8,0); // clean
+        i=last;
       } else {
         // read data as required
         if (dirtyR) {
-          ee_read(i,&j,1); // get data from EEPROM
-          cache[i]=j;      // store in cache
-          bitWrite(cacheReadState[i/8],i%8,0); // clean
+          int n=cacheRun(i);
+          byte a[2]={(byte)MSB(i),(byte)LSB(i)};
+          if (!i2cBus.queue(_eeprom_addr,a,2,n,fillDone,this)) return;
+          fillOffset=i;
+          i+=n-1;
         }
       }
     }
 
     uint8_t read(int i) {
       int dirty=bitRead(cacheReadState[i/8],i%8);
-      if (dirty) {
-        uint8_t j;
-        ee_read(i,&j,1);
-        
-        // store and mark as clean
-        cache[i]=j;
-        bitWrite(cacheReadState[i/8],i%8,0);
-
-        return j;
-      } else return cache[i];
+      if (dirty) cacheFill(i);
+      return cache[i];
     }
 
     void update(int i, byte j) {
@@ -167,37 +182,44 @@ class nvs {
       for (int j=0; j < count; j++) { *v = read(i + j); v++; }
     }
 
+    // write count bytes to EEPROM starting at position i
+    void writeBytes(int i, byte *v, byte count) {
+      for (int j=0; j < count; j++) { update(i + j, *v); v++; }
+    }
+
 private:
   // Address of the I2C EEPROM
   uint8_t _eeprom_addr;
-  uint32_t nextOpMs=0;
+  int fillOffset=0;
   uint8_t cache[4096];
   uint8_t cacheReadState[512];
   uint8_t cacheWriteState[512];
 
-  void ee_write(int offset, byte data) {
-    while ((int32_t)(millis()-nextOpMs) < 0) {}
-
-    HAL_Wire.beginTransmission(_eeprom_addr);
-    HAL_Wire.write(MSB(offset));
-    HAL_Wire.write(LSB(offset));
-    HAL_Wire.write(data);
-    HAL_Wire.endTransmission();
-    nextOpMs=millis()+10UL;
+  // length of the run of uncached bytes starting at i
+  int cacheRun(int i) {
+    int n=1;
+    while ((i+n <= 4095) && (n < I2C_EEPROM_READ_MAX) && bitRead(cacheReadState[(i+n)/8],(i+n)%8)) n++;
+    return n;
   }
 
-  void ee_read(int offset, byte *data, byte count) {
-    while ((int32_t)(millis()-nextOpMs) < 0) {}
+  // stores bytes read from the EEPROM, except any written to the cache while they were on the way
+  void cacheStore(int i, byte *data, int n) {
+    for (int k=i; k < i+n; k++) {
+      if (bitRead(cacheReadState[k/8],k%8)) { cache[k]=data[k-i]; bitWrite(cacheReadState[k/8],k%8,0); } // clean
+    }
+  }
 
-    HAL_Wire.beginTransmission(_eeprom_addr);
-    HAL_Wire.write(MSB(offset));
-    HAL_Wire.write(LSB(offset));
-    HAL_Wire.endTransmission();
+  static void fillDone(byte status, byte *data, byte count, void *context) {
+    nvs *n=(nvs*)context;
+    if (status == I2C_OK) n->cacheStore(n->fillOffset,data,count);
+  }
 
-    HAL_Wire.requestFrom(_eeprom_addr, (uint8_t)count);
-    while (HAL_Wire.available()) {
-      *data = HAL_Wire.read(); data++;
-    }
+  // reads the run of uncached bytes starting at i into the cache now, returns the count
+  int cacheFill(int i) {
+    int n=cacheRun(i);
+    byte a[2]={(byte)MSB(i),(byte)LSB(i)}, b[I2C_EEPROM_READ_MAX];
+    if (i2cBus.transfer(_eeprom_addr,a,2,b,n) == I2C_OK) cacheStore(i,b,n);
+    return n;
   }
 };
 
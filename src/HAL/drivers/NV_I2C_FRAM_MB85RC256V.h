@@ -4,10 +4,23 @@
 #pragma once
 
 #include <Wire.h>
+#include "I2C_Async.h"
 #include "Adafruit_FRAM_I2C.h"  // https://github.com/hjd1964/Adafruit_FRAM_I2C
 Adafruit_FRAM_I2C fram = Adafruit_FRAM_I2C();
 #define E2END 32767
 
+// blocks are limited only by the Wire buffer, which also has to hold the two address bytes for a write
+#if defined(BUFFER_LENGTH) && BUFFER_LENGTH < I2C_BUFFER_SIZE
+  #define I2C_FRAM_WRITE_MAX (BUFFER_LENGTH-2)
+  #define I2C_FRAM_READ_MAX BUFFER_LENGTH
+#else
+  #define I2C_FRAM_WRITE_MAX (I2C_BUFFER_SIZE-2)
+  #define I2C_FRAM_READ_MAX I2C_BUFFER_SIZE
+#endif
+
+// FRAM writes take no longer than the bus transfer
+#define NV_BLOCK_SIZE I2C_FRAM_WRITE_MAX
+
 class nvs {
   public:
     void init() {
@@ -18,13 +31,13 @@ class nvs {
     }
 
     byte read(int i) {
-      delayMicroseconds(3);
-      return fram.read8(i);
+      byte j;
+      fram_read(i,&j,1);
+      return j;
     }
 
     void update(int i, byte j) {
-      delayMicroseconds(3);
-      fram.write8(i,j);
+      fram_write(i,&j,1);
     }
 
     void write(int i, byte j) {
@@ -33,48 +46,34 @@ class nvs {
 
     // write int numbers into EEPROM at position i (2 bytes)
     void writeInt(int i, int j) {
-      uint8_t *k = (uint8_t*)&j;
-      update(i + 0, *k); k++;
-      update(i + 1, *k);
+      fram_write(i,(byte*)&j,2);
     }
 
     // read int numbers from EEPROM at position i (2 bytes)
     int readInt(int i) {
       uint16_t j;
-      uint8_t *k = (uint8_t*)&j;
-      *k = read(i + 0); k++;
-      *k = read(i + 1);
+      fram_read(i,(byte*)&j,2);
       return j;
     }
 
     // write 4 byte variable into EEPROM at position i (4 bytes)
     void writeQuad(int i, byte *v) {
-      update(i + 0, *v); v++;
-      update(i + 1, *v); v++;
-      update(i + 2, *v); v++;
-      update(i + 3, *v);
+      fram_write(i,v,4);
     }
 
     // read 4 byte variable from EEPROM at position i (4 bytes)
     void readQuad(int i, byte *v) {
-      *v = read(i + 0); v++;
-      *v = read(i + 1); v++;
-      *v = read(i + 2); v++;
-      *v = read(i + 3);
+      fram_read(i,v,4);
     }
 
     // write String into EEPROM at position i (16 bytes)
     void writeString(int i, char l[]) {
-      for (int l1 = 0; l1 < 16; l1++) {
-        update(i + l1, *l); l++;
-      }
+      fram_write(i,(byte*)l,16);
     }
 
     // read String from EEPROM at position i (16 bytes)
     void readString(int i, char l[]) {
-      for (int l1 = 0; l1 < 16; l1++) {
-        *l = read(i + l1); l++;
-      }
+      fram_read(i,(byte*)l,16);
     }
 
     // write 4 byte float into EEPROM at position i (4 bytes)
@@ -103,7 +102,34 @@ class nvs {
 
     // read count bytes from EEPROM starting at position i
     void readBytes(int i, byte *v, byte count) {
-      for (int j=0; j < count; j++) { *v = read(i + j); v++; }
+      fram_read(i,v,count);
+    }
+
+    // write count bytes to EEPROM starting at position i
+    void writeBytes(int i, byte *v, byte count) {
+      fram_write(i,v,count);
+    }
+
+  private:
+    // FRAM has no write cycle or pages so a block is just a longer transaction, writes are queued
+    void fram_write(int i, byte *v, byte count) {
+      byte b[I2C_BUFFER_SIZE];
+      while (count > 0) {
+        byte n=count; if (n > I2C_FRAM_WRITE_MAX) n=I2C_FRAM_WRITE_MAX;
+        b[0]=i >> 8; b[1]=i & 0xFF; memcpy(&b[2],v,n);
+        while (!i2cBus.queue(MB85RC_DEFAULT_ADDRESS,b,n+2,0,NULL,NULL)) i2cBus.poll();
+        i+=n; v+=n; count-=n;
+      }
+    }
+
+    // reads happen after any queued writes
+    void fram_read(int i, byte *v, byte count) {
+      while (count > 0) {
+        byte n=count; if (n > I2C_FRAM_READ_MAX) n=I2C_FRAM_READ_MAX;
+        byte a[2]={(byte)(i >> 8),(byte)(i & 0xFF)};
+        i2cBus.transfer(MB85RC_DEFAULT_ADDRESS,a,2,v,n);
+        i+=n; v+=n; count-=n;
+      }
     }
 };
 
@@ -55,18 +55,17 @@ class cb {
         return false;
       }
     }
+    // the command and parameter are returned in place, they stay valid until the next add()
     char* getCmd() {
-      // the command is either one or two chars in length
-      cmd[0]=0;
-      memmove(cmd,(char *)&cb[1],2); cmd[2]=0;
-      if ((cmd[1] == '#') && (cmd[2] == 0)) cmd[1]=0;
-      return cmd;
+      // the command is either one or two chars in length, cb[1] and cb[2] (zero for one char commands)
+      terminate();
+      return &cb[1];
     }
     char* getParameter() {
       // the remaining parameter
-      pb[0]=0;
-      if (cbp > 4) memmove(pb,(char *)&cb[3],cbp-4); pb[cbp-4]=0;
-      return pb;
+      terminate();
+      if (cbp < 3) return &cb[cbp];
+      return &cb[3];
     }
     char* getSeq() {
       static char s[2]=" ";
@@ -84,9 +83,12 @@ class cb {
       return true;
     }
   private:
+    // drop the '#' so the command and parameter end there
+    void terminate() {
+      if ((cbp > 0) && (cb[cbp-1] == '#')) cb[cbp-1]=0;
+    }
+
     const static int bufferSize=30;
-    char cmd[4]="";
-    char pb[bufferSize]="";
     char cb[bufferSize]="";
     int cbp=0;
     char seq=0;
@@ -1,22 +1,39 @@
-double getInstrAxis1() {
-  cli(); long p1=posAxis1; sei(); double p=(double)((long)p1+indexAxis1Steps)/(double)AXIS1_STEPS_PER_DEGREE;
-  cli(); long p2=posAxis2; sei(); double q=(double)((long)p2+indexAxis2Steps)/(double)AXIS2_STEPS_PER_DEGREE;
+// instrument coordinates from step positions (with the index steps added)
+double stepsToInstrAxis1(long a1, long a2) {
+  double p=(double)a1/(double)AXIS1_STEPS_PER_DEGREE;
+  double q=(double)a2/(double)AXIS2_STEPS_PER_DEGREE;
   if ((q < -90.0) || (q > 90.0)) p=p+180.0-360.0;
   return p;
 }
 
-double getInstrAxis2() {
-  cli(); long p2=posAxis2; sei(); double q=(double)((long)p2+indexAxis2Steps)/(double)AXIS2_STEPS_PER_DEGREE;
+double stepsToInstrAxis2(long a2) {
+  double q=(double)a2/(double)AXIS2_STEPS_PER_DEGREE;
   if ((q < -90.0) || (q > 90.0)) q=180.0-q; if (q > 180.0) q-=360.0; if (q < -180.0) q+=360.0;
   return q;
 }
 
-int getInstrPierSide() {
+int stepsToInstrPierSide(long a2) {
   if (atHome) return PierSideNone;
-  cli(); long p2=posAxis2; sei(); double q=(double)((long)p2+indexAxis2Steps)/(double)AXIS2_STEPS_PER_DEGREE;
+  double q=(double)a2/(double)AXIS2_STEPS_PER_DEGREE;
   if ((q < -90.0) || (q > 90.0)) return PierSideWest; else return PierSideEast;
 }
 
+double getInstrAxis1() {
+  cli(); long p1=posAxis1; sei();
+  cli(); long p2=posAxis2; sei();
+  return stepsToInstrAxis1(p1+indexAxis1Steps,p2+indexAxis2Steps);
+}
+
+double getInstrAxis2() {
+  cli(); long p2=posAxis2; sei();
+  return stepsToInstrAxis2(p2+indexAxis2Steps);
+}
+
+int getInstrPierSide() {
+  cli(); long p2=posAxis2; sei();
+  return stepsToInstrPierSide(p2+indexAxis2Steps);
+}
+
 void setIndexAxis1(double axis1, int newPierSide) {
   // sky=pos+index, index=sky-pos
   if (newPierSide == PierSideWest) axis1=axis1+180.0;
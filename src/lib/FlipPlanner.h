@@ -0,0 +1,162 @@
+// -----------------------------------------------------------------------------------
+// Meridian flip path planning (enable with MFLIP_PLANNER_ON in OnStep.ino)
+
+#pragma once
+
+// Positions here are mechanical axis angles in degrees, the step position plus index as setTargetAxis1/2() work in.  East of the
+// pier these are just the HA and Dec, west of the pier they're HA+180 and 180-Dec (-180-Dec in the southern hemisphere.)  Any
+// position with Axis2 at the pole (homePositionAxis2) points at the pole whatever Axis1 is, every flip passes through there.
+//
+// The planner tries a direct slew, then a stop at the pole at a few Axis1 angles, then the classic waypoints (as moveTo() has
+// always picked them.)  Each path is checked at up to 1 degree steps against the horizon and limits and the fastest safe one is
+// kept, if none of the others are safe the classic waypoints are used.  There's nothing OnStep specific in here so it can be built
+// and run on a host over a grid of latitudes and targets (host/tests/flip_planner.cpp.)
+//
+// It runs in goTo() so the work is bounded: a segment gets at most FLIP_PLAN_SEGMENT_SAMPLES samples (2 degrees apart on the
+// longest flips, FLIP_PLAN_ALT_MARGIN covers what the altitude can do in between) and a plan FLIP_PLAN_MAX_SAMPLES in all,
+// any path not checked by then counts as unsafe.
+//
+// Only the horizon, the under the pole limit and the Axis2 limits are checked, the tube or counterweights hitting the pier or
+// tripod inside those limits isn't modeled.  The limits have to be set so that can't happen, as for any other slew.
+
+#define FLIP_PLAN_MAX_WAYPOINTS    2
+#define FLIP_PLAN_ALT_MARGIN       3.0    // in degrees, paths are kept this far above minAlt where possible
+#define FLIP_PLAN_SEGMENT_SAMPLES  100
+#define FLIP_PLAN_MAX_SAMPLES      1000
+#define FLIP_PLAN_RAD           57.29577951308232
+
+typedef struct {
+  double axis1;
+  double axis2;
+} flipPoint_t;
+
+class flipPlanner {
+  public:
+    // set the mount geometry and limits (in degrees,) accelDist is SLEW_ACCELERATION_DIST and coordinated is true if both axes
+    // arrive together (SLEW_COORDINATED_ON) otherwise both axes move at the same rate until the shorter move is done
+    void init(double latitude, double minAlt, double underPoleLimit, double axis2Min, double axis2Max, double homeAxis2, double accelDist, bool coordinated) {
+      _latitude=latitude; _sinLat=sin(latitude/FLIP_PLAN_RAD); _cosLat=cos(latitude/FLIP_PLAN_RAD);
+      _minAlt=minAlt; _sinMinAlt=sin((minAlt+FLIP_PLAN_ALT_MARGIN)/FLIP_PLAN_RAD); _underPoleLimit=underPoleLimit; _axis2Min=axis2Min; _axis2Max=axis2Max;
+      _homeAxis2=homeAxis2; _accelDist=accelDist; _coordinated=coordinated;
+    }
+
+    // mechanical position for the given instrument coordinates, as setTargetAxis1/2() less the index
+    flipPoint_t toMech(double axis1, double axis2, bool pierSideWest) {
+      flipPoint_t m; m.axis1=axis1; m.axis2=axis2;
+      if (pierSideWest) { m.axis1+=180.0; if (_latitude >= 0) m.axis2=180.0-axis2; else m.axis2=-180.0-axis2; }
+      if (m.axis2 > 360.0) m.axis2-=360.0;
+      if (m.axis2 < -360.0) m.axis2+=360.0;
+      return m;
+    }
+
+    // plans the path from start to target, the classic waypoints are used if classicOnly (for pause at home) or nothing else is safe
+    // returns the number of waypoints, 0 for a direct slew
+    int plan(flipPoint_t start, flipPoint_t target, const flipPoint_t *classic, int classicCount, bool classicOnly) {
+      _count=classicCount; for (int i=0; i < classicCount; i++) _waypoint[i]=classic[i];
+      _next=0;
+      samples=0;
+      if (classicOnly) return _count;
+
+      double best=pathCost(start,target,_waypoint,_count);
+      if (!pathSafe(start,target,_waypoint,_count)) best=1.0E9;
+
+      // a direct slew
+      if (pathSafe(start,target,NULL,0)) { double c=pathCost(start,target,NULL,0); if (c < best) { best=c; _count=0; } }
+
+      // a stop at the pole, Axis1 at the start, target, half way between or the classic waypoint
+      double a1[4]={ start.axis1, target.axis1, (start.axis1+target.axis1)/2.0, classicCount > 0 ? classic[0].axis1 : start.axis1 };
+      for (int i=0; i < 4; i++) {
+        flipPoint_t p; p.axis1=a1[i]; p.axis2=_homeAxis2;
+        if (pathSafe(start,target,&p,1)) { double c=pathCost(start,target,&p,1); if (c < best) { best=c; _waypoint[0]=p; _count=1; } }
+      }
+      return _count;
+    }
+
+    // gets the next waypoint, returns false when there are none left (move on to the target)
+    bool next(flipPoint_t *p) {
+      if (_next >= _count) return false;
+      *p=_waypoint[_next++];
+      return true;
+    }
+
+    // samples checked since the last plan()
+    int samples=0;
+
+    // true if no point along the path from a to b is beyond the horizon or limits, or at least no more so than a or b is
+    bool segmentSafe(flipPoint_t a, flipPoint_t b) {
+      double d1=b.axis1-a.axis1, d2=b.axis2-a.axis2;
+      double len=fmax(fabs(d1),fabs(d2));
+      double step=fmax(1.0,len/FLIP_PLAN_SEGMENT_SAMPLES);
+      double allowed=fmax(violation(a),violation(b))+0.01;
+      for (double s=step; s < len; s+=step) {
+        if (samples >= FLIP_PLAN_MAX_SAMPLES) return false; else samples++;
+        flipPoint_t p;
+        if (_coordinated) { p.axis1=a.axis1+d1*(s/len); p.axis2=a.axis2+d2*(s/len); } else {
+          p.axis1=a.axis1+(d1 >= 0 ? fmin(s,d1) : fmax(-s,d1));
+          p.axis2=a.axis2+(d2 >= 0 ? fmin(s,d2) : fmax(-s,d2));
+        }
+        if (violation(p) > allowed) return false;
+      }
+      return true;
+    }
+
+    // an estimate of the time it takes to slew from a to b, in degrees at the slew rate
+    double segmentCost(flipPoint_t a, flipPoint_t b) {
+      double len=fmax(fabs(b.axis1-a.axis1),fabs(b.axis2-a.axis2));
+      // at constant acceleration the ramps up and down each take twice as long as the same distance at the slew rate
+      if (len >= _accelDist*2.0) return len+_accelDist*2.0; else return 2.0*sqrt(2.0*len*_accelDist);
+    }
+
+    // altitude of a mechanical position, in degrees
+    double altitude(flipPoint_t m) {
+      double ha, dec; toInstr(m,&ha,&dec);
+      double sinAlt=sin(dec/FLIP_PLAN_RAD)*_sinLat+cos(dec/FLIP_PLAN_RAD)*_cosLat*cos(ha/FLIP_PLAN_RAD);
+      if (sinAlt > 1.0) sinAlt=1.0;
+      if (sinAlt < -1.0) sinAlt=-1.0;
+      return asin(sinAlt)*FLIP_PLAN_RAD;
+    }
+
+  private:
+    // as getInstrAxis1/2()
+    void toInstr(flipPoint_t m, double *axis1, double *axis2) {
+      double p=m.axis1, q=m.axis2;
+      if ((q < -90.0) || (q > 90.0)) { p=p+180.0-360.0; q=180.0-q; }
+      if (q > 180.0) q-=360.0;
+      if (q < -180.0) q+=360.0;
+      *axis1=p; *axis2=q;
+    }
+
+    // how far (in degrees) a position is beyond the horizon (plus margin,) under the pole limit or Axis2 limits
+    double violation(flipPoint_t m) {
+      double ha, dec; toInstr(m,&ha,&dec);
+      // the altitude itself is only needed below the margin
+      double sinAlt=sin(dec/FLIP_PLAN_RAD)*_sinLat+cos(dec/FLIP_PLAN_RAD)*_cosLat*cos(ha/FLIP_PLAN_RAD);
+      double v=0.0;
+      if (sinAlt < _sinMinAlt) v=(_minAlt+FLIP_PLAN_ALT_MARGIN)-asin(fmax(sinAlt,-1.0))*FLIP_PLAN_RAD;
+      v=fmax(v,fabs(ha)-_underPoleLimit);
+      v=fmax(v,_axis2Min-dec);
+      v=fmax(v,dec-_axis2Max);
+      return fmax(v,0.0);
+    }
+
+    bool pathSafe(flipPoint_t start, flipPoint_t target, const flipPoint_t *w, int n) {
+      flipPoint_t a=start;
+      for (int i=0; i < n; i++) { if (!segmentSafe(a,w[i])) return false; a=w[i]; }
+      return segmentSafe(a,target);
+    }
+
+    double pathCost(flipPoint_t start, flipPoint_t target, const flipPoint_t *w, int n) {
+      double c=0; flipPoint_t a=start;
+      for (int i=0; i < n; i++) { c+=segmentCost(a,w[i]); a=w[i]; }
+      return c+segmentCost(a,target);
+    }
+
+    double _latitude=0, _sinLat=0, _cosLat=1;
+    double _minAlt=-10, _sinMinAlt=-0.12, _underPoleLimit=180, _axis2Min=-91, _axis2Max=91;
+    double _homeAxis2=90, _accelDist=5;
+    bool _coordinated=false;
+
+    flipPoint_t _waypoint[FLIP_PLAN_MAX_WAYPOINTS];
+    int _count=0;
+    int _next=0;
+};
@@ -50,20 +50,24 @@ class focuser {
     // move out
     virtual void startMoveOut() { }
 
+    // spos and target are shared with the aux timer ISR (AUX_AXIS_TIMER_ON,) so they're changed with interrupts off
+
     // check if moving
-    bool moving() { if ((delta.fixed != 0) || ((long)target.part.m != spos)) return true; else return false; }
+    bool moving() {
+      cli(); long t=(long)target.part.m; long p=spos; sei();
+      if ((delta.fixed != 0) || (t != p)) return true; else return false;
+    }
 
     // stop move
-    void stopMove() { delta.fixed=0; target.part.m=spos; target.part.f=0; }
+    void stopMove() { delta.fixed=0; cli(); target.part.m=spos; target.part.f=0; sei(); }
 
     // get position in steps
-    long getPosition() { return spos; }
+    long getPosition() { cli(); long p=spos; sei(); return p; }
 
     // sets current position in steps
     void setPosition(long pos) {
-      spos=pos;
-      if (spos < smin) spos=smin; if (spos > smax) spos=smax;
-      target.part.m=spos; target.part.f=0;
+      if (pos < smin) pos=smin; if (pos > smax) pos=smax;
+      cli(); spos=pos; target.part.m=pos; target.part.f=0; sei();
       lastMove=millis();
     }
 
@@ -79,11 +83,14 @@ class focuser {
     // follow( (trackingState == TrackingMoveTo) || guideDirAxis1 || guideDirAxis2) );
     virtual void follow(boolean slewing) { }
 
+    // step toward the target, called from the aux timer ISR
+    virtual void poll() { }
+
     void savePosition() { writePos(spos); }
   
   protected:
-    long readPos() { return nv.readLong(nvAddress); }
-    void writePos(long p) { nv.writeLong(nvAddress,(long)p); }
+    long readPos() { return nvj.readLong(nvAddress); }
+    void writePos(long p) { nvj.writeLong(nvAddress,(long)p); }
  
     // parameters
     int stepPin=-1;
@@ -118,7 +125,7 @@ class focuser {
 
     // position
     fixed_t target;
-    long spos=0;
+    volatile long spos=0;
     long lastPos=0;
 
     // automatic movement
@@ -6,7 +6,7 @@
 // time to write position to nv after last movement of Focuser 1/2, default = 5 minutes
 #define FOCUSER_WRITE_DELAY 1000L*60L*5L
 
-#include "focuser.h"
+#include "Focuser.h"
 
 class focuserStepper : public focuser {
   public:
@@ -29,11 +29,11 @@ class focuserStepper : public focuser {
       setTcfEnable(nv.read(nvTcfEn));
       
       // get step position
-      spos=readPos();
-      long lmin=(long)(min*spm); if (spos<lmin) { spos=lmin; target.part.m=spos; target.part.f=0; }
-      long lmax=(long)(max*spm); if (spos>lmax) { spos=lmax; target.part.m=spos; target.part.f=0; }
-      target.part.m=spos; target.part.f=0;
-      lastPos=spos;
+      long p=readPos();
+      long lmin=(long)(min*spm); if (p<lmin) p=lmin;
+      long lmax=(long)(max*spm); if (p>lmax) p=lmax;
+      cli(); spos=p; target.part.m=p; target.part.f=0; sei();
+      lastPos=p;
       delta.fixed=0;
 
       // set min/max
@@ -47,6 +47,13 @@ class focuserStepper : public focuser {
 
       nextPhysicalMove=micros()+(unsigned long)(maxRate*1000.0);
       lastPhysicalMove=nextPhysicalMove;
+
+#ifdef AUX_AXIS_TIMER_ON
+      // aux timer ticks per step, at least two so the step pin has time low
+      long us=lround(maxRate*1000.0);
+      ticksPerStep=(us+AUX_AXIS_TIMER_PERIOD-1)/AUX_AXIS_TIMER_PERIOD;
+      if (ticksPerStep < 2) ticksPerStep=2;
+#endif
     }
 
     // temperature compensation
@@ -94,27 +101,29 @@ class focuserStepper : public focuser {
 
     // sets target position in steps
     void setTarget(long pos) {
-      target.part.m=pos; target.part.f=0;
-      if ((long)target.part.m < smin) target.part.m=smin; if ((long)target.part.m > smax) target.part.m=smax;
+      if (pos < smin) pos=smin; if (pos > smax) pos=smax;
+      cli(); target.part.m=pos; target.part.f=0; sei();
     }
 
     // sets target relative position in steps
     void relativeTarget(long pos) {
+      cli();
       target.part.m+=pos; target.part.f=0;
       if ((long)target.part.m < smin) target.part.m=smin; if ((long)target.part.m > smax) target.part.m=smax;
+      sei();
     }
     
     // do automatic movement
     void move() {
-      target.fixed+=delta.fixed;
+      cli(); target.fixed+=delta.fixed; long t=(long)target.part.m; sei();
       // stop at limits
-      if (((long)target.part.m < smin) || ((long)target.part.m > smax)) delta.fixed=0;
+      if ((t < smin) || (t > smax)) delta.fixed=0;
     }
 
     void follow(boolean slewing) {
 
       // if enabled and the timeout has elapsed, disable the stepper driver
-      if (pda && !currentlyDisabled && ((micros()-lastPhysicalMove) > 10000000L)) { disableDriver(); currentlyDisabled=true; }
+      if (pda && !currentlyDisabled && ((micros()-lastPhysicalMove) > 10000000L)) { currentlyDisabled=true; disableDriver(); }
     
       // write position to non-volatile storage if not moving for FOCUSER_WRITE_DELAY milliseconds
       if ((spos != lastPos)) { lastMove=millis(); lastPos=spos; }
@@ -124,13 +133,17 @@ class focuserStepper : public focuser {
       }
 
       // temperature compensation
-      long tcfSteps;
       if (tcf) {
         tcfSteps = -round((tcf_coef * (ambient.getTelescopeTemperature() - 10.0)) * spm);
       } else {
         tcfSteps = 0;
       }
 
+#ifdef AUX_AXIS_TIMER_ON
+      // the aux timer does the stepping, just wake up the stepper driver if there's somewhere to go
+      cli(); long t=(long)target.part.m; sei();
+      if (pda && currentlyDisabled && (spos != t + tcfSteps)) { enableDriver(); currentlyDisabled=false; }
+#else
       unsigned long microsNow=micros();
       if ((long)(microsNow-nextPhysicalMove) > 0) {
         nextPhysicalMove=microsNow+(unsigned long)(maxRate*1000.0);
@@ -150,8 +163,30 @@ class focuserStepper : public focuser {
           lastPhysicalMove=micros();
         }
       }
+#endif
     }
 
+#ifdef AUX_AXIS_TIMER_ON
+    // step toward the target at up to maxRate, called from the aux timer ISR every AUX_AXIS_TIMER_PERIOD microseconds
+    // a step takes two ticks (step pin high then low) and a direction change adds one tick before the step
+    void poll() {
+      if (stepPinHigh) { digitalWrite(stepPin,LOW); stepPinHigh=false; }
+      if (ticks > 0) { ticks--; return; }
+      if (pda && currentlyDisabled) return;
+
+      long t=(long)target.part.m + tcfSteps;
+      int dirState;
+      if ((spos < t) && (spos < smax)) dirState=forwardState; else
+      if ((spos > t) && (spos > smin)) dirState=reverseState; else return;
+
+      if (dirState != lastDirState) { digitalWrite(dirPin,dirState); lastDirState=dirState; return; }
+      digitalWrite(stepPin,HIGH); stepPinHigh=true;
+      if (dirState == forwardState) spos++; else spos--;
+      ticks=ticksPerStep-1;
+      lastPhysicalMove=micros();
+    }
+#endif
+
   private:
 
     void enableDriver() {
@@ -166,4 +201,12 @@ class focuserStepper : public focuser {
       if ((enPin == 66) || (enPin == 67)) { if (disableState == HIGH) analogWrite(enPin,255); else analogWrite(enPin,0); delayMicroseconds(30); } else 
       { digitalWrite(enPin,disableState); delayMicroseconds(5); }
     }
+
+    volatile long tcfSteps=0;
+#ifdef AUX_AXIS_TIMER_ON
+    int ticksPerStep=2;
+    volatile int ticks=0;
+    int lastDirState=-1;
+    bool stepPinHigh=false;
+#endif
 };
@@ -0,0 +1,129 @@
+// -----------------------------------------------------------------------------------
+// Journal for frequently written NV values (park status, PEC status, focuser positions)
+
+// Each change is appended as a 12 byte record (sequence, EE_ address, value, CRC16) to the next slot of a ring at EE_journal
+// instead of being written over the same EEPROM cells, so the wear is spread across the whole ring.  A slot holding the
+// latest record for any value is never written so a power loss part way through a record only loses that record, the
+// CRC shows it up at the next boot and the previous one is used.  Values without a record yet read from their EE_ address.
+
+#pragma once
+
+#define NV_JOURNAL_RECORD    12
+#define NV_JOURNAL_SLOTS     (NV_JOURNAL_SIZE/NV_JOURNAL_RECORD)
+#define NV_JOURNAL_KEYS      8    // most values that can be journaled
+#define NV_JOURNAL_WRITE_MS  10   // one byte per EEPROM write cycle so poll() never waits on the NV
+
+typedef struct {
+  int16_t address;                // EE_ address, -1 if unused
+  int32_t value;
+  int slot;                       // slot with the latest record, -1 if none
+  boolean dirty;                  // value not committed yet
+} journalKey_t;
+
+class nvJournal {
+  public:
+    // scans the ring for the latest valid record of each value
+    void init() {
+      for (int k=0; k < NV_JOURNAL_KEYS; k++) { keys[k].address=-1; keys[k].slot=-1; keys[k].dirty=false; }
+      seq=0; nextSlot=0; commitSlot=-1;
+
+      byte r[NV_JOURNAL_RECORD];
+      uint32_t keySeq[NV_JOURNAL_KEYS];
+      for (int s=0; s < NV_JOURNAL_SLOTS; s++) {
+        nv.readBytes(EE_journal+s*NV_JOURNAL_RECORD,r,NV_JOURNAL_RECORD);
+        if (!valid(r)) continue;
+        uint32_t rs; int16_t a; int32_t v;
+        memcpy(&rs,&r[0],4); memcpy(&a,&r[4],2); memcpy(&v,&r[6],4);
+        if (rs >= seq) { seq=rs+1; nextSlot=(s+1)%NV_JOURNAL_SLOTS; }
+        int k=find(a,true); if (k < 0) continue;
+        if ((keys[k].slot < 0) || (rs > keySeq[k])) { keys[k].value=v; keys[k].slot=s; keySeq[k]=rs; }
+      }
+    }
+
+    // erases the ring, for NV that held something else (new NV, or catalog records from before the journal)
+    void clear() {
+      for (int i=0; i < NV_JOURNAL_SLOTS*NV_JOURNAL_RECORD; i++) nv.write(EE_journal+i,0xff);
+      init();
+    }
+
+    byte read(int address) {
+      int k=find(address,false);
+      if (known(k)) return keys[k].value; else return nv.read(address);
+    }
+    long readLong(int address) {
+      int k=find(address,false);
+      if (known(k)) return keys[k].value; else return nv.readLong(address);
+    }
+
+    // queues the value, poll() commits it
+    void write(int address, byte value) { writeLong(address,value); }
+    void writeLong(int address, long value) {
+      int k=find(address,true); if (k < 0) return;
+      if (known(k) && (keys[k].value == (int32_t)value)) return;
+      keys[k].value=value; keys[k].dirty=true;
+    }
+
+    // writes at most one byte of a pending record
+    void poll() {
+      if ((long)(millis()-lastWriteMs) < NV_JOURNAL_WRITE_MS) return;
+      if (commitSlot < 0 && !start()) return;
+      commitByte();
+    }
+
+  private:
+    journalKey_t keys[NV_JOURNAL_KEYS];
+    uint32_t seq;
+    int nextSlot;
+    int commitSlot, commitKey, commitPos;
+    byte commitBuf[NV_JOURNAL_RECORD];
+    unsigned long lastWriteMs=0;
+
+    boolean valid(byte *r) {
+      uint16_t c; memcpy(&c,&r[10],2);
+      return crc16(r,10) == c;
+    }
+
+    boolean known(int k) { return (k >= 0) && ((keys[k].slot >= 0) || keys[k].dirty); }
+
+    int find(int address, boolean add) {
+      for (int k=0; k < NV_JOURNAL_KEYS; k++) if (keys[k].address == address) return k;
+      if (add) for (int k=0; k < NV_JOURNAL_KEYS; k++) if (keys[k].address == -1) { keys[k].address=address; return k; }
+      return -1;
+    }
+
+    boolean live(int s) {
+      for (int k=0; k < NV_JOURNAL_KEYS; k++) if (keys[k].slot == s) return true;
+      return false;
+    }
+
+    // sets up the record for the next pending value in a free slot
+    boolean start() {
+      int k; for (k=0; k < NV_JOURNAL_KEYS; k++) if (keys[k].dirty) break;
+      if (k == NV_JOURNAL_KEYS) return false;
+      while (live(nextSlot)) nextSlot=(nextSlot+1)%NV_JOURNAL_SLOTS;
+      memcpy(&commitBuf[0],&seq,4); memcpy(&commitBuf[4],&keys[k].address,2); memcpy(&commitBuf[6],&keys[k].value,4);
+      uint16_t c=crc16(commitBuf,10); memcpy(&commitBuf[10],&c,2);
+      commitSlot=nextSlot; commitKey=k; commitPos=0;
+      return true;
+    }
+
+    // writes the next byte that differs, once the record is complete it becomes the latest for its value
+    void commitByte() {
+      int a=EE_journal+commitSlot*NV_JOURNAL_RECORD;
+      while (commitPos < NV_JOURNAL_RECORD) {
+        byte b=commitBuf[commitPos];
+        boolean differs=(nv.read(a+commitPos) != b);
+        if (differs) { nv.write(a+commitPos,b); lastWriteMs=millis(); }
+        commitPos++;
+        if (differs) break;
+      }
+      if (commitPos < NV_JOURNAL_RECORD) return;
+
+      int32_t v; memcpy(&v,&commitBuf[6],4);
+      keys[commitKey].slot=commitSlot;
+      if (keys[commitKey].value == v) keys[commitKey].dirty=false;
+      seq++; nextSlot=(commitSlot+1)%NV_JOURNAL_SLOTS; commitSlot=-1;
+    }
+};
+
+nvJournal nvj;
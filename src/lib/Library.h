@@ -53,10 +53,16 @@ class Library
     int recFreeAll();  // number records available for this library
     int recPos;        // currently selected record#
     int recMax;        // last record#
+
+    boolean savedRange(int *first, int *last); // NV range the catalog was saved in, false if not known
+    void saveRange();
+    boolean relocate(int first, int last);    // moves records saved in another range to this one
     
   private:
     libRec_t readRec(int address);
     void writeRec(int address, libRec_t data);
+    libRec_t readRecAt(int l);
+    void writeRecAt(int l, libRec_t data);
     void clearRec(int address);
     inline double degRange(double d) { while (d >= 360.0) d-=360.0; while (d < 0.0)  d+=360.0; return d; }
 
@@ -68,6 +74,9 @@ class Library
     int byteMax;
 };
 
+// the PEC table and the journal must leave room for the catalog
+static_assert(EE_pecTable+PEC_TABLE_BYTES+rec_size <= EE_journal, "No NV left for the object library, use fewer PEC_HIRES_BINS or a shorter worm period");
+
 Library Lib;
 char const * objectStr[] = {"UNK", "OC", "GC", "PN", "DN", "SG", "EG", "IG", "KNT", "SNR", "GAL", "CN", "STR", "PLA", "CMT", "AST"};
 
@@ -75,9 +84,9 @@ Library::Library()
 {
   catalog=0;
 
-  byteMin=200+pecBufferSize;
+  byteMin=200+pecTableBytes;
   
-  byteMax=E2END-100;
+  byteMax=EE_journal-1;
 
   byteCount=(byteMax-byteMin)+1;
   bytePos=byteMin;
@@ -147,19 +156,25 @@ void Library::readVars(char* name, int* code, double* RA, double* Dec)
 }
 
 libRec_t Library::readRec(int address)
+{
+  return readRecAt(address*rec_size+byteMin);
+}
+
+void Library::writeRec(int address, libRec_t data)
+{
+  if ((address >= 0) && (address < recMax)) writeRecAt(address*rec_size+byteMin,data);
+}
+
+libRec_t Library::readRecAt(int l)
 {
   libRec_t work;
-  int l=address*rec_size+byteMin;
   nv.readBytes(l,(uint8_t*)&work.libRecBytes,16);
   return work;
 }
 
-void Library::writeRec(int address, libRec_t data)
+void Library::writeRecAt(int l, libRec_t data)
 {
-  if ((address >= 0) && (address < recMax)) {
-    int l=address*rec_size+byteMin;
-    for (int m=0;m < 16;m++) nv.write(l+m,data.libRecBytes[m]);
-  }
+  for (int m=0;m < 16;m++) nv.write(l+m,data.libRecBytes[m]);
 }
 
 void Library::clearRec(int address)
@@ -363,3 +378,50 @@ void Library::clearAll()
 {
   for (int l=0;l < recMax;l++) clearRec(l);
 }
+
+// the first and last byte of the catalog as saved in NV (with a check word,) false if they weren't saved
+boolean Library::savedRange(int *first, int *last)
+{
+  *first=nv.readInt(EE_libLayout);
+  *last=nv.readInt(EE_libLayout+2);
+  if ((nv.readInt(EE_libLayout+4)&0xffff) != ((*first^*last^0x5aa5)&0xffff)) return false;
+  return (*first >= EE_pecTable) && (*first < *last) && (*last <= E2END);
+}
+
+void Library::saveRange()
+{
+  nv.writeInt(EE_libLayout,byteMin);
+  nv.writeInt(EE_libLayout+2,byteMax);
+  nv.writeInt(EE_libLayout+4,byteMin^byteMax^0x5aa5);
+}
+
+// moves the records of a catalog saved in first..last (another firmware's NV layout) into this one, keeping their order,
+// records past the end of this catalog are lost.  False if the catalog was already here
+boolean Library::relocate(int first, int last)
+{
+  if ((first == byteMin) && (last == byteMax)) return false;
+
+  // pack the records to the start of the old range
+  libRec_t work;
+  int oldMax=(last-first+1)/rec_size;
+  int n=0;
+  for (int l=0;l < oldMax;l++) {
+    work=readRecAt(first+l*rec_size);
+    int cat=(int)work.libRec.code>>4;
+    if ((cat < 0) || (cat > 14)) continue;
+    if (l != n) writeRecAt(first+n*rec_size,work);
+    n++;
+  }
+
+  // then move them across, from the end that's moving away from the records not moved yet
+  if (n > recMax) n=recMax;
+  if (byteMin > first) {
+    for (int l=n-1;l >= 0;l--) writeRecAt(byteMin+l*rec_size,readRecAt(first+l*rec_size));
+  } else {
+    for (int l=0;l < n;l++) writeRecAt(byteMin+l*rec_size,readRecAt(first+l*rec_size));
+  }
+  for (int l=n;l < recMax;l++) clearRec(l);
+
+  saveRange();
+  return true;
+}
@@ -62,3 +62,30 @@ double frac(double v) {
 double cot(double n) {
   return 1.0/tan(n);
 }
+
+// solves a.x=b for the n x n symmetric positive definite matrix a (row major) by Cholesky decomposition
+// a is overwritten with the decomposition and b with x, returns false if a isn't positive definite
+bool choleskySolve(double *a, double *b, int n) {
+  for (int j=0; j < n; j++) {
+    double s=a[j*n+j]; for (int k=0; k < j; k++) s-=a[j*n+k]*a[j*n+k];
+    if (!(s > 0.0)) return false;
+    a[j*n+j]=sqrt(s);
+    for (int i=j+1; i < n; i++) {
+      double t=a[i*n+j]; for (int k=0; k < j; k++) t-=a[i*n+k]*a[j*n+k];
+      a[i*n+j]=t/a[j*n+j];
+    }
+  }
+  for (int i=0; i < n; i++) { double s=b[i]; for (int k=0; k < i; k++) s-=a[i*n+k]*b[k]; b[i]=s/a[i*n+i]; }
+  for (int i=n-1; i >= 0; i--) { double s=b[i]; for (int k=i+1; k < n; k++) s-=a[k*n+i]*b[k]; b[i]=s/a[i*n+i]; }
+  return true;
+}
+
+// CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) of n bytes
+uint16_t crc16(const byte *b, int n) {
+  uint16_t crc=0xFFFF;
+  for (int i=0; i < n; i++) {
+    crc^=(uint16_t)b[i]<<8;
+    for (int j=0; j < 8; j++) { if (crc & 0x8000) crc=(crc<<1)^0x1021; else crc<<=1; }
+  }
+  return crc;
+}
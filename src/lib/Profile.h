@@ -0,0 +1,103 @@
+// -----------------------------------------------------------------------------------
+// Execution time profiling for the ISR's and main loop tasks (enable with PROFILE_ON in OnStep.ino)
+
+#pragma once
+
+// the probes
+#define PROFILE_TIMER1      0 // sidereal timer ISR
+#define PROFILE_TIMER3      1 // Axis1 motor timer ISR
+#define PROFILE_TIMER4      2 // Axis2 motor timer ISR
+#define PROFILE_SUPERVISOR  3 // timerSupervisor()
+#define PROFILE_MOVETO      4 // moveTo()
+#define PROFILE_COMMANDS    5 // processCommands()
+#define PROFILE_MODEL       6 // Align.model(), includes any loop2() calls made while solving
+#define PROFILE_PROBES      7
+
+// histogram buckets are: < base, < base*2, < base*4 ... and >= base*64 (in microseconds)
+#define PROFILE_BUCKETS     8
+#ifdef HAL_SLOW_PROCESSOR
+  #define PROFILE_BUCKET_BASE_US 16
+#else
+  #define PROFILE_BUCKET_BASE_US 1
+#endif
+
+#if defined(PROFILE_ON)
+
+#if defined(__arm__) && (defined(TEENSYDUINO) || defined(__STM32F1__))
+  // Cortex-M3/M4/M7 DWT cycle counter
+  #define PROFILE_DEMCR       (*(volatile uint32_t *)0xE000EDFC)
+  #define PROFILE_DWT_CTRL    (*(volatile uint32_t *)0xE0001000)
+  #define PROFILE_DWT_CYCCNT  (*(volatile uint32_t *)0xE0001004)
+  #define PROFILE_TICKS_PER_US (F_CPU/1000000UL)
+  #define profileCount() PROFILE_DWT_CYCCNT
+#else
+  #define PROFILE_TICKS_PER_US 1UL
+  #define profileCount() micros()
+#endif
+
+#define PROFILE_START(p) uint32_t _profileStart##p=profileCount()
+#define PROFILE_END(p) profile.add(p,profileCount()-_profileStart##p)
+
+class profiler {
+  public:
+    void init() {
+#ifdef PROFILE_DWT_CYCCNT
+      PROFILE_DEMCR|=(1UL<<24);  // TRCENA
+      PROFILE_DWT_CYCCNT=0;
+      PROFILE_DWT_CTRL|=1UL;     // CYCCNTENA
+#endif
+      for (int p=0; p < PROFILE_PROBES; p++) clear(p);
+    }
+
+    // record t ticks against probe p, safe to call from within an ISR
+    void add(byte p, uint32_t t) {
+      byte b=0; uint32_t e=PROFILE_BUCKET_BASE_US*PROFILE_TICKS_PER_US;
+      while ((t >= e) && (b < PROFILE_BUCKETS-1)) { e<<=1; b++; }
+      if (bucket[p][b] < 9999) bucket[p][b]++;
+      if (t > worst[p]) worst[p]=t;
+      // halve the sum and count as needed to keep the average without overflow
+      if ((count[p] >= 0x8000U) || (sum[p] > 0x7FFFFFFFUL)) { count[p]>>=1; sum[p]>>=1; }
+      count[p]++; sum[p]+=t;
+    }
+
+    // reply with "count,average,worst" for probe p, times in microseconds
+    void summary(byte p, char *reply) {
+      cli(); uint16_t c=count[p]; uint32_t s=sum[p]; uint32_t w=worst[p]; sei();
+      char a[12],m[12];
+      dtostrf(c > 0 ? ((double)s/c)/PROFILE_TICKS_PER_US : 0.0,1,1,a);
+      dtostrf((double)w/PROFILE_TICKS_PER_US,1,1,m);
+      sprintf(reply,"%u,%s,%s",(unsigned int)c,a,m);
+    }
+
+    // reply with the histogram for probe p, comma separated counts (each saturates at 9999,) then clears the probe
+    void histogram(byte p, char *reply) {
+      uint16_t h[PROFILE_BUCKETS];
+      cli(); for (int b=0; b < PROFILE_BUCKETS; b++) h[b]=bucket[p][b]; reset(p); sei();
+      reply[0]=0;
+      for (int b=0; b < PROFILE_BUCKETS; b++) { char s[7]; sprintf(s,b == 0 ? "%u" : ",%u",(unsigned int)h[b]); strcat(reply,s); }
+    }
+
+    void clear(byte p) {
+      cli(); reset(p); sei();
+    }
+
+  private:
+    void reset(byte p) {
+      for (int b=0; b < PROFILE_BUCKETS; b++) bucket[p][b]=0;
+      count[p]=0; sum[p]=0; worst[p]=0;
+    }
+
+    volatile uint16_t bucket[PROFILE_PROBES][PROFILE_BUCKETS];
+    volatile uint16_t count[PROFILE_PROBES];
+    volatile uint32_t sum[PROFILE_PROBES];
+    volatile uint32_t worst[PROFILE_PROBES];
+};
+
+profiler profile;
+
+#else
+
+#define PROFILE_START(p)
+#define PROFILE_END(p)
+
+#endif
@@ -53,11 +53,14 @@ class rtcw {
 // -----------------------------------------------------------------------------------
 // DS3231 RTC support 
 // uses the default I2C port in most cases; though HAL_Wire can redirect to another port (as is done for the Teensy3.5/3.6)
+// the library sets the RTC up, after that the time registers (BCD) are read and written through the I2C queue
 
 #include <Wire.h>
 #include <RtcDS3231.h>          // https://github.com/Makuna/Rtc/archive/master.zip
 RtcDS3231<TwoWire> _Rtc(HAL_Wire);
 
+#define RTC_DS3231_ADDRESS 0x68
+
 class rtcw {
   public:
     bool active=false;
@@ -74,12 +77,9 @@ class rtcw {
 #endif
     }
 
-    // set the RTC's time (local standard time)
+    // set the RTC's time (local standard time), queued so the caller doesn't wait on the I2C bus unless the queue is full
     void set(double JD, double LMT) {
       if (!active) return;
-#if defined(ESP32) & defined(WIRE_END_SUPPORT)
-      HAL_Wire.begin();
-#endif
 
       int yy,y,mo,d,h;
       double m,s;
@@ -90,33 +90,30 @@ class rtcw {
       h=floor(f1);
       m=(f1-h)*60.0;
       s=(m-floor(m))*60.0;
-      
-      RtcDateTime updateTime = RtcDateTime(yy, mo, d, h, floor(m), floor(s));
-      _Rtc.SetDateTime(updateTime);
 
-#if defined(ESP32) & defined(WIRE_END_SUPPORT)
-      HAL_Wire.end();
-#endif
+      int dow=(((long)floor(JD+1.5))%7)+1;
+      byte r[8]={ 0, toBcd(floor(s)), toBcd(floor(m)), toBcd(h), (byte)dow, toBcd(d), (byte)(toBcd(mo)|(yy >= 2100?0x80:0)), toBcd(y) };
+      if (!i2cBus.queue(RTC_DS3231_ADDRESS,r,8,0,NULL,NULL)) i2cBus.transfer(RTC_DS3231_ADDRESS,r,8,NULL,0);
     }
     
     // get the RTC's time (local standard time)
     void get(double &JD, double &LMT) {
       if (!active) return;
-#if defined(ESP32) & defined(WIRE_END_SUPPORT)
-      HAL_Wire.begin();
-#endif
 
-      RtcDateTime now = _Rtc.GetDateTime();
-      if ((now.Year() >= 2018) && (now.Year() <= 3000) && (now.Month() >= 1) && (now.Month() <= 12) && (now.Day() >= 1) && (now.Day() <= 31) &&
-          (now.Hour() >= 0) && (now.Hour() <= 23) && (now.Minute() >= 0) && (now.Minute() <= 59) && (now.Second() >= 0) && (now.Second() <= 59)) {
-        JD=julian(now.Year(),now.Month(),now.Day());
-        LMT=(now.Hour()+(now.Minute()/60.0)+(now.Second()/3600.0));
+      byte a=0, r[7];
+      if (i2cBus.transfer(RTC_DS3231_ADDRESS,&a,1,r,7) != I2C_OK) return;
+      int second=fromBcd(r[0]&0x7F), minute=fromBcd(r[1]&0x7F), hour=fromBcd(r[2]&0x3F), day=fromBcd(r[4]&0x3F), month=fromBcd(r[5]&0x1F);
+      int year=2000+fromBcd(r[6]); if (r[5]&0x80) year+=100;
+      if ((year >= 2018) && (year <= 3000) && (month >= 1) && (month <= 12) && (day >= 1) && (day <= 31) &&
+          (hour >= 0) && (hour <= 23) && (minute >= 0) && (minute <= 59) && (second >= 0) && (second <= 59)) {
+        JD=julian(year,month,day);
+        LMT=(hour+(minute/60.0)+(second/3600.0));
       }
-
-#if defined(ESP32) & defined(WIRE_END_SUPPORT)
-      HAL_Wire.end();
-#endif
     }
+
+  private:
+    byte toBcd(int v) { return ((v/10)<<4)|(v%10); }
+    int fromBcd(byte b) { return (b>>4)*10+(b&0x0F); }
 };
 
 #elif RTC == DS3234M
@@ -34,6 +34,13 @@ class rotator {
 
       nextPhysicalMove=micros()+(unsigned long)(maxRate*1000.0);
       lastPhysicalMove=nextPhysicalMove;
+
+#ifdef AUX_AXIS_TIMER_ON
+      // aux timer ticks per step, at least two so the step pin has time low
+      long us=lround(maxRate*1000.0);
+      ticksPerStep=(us+AUX_AXIS_TIMER_PERIOD-1)/AUX_AXIS_TIMER_PERIOD;
+      if (ticksPerStep < 2) ticksPerStep=2;
+#endif
     }
 
     // minimum position in degrees
@@ -72,7 +79,8 @@ class rotator {
 
     // sets rotator to the parallactic angle in this area of the sky
     void setPA(double h, double d) {
-      target.part.m=(long)(ParallacticAngle(h,d)*(double)spd); target.part.f=0;
+      long t=(long)(ParallacticAngle(h,d)*(double)spd);
+      cli(); target.part.m=t; target.part.f=0; sei();
     }
 #endif
 
@@ -81,10 +89,14 @@ class rotator {
       DRreverse=!DRreverse;
     }
 
+    // spos and target are shared with the aux timer ISR (AUX_AXIS_TIMER_ON,) so they're changed with interrupts off
+
     // reset to home
     void reset() {
+      cli();
       spos=0;
       target.fixed=0;
+      sei();
       delta.fixed=0;
       DR=false;
       increment=1.0;
@@ -93,7 +105,7 @@ class rotator {
 
     // return to home
     void home() {
-      target.fixed=0;
+      cli(); target.fixed=0; sei();
       delta.fixed=0;
       DR=false;
       increment=1.0;
@@ -113,7 +125,8 @@ class rotator {
     
     // check if moving
     bool moving() {
-      if ((delta.fixed != 0) || ((long)target.part.m != spos)) return true; else return false;
+      cli(); long t=(long)target.part.m; long p=spos; sei();
+      if ((delta.fixed != 0) || (t != p)) return true; else return false;
     }
 
     // enable/disable new continuous move mode
@@ -128,8 +141,10 @@ class rotator {
       } else {
         fixed_t xl;
         xl.part.m=(long)(increment*spd*1000.0); xl.fixed/=1000;
+        cli();
         target.fixed+=xl.fixed;
         if ((long)target.part.m > smax) { target.part.m=smax; target.part.f=0; }
+        sei();
       }
     }
 
@@ -140,41 +155,48 @@ class rotator {
       } else {
         fixed_t xl;
         xl.part.m=(long)(increment*spd*1000.0); xl.fixed/=1000;
+        cli();
         target.fixed-=xl.fixed;
         if ((long)target.part.m < smin) { target.part.m=smin; target.part.f=0; }
+        sei();
       }
     }
 
     // stop move
     void stopMove() {
       delta.fixed=0;
-      target.part.m=spos; target.part.f=0;
+      cli(); target.part.m=spos; target.part.f=0; sei();
     }
 
     // get position
     double getPosition() {
-      return ((double)spos)/spd;
+      cli(); long p=spos; sei();
+      return ((double)p)/spd;
     }
 
     // sets current position in degrees
     void setPosition(double deg) {
-      spos=round(deg*spd);
-      if (spos < smin) spos=smin; if (spos > smax) spos=smax;
-      target.part.m=spos; target.part.f=0;
+      long p=round(deg*spd);
+      if (p < smin) p=smin; if (p > smax) p=smax;
+      cli(); spos=p; target.part.m=p; target.part.f=0; sei();
       lastMove=millis();
     }
 
     // set target
     void setTarget(double deg) {
-      target.part.m=(long)(deg*spd); target.part.f=0;
-      if ((long)target.part.m < smin) target.part.m=smin; if ((long)target.part.m > smax) target.part.m=smax;
+      long t=(long)(deg*spd);
+      if (t < smin) t=smin; if (t > smax) t=smax;
+      cli(); target.part.m=t; target.part.f=0; sei();
     }
 
     // do de-rotate movement
     void move(boolean tracking) {
+      cli();
       if (DR && tracking) target.fixed+=deltaDR.fixed;
       target.fixed+=delta.fixed;
-      if (((long)target.part.m < smin) || ((long)target.part.m > smax)) { DR=false; delta.fixed=0; deltaDR.fixed=0; }
+      long t=(long)target.part.m;
+      sei();
+      if ((t < smin) || (t > smax)) { DR=false; delta.fixed=0; deltaDR.fixed=0; }
     }
 
 #if MOUNT_TYPE == ALTAZM
@@ -191,6 +213,10 @@ class rotator {
     void follow() {
       if (pda && !currentlyDisabled && ((micros()-lastPhysicalMove) > 10000000L)) { currentlyDisabled=true; disableDriver(); }
       
+#ifdef AUX_AXIS_TIMER_ON
+      // the aux timer does the stepping, just wake up the stepper driver if there's somewhere to go
+      if (pda && currentlyDisabled && moving()) { enableDriver(); currentlyDisabled=false; }
+#else
       unsigned long microsNow=micros();
       if ((long)(microsNow-nextPhysicalMove) > 0) {
         nextPhysicalMove=microsNow+(unsigned long)(maxRate*1000.0);
@@ -210,8 +236,30 @@ class rotator {
           lastPhysicalMove=micros();
         }
       }
+#endif
     }
 
+#ifdef AUX_AXIS_TIMER_ON
+    // step toward the target at up to maxRate, called from the aux timer ISR every AUX_AXIS_TIMER_PERIOD microseconds
+    // a step takes two ticks (step pin high then low) and a direction change adds one tick before the step
+    void poll() {
+      if (stepPinHigh) { digitalWrite(stepPin,LOW); stepPinHigh=false; }
+      if (ticks > 0) { ticks--; return; }
+      if (pda && currentlyDisabled) return;
+
+      long t=(long)target.part.m;
+      int dirState;
+      if ((spos < t) && (spos < smax)) dirState=forwardState; else
+      if ((spos > t) && (spos > smin)) dirState=reverseState; else return;
+
+      if (dirState != lastDirState) { digitalWrite(dirPin,dirState); lastDirState=dirState; return; }
+      digitalWrite(stepPin,HIGH); stepPinHigh=true;
+      if (dirState == forwardState) spos++; else spos--;
+      ticks=ticksPerStep-1;
+      lastPhysicalMove=micros();
+    }
+#endif
+
   private:
 
     void enableDriver() {
@@ -282,7 +330,7 @@ class rotator {
     // position
     fixed_t amountRotate;
     fixed_t target;
-    long spos=0;
+    volatile long spos=0;
     long lastPos=0;
 
     // automatic movement
@@ -296,4 +344,11 @@ class rotator {
     unsigned long lastMove=0;
     unsigned long lastPhysicalMove=0;
     unsigned long nextPhysicalMove=0;
+
+#ifdef AUX_AXIS_TIMER_ON
+    int ticksPerStep=2;
+    volatile int ticks=0;
+    int lastDirState=-1;
+    bool stepPinHigh=false;
+#endif
 };
@@ -6,6 +6,13 @@
 #if WEATHER == BME280 || WEATHER == BME280_SPI || WEATHER == BME280_0x76
   #include <Adafruit_BME280.h>            // https://github.com/adafruit/Adafruit_BME280_Library and https://github.com/adafruit/Adafruit_Sensor
   #if WEATHER == BME280 || WEATHER == BME280_0x76
+    // the library sets the BME280 up (continuous measurement,) after that the readings come through the I2C queue
+    #define BME280_I2C
+    #if WEATHER == BME280_0x76
+      #define BME280_ADDRESS_I2C 0x76
+    #else
+      #define BME280_ADDRESS_I2C 0x77
+    #endif
     Adafruit_BME280 bme;
   #elif WEATHER == BME280_SPI
     Adafruit_BME280 bme(BME280_CS_PIN);                                   // hardware SPI
@@ -34,6 +41,9 @@ class weather {
       #else
         if (bme.begin()) _disabled=false;
       #endif
+      #ifdef BME280_I2C
+        if (!_disabled) _disabled=!readCalibration();
+      #endif
   #if defined(ESP32) & defined(WIRE_END_SUPPORT)
       HAL_Wire.end();
   #endif
@@ -47,7 +57,13 @@ class weather {
       if (!_disabled) {
         static int phase=0;
 
-  #if WEATHER == BME280 || WEATHER == BME280_SPI || WEATHER == BME280_0x76
+  #if defined(BME280_I2C)
+        // temperature, pressure, and humidity in one burst read, converted when it arrives
+        if (phase == 10) {
+          byte a=0xF7;
+          i2cBus.queue(BME280_ADDRESS_I2C,&a,1,8,readingDone,this);
+        }
+  #elif WEATHER == BME280_SPI
     #ifdef ESP32
         if ((phase == 10) || (phase == 30) || (phase == 50)) HAL_Wire.begin();
     #endif
@@ -132,6 +148,70 @@ class weather {
     }
 
   private:
+#ifdef BME280_I2C
+    uint16_t dig_T1, dig_P1;
+    int16_t dig_T2, dig_T3, dig_P2, dig_P3, dig_P4, dig_P5, dig_P6, dig_P7, dig_P8, dig_P9, dig_H2, dig_H4, dig_H5;
+    uint8_t dig_H1, dig_H3;
+    int8_t dig_H6;
+
+    bool readCalibration() {
+      byte a=0x88, c[26], h[7];
+      if (i2cBus.transfer(BME280_ADDRESS_I2C,&a,1,c,26) != I2C_OK) return false;
+      a=0xE1;
+      if (i2cBus.transfer(BME280_ADDRESS_I2C,&a,1,h,7) != I2C_OK) return false;
+      dig_T1=c[0]|(c[1]<<8); dig_T2=c[2]|(c[3]<<8); dig_T3=c[4]|(c[5]<<8);
+      dig_P1=c[6]|(c[7]<<8); dig_P2=c[8]|(c[9]<<8); dig_P3=c[10]|(c[11]<<8); dig_P4=c[12]|(c[13]<<8); dig_P5=c[14]|(c[15]<<8);
+      dig_P6=c[16]|(c[17]<<8); dig_P7=c[18]|(c[19]<<8); dig_P8=c[20]|(c[21]<<8); dig_P9=c[22]|(c[23]<<8);
+      dig_H1=c[25]; dig_H2=h[0]|(h[1]<<8); dig_H3=h[2];
+      dig_H4=((int8_t)h[3]<<4)|(h[4]&0x0F); dig_H5=((int8_t)h[5]<<4)|(h[4]>>4); dig_H6=h[6];
+      return true;
+    }
+
+    // compensation from the BME280 datasheet (double precision versions)
+    static void readingDone(byte status, byte *r, byte count, void *context) {
+      (void)count;
+      weather *w=(weather*)context;
+      if (status != I2C_OK) return;
+      long adc_P=((long)r[0]<<12)|((long)r[1]<<4)|(r[2]>>4);
+      long adc_T=((long)r[3]<<12)|((long)r[4]<<4)|(r[5]>>4);
+      long adc_H=((long)r[6]<<8)|r[7];
+      if (adc_T == 0x80000) return;  // measurement skipped
+
+      double v1=(adc_T/16384.0-w->dig_T1/1024.0)*w->dig_T2;
+      double v2=(adc_T/131072.0-w->dig_T1/8192.0); v2=v2*v2*w->dig_T3;
+      double t_fine=v1+v2;
+      w->_t=t_fine/5120.0;
+  #if TELESCOPE_TEMPERATURE != DS1820
+      w->_tt=w->_t;
+  #endif
+
+      if (adc_P != 0x80000) {
+        v1=t_fine/2.0-64000.0;
+        v2=v1*v1*w->dig_P6/32768.0;
+        v2=v2+v1*w->dig_P5*2.0;
+        v2=v2/4.0+w->dig_P4*65536.0;
+        v1=(w->dig_P3*v1*v1/524288.0+w->dig_P2*v1)/524288.0;
+        v1=(1.0+v1/32768.0)*w->dig_P1;
+        if (v1 != 0.0) {
+          double p=1048576.0-adc_P;
+          p=(p-(v2/4096.0))*6250.0/v1;
+          v1=w->dig_P9*p*p/2147483648.0;
+          v2=p*w->dig_P8/32768.0;
+          p=p+(v1+v2+w->dig_P7)/16.0;
+          w->_p=p/100.0;
+        }
+      }
+
+      if (adc_H != 0x8000) {
+        double h=t_fine-76800.0;
+        h=(adc_H-(w->dig_H4*64.0+w->dig_H5/16384.0*h))*(w->dig_H2/65536.0*(1.0+w->dig_H6/67108864.0*h*(1.0+w->dig_H3/67108864.0*h)));
+        h=h*(1.0-w->dig_H1*h/524288.0);
+        if (h > 100.0) h=100.0; else if (h < 0.0) h=0.0;
+        w->_h=h;
+      }
+    }
+#endif
+
     bool _disabled = true;
     double _t = 10.0;
     double _tt = 10.0;